@@ -1,3 +1,13 @@
+-- cullComp.spv isn't checked in, so every shader is compiled before anything that loads them from working is built
+-- CompileShaders.sh does the same thing, for recompiling by hand
+local vulkanSdk = os.getenv("VULKAN_SDK")
+local glslc = vulkanSdk and path.join(vulkanSdk, "bin", "glslc") or "glslc"
+
+local shaderBuildCommands = {}
+for _, shader in ipairs({ { "default.vert", "defaultVert.spv" }, { "default.frag", "defaultFrag.spv" }, { "cull.comp", "cullComp.spv" } }) do
+    table.insert(shaderBuildCommands, "\"" .. glslc .. "\" %[working/Assets/Shaders/GLSL/" .. shader[1] .. "] -o %[working/Assets/Shaders/SPIR-V/" .. shader[2] .. "]")
+end
+
 workspace "VulPEX Workspace"
     filename "VulPEXWorkspace"
     startproject "Test Application"
@@ -100,6 +110,7 @@ project "Test Application"
     {
         "{RMDIR} %[build/%{cfg.platform}/%{cfg.buildcfg}/TestApp/bin]",
     }
+    prebuildcommands(shaderBuildCommands)
 
     postbuildcommands
     {
@@ -145,3 +156,137 @@ project "Test Application"
         kind "WindowedApp"
 
     filter {}
+
+project "Benchmarks"
+    filename "Benchmarks"
+    targetname "Benchmarks"
+    targetdir "build/%{cfg.platform}/%{cfg.buildcfg}/Benchmarks/bin"
+    objdir "build/%{cfg.platform}/%{cfg.buildcfg}/Benchmarks/obj"
+
+    -- Benchmarks load the same assets as the test application, so they're run from the working directory too
+    prebuildcommands
+    {
+        "{RMDIR} %[build/%{cfg.platform}/%{cfg.buildcfg}/Benchmarks/bin]",
+    }
+    prebuildcommands(shaderBuildCommands)
+
+    postbuildcommands
+    {
+        "{MOVE} %[build/%{cfg.platform}/%{cfg.buildcfg}/Benchmarks/bin/Benchmarks] %[working]",
+    }
+
+    includedirs
+    {
+        "lib/glm",
+        "lib/GLFW/include",
+        "lib/EmmaUtils/include",
+        "build/%{cfg.platform}/%{cfg.buildcfg}/VulPEX/include"
+    }
+
+    libdirs
+    {
+        "lib/GLFW",
+        "lib/EmmaUtils",
+        "$VULKAN_SDK/lib"
+    }
+
+    links
+    {
+        "glfw3",
+        "EmmaUtils",
+        "vulkan",
+        "VulPEX"
+    }
+
+    files
+    {
+        "src/Benchmarks/**.cpp",
+    }
+
+    -- Results are logged, so this needs a console in every configuration
+    kind "ConsoleApp"
+
+project "Tests"
+    filename "Tests"
+    targetname "Tests"
+    targetdir "build/%{cfg.platform}/%{cfg.buildcfg}/Tests/bin"
+    objdir "build/%{cfg.platform}/%{cfg.buildcfg}/Tests/obj"
+
+    includedirs
+    {
+        "lib/glm",
+        "lib/GLFW/include",
+        "lib/EmmaUtils/include",
+        "build/%{cfg.platform}/%{cfg.buildcfg}/VulPEX/include"
+    }
+
+    libdirs
+    {
+        "lib/GLFW",
+        "lib/EmmaUtils",
+        "$VULKAN_SDK/lib"
+    }
+
+    links
+    {
+        "glfw3",
+        "EmmaUtils",
+        "vulkan",
+        "VulPEX"
+    }
+
+    files
+    {
+        "src/Tests/**.cpp",
+    }
+
+    -- Exits with 1 if any test fails, so it can gate a build
+    kind "ConsoleApp"
+
+project "Mesh Converter"
+    filename "MeshConverter"
+    targetname "MeshConverter"
+    targetdir "build/%{cfg.platform}/%{cfg.buildcfg}/MeshConverter/bin"
+    objdir "build/%{cfg.platform}/%{cfg.buildcfg}/MeshConverter/obj"
+
+    -- Converts into the working directory's assets, so it's run from there too
+    prebuildcommands
+    {
+        "{RMDIR} %[build/%{cfg.platform}/%{cfg.buildcfg}/MeshConverter/bin]",
+    }
+
+    postbuildcommands
+    {
+        "{MOVE} %[build/%{cfg.platform}/%{cfg.buildcfg}/MeshConverter/bin/MeshConverter] %[working]",
+    }
+
+    includedirs
+    {
+        "lib/glm",
+        "lib/GLFW/include",
+        "lib/EmmaUtils/include",
+        "build/%{cfg.platform}/%{cfg.buildcfg}/VulPEX/include"
+    }
+
+    libdirs
+    {
+        "lib/GLFW",
+        "lib/EmmaUtils",
+        "$VULKAN_SDK/lib"
+    }
+
+    links
+    {
+        "glfw3",
+        "EmmaUtils",
+        "vulkan",
+        "VulPEX"
+    }
+
+    files
+    {
+        "src/MeshConverter/**.cpp",
+    }
+
+    -- A command line tool, so it needs a console in every configuration
+    kind "ConsoleApp"
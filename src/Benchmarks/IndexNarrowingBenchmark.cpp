@@ -0,0 +1,60 @@
+#include "IndexNarrowingBenchmark.hpp"
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <stdexcept>
+
+#include <Modules/MeshProcessing/IndexNarrowing.hpp>
+
+#include <Logger.hpp>
+
+template<typename Function>
+static double TimeMs(Function function)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	function();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Kept out of line so that the compiler narrows one index at a time, like it would without the SIMD path
+[[gnu::noinline]] static void NarrowIndicesScalar(const uint32_t* source, uint16_t* destination, size_t indexCount)
+{
+	for (size_t i = 0; i < indexCount; i++)
+	{
+		destination[i] = (uint16_t)source[i];
+	}
+}
+
+void RunIndexNarrowingBenchmark(uint32_t indexCount, uint32_t iterations)
+{
+	// Looks enough like a real triangle list, and leaves the odd restart index in to make sure it survives
+	std::vector<uint32_t> source(indexCount);
+	for (uint32_t i = 0; i < indexCount; i++)
+	{
+		source[i] = i % 97 == 96 ? 0xFFFFFFFF : (i * 7) % MeshProcessing::c_max16BitVertexCount;
+	}
+
+	std::vector<uint16_t> scalarOutput(indexCount);
+	std::vector<uint16_t> simdOutput(indexCount);
+
+	double scalarTimeMs = TimeMs([&]()
+	{
+		for (uint32_t i = 0; i < iterations; i++) { NarrowIndicesScalar(source.data(), scalarOutput.data(), source.size()); }
+	});
+
+	double simdTimeMs = TimeMs([&]()
+	{
+		for (uint32_t i = 0; i < iterations; i++) { MeshProcessing::NarrowIndices(source.data(), simdOutput.data(), source.size()); }
+	});
+
+	if (scalarOutput != simdOutput)
+	{
+		throw std::runtime_error("SIMD index narrowing doesn't match the scalar version");
+	}
+
+	std::string result = "Narrowing " + std::to_string(indexCount) + " indices " + std::to_string(iterations) + " times: scalar " +
+						 std::to_string(scalarTimeMs) + "ms, SIMD " + std::to_string(simdTimeMs) + "ms (" + std::to_string(scalarTimeMs / simdTimeMs) + "x)";
+
+	Logger::Log({ result.c_str() }, LogType::Info);
+}
\ No newline at end of file
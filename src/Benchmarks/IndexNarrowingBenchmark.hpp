@@ -0,0 +1,6 @@
+#pragma once
+
+#include <cstdint>
+
+// Compares narrowing 32-bit indices to 16-bit one at a time against the SIMD path meshes are uploaded with
+void RunIndexNarrowingBenchmark(uint32_t indexCount, uint32_t iterations);
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "JobSystemBenchmark.hpp"
+
+#include <vector>
+#include <string>
+#include <future>
+#include <chrono>
+#include <cmath>
+#include <atomic>
+#include <algorithm>
+
+#include <Modules/Threading/JobSystem.hpp>
+
+#include <Logger.hpp>
+
+template<typename Function>
+static double TimeMs(Function function)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	function();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void LogComparison(const std::string& benchmarkName, double asyncTimeMs, double jobSystemTimeMs)
+{
+	std::string result = benchmarkName + ": std::async " + std::to_string(asyncTimeMs) + "ms, job system " + std::to_string(jobSystemTimeMs) +
+						 "ms (" + std::to_string(asyncTimeMs / jobSystemTimeMs) + "x)";
+
+	Logger::Log({ result.c_str() }, LogType::Info);
+}
+
+// Just enough work that the compiler can't throw it away
+static float Work(size_t i)
+{
+	return std::sqrt((float)i) * 0.5f;
+}
+
+void RunJobSystemBenchmark(uint32_t taskCount, uint32_t elementCount)
+{
+	Threading::JobSystem jobSystem;
+	jobSystem.CreateJobSystem();
+
+	uint32_t threadCount = jobSystem.GetWorkerCount() + 1;
+
+	// Lots of tiny tasks, where scheduling overhead is everything
+	std::atomic<uint64_t> taskSum = 0;
+
+	double asyncTaskTimeMs = TimeMs([&]()
+	{
+		std::vector<std::future<void>> futures;
+		futures.reserve(taskCount);
+
+		for (uint32_t i = 0; i < taskCount; i++)
+		{
+			futures.push_back(std::async(std::launch::async, [&taskSum, i]() { taskSum += i; }));
+		}
+
+		for (std::future<void>& future : futures)
+		{
+			future.get();
+		}
+	});
+
+	double jobTaskTimeMs = TimeMs([&]()
+	{
+		Threading::JobCounter counter;
+		for (uint32_t i = 0; i < taskCount; i++)
+		{
+			jobSystem.Run([&taskSum, i]() { taskSum += i; }, &counter);
+		}
+
+		jobSystem.Wait(&counter);
+	});
+
+	LogComparison(std::to_string(taskCount) + " tiny tasks", asyncTaskTimeMs, jobTaskTimeMs);
+
+	// One big loop split between every thread, where the split itself matters more than the overhead
+	std::vector<float> output(elementCount);
+
+	double asyncLoopTimeMs = TimeMs([&]()
+	{
+		size_t chunkSize = (output.size() + threadCount - 1) / threadCount;
+
+		std::vector<std::future<void>> futures;
+		for (size_t begin = 0; begin < output.size(); begin += chunkSize)
+		{
+			size_t end = std::min(begin + chunkSize, output.size());
+			futures.push_back(std::async(std::launch::async, [&output, begin, end]()
+			{
+				for (size_t i = begin; i < end; i++) { output[i] = Work(i); }
+			}));
+		}
+
+		for (std::future<void>& future : futures)
+		{
+			future.get();
+		}
+	});
+
+	double jobLoopTimeMs = TimeMs([&]()
+	{
+		jobSystem.ParallelFor(output.size(), 4096, [&output](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++) { output[i] = Work(i); }
+		});
+	});
+
+	LogComparison("Parallel loop over " + std::to_string(elementCount) + " elements, " + std::to_string(threadCount) + " threads",
+				  asyncLoopTimeMs, jobLoopTimeMs);
+
+	jobSystem.DestroyJobSystem();
+}
\ No newline at end of file
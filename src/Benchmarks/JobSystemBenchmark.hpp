@@ -0,0 +1,6 @@
+#pragma once
+
+#include <cstdint>
+
+// Compares the job system against std::async, both for lots of tiny tasks and for splitting one big loop between threads
+void RunJobSystemBenchmark(uint32_t taskCount, uint32_t elementCount);
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "LodBenchmark.hpp"
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+#include <Utility/VulkanDynamicInclude.hpp>
+#include <Utility/VulPEXMaths.hpp>
+#include <Modules/MeshProcessing/MeshSimplifier.hpp>
+
+#include <Logger.hpp>
+
+template<typename Function>
+static double TimeMs(Function function)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	function();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void RunLodBenchmark(uint32_t gridSize, uint32_t objectCount)
+{
+	// A unit UV sphere, with its seam and poles welded so that nothing is locked as a border
+	std::vector<Vec3> positions;
+	for (uint32_t y = 0; y <= gridSize; y++)
+	{
+		for (uint32_t x = 0; x < gridSize; x++)
+		{
+			float longitude = 2 * PI * x / gridSize;
+			float latitude = PI * y / gridSize;
+			positions.push_back(Vec3(std::cos(longitude) * std::sin(latitude), std::sin(longitude) * std::sin(latitude), std::cos(latitude)));
+		}
+	}
+
+	std::vector<uint32_t> indices;
+	for (uint32_t y = 0; y < gridSize; y++)
+	{
+		for (uint32_t x = 0; x < gridSize; x++)
+		{
+			// Every vertex in the top and bottom rows is in the same place, so the first of each stands in for the rest
+			auto getVertex = [gridSize](uint32_t x, uint32_t y) { return y == 0 || y == gridSize ? y * gridSize : y * gridSize + x % gridSize; };
+
+			uint32_t corner = getVertex(x, y);
+			uint32_t right = getVertex(x + 1, y);
+			uint32_t below = getVertex(x, y + 1);
+			uint32_t belowRight = getVertex(x + 1, y + 1);
+
+			// The rows at the poles have collapsed to a point, so their degenerate half of each quad is left out
+			if (y != 0) { indices.insert(indices.end(), { corner, right, below }); }
+			if (y != gridSize - 1) { indices.insert(indices.end(), { right, belowRight, below }); }
+		}
+	}
+
+	std::vector<MeshProcessing::LodLevel> lods;
+	double simplifyTimeMs = TimeMs([&]()
+	{
+		lods = MeshProcessing::GenerateLodChain(indices, positions.data(), sizeof(Vec3), 3, positions.size(), 8);
+	});
+
+	std::string chainMessage = "Generating " + std::to_string(lods.size()) + " LODs took " + std::to_string(simplifyTimeMs) + "ms:";
+	for (const MeshProcessing::LodLevel& lod : lods)
+	{
+		chainMessage += " " + std::to_string(lod.indices.size() / 3) + " (" + std::to_string(lod.error) + ")";
+	}
+	Logger::Log({ chainMessage.c_str() }, LogType::Info);
+
+	// The same selection VulkanApplication makes, for a 1080p viewport with a 60 degree vertical field of view and a 1 pixel threshold
+	float projectionScale = 1080 * 0.5f / std::tan(PI / 6);
+	float maxScreenError = 1;
+
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> distances(2, 500);
+
+	uint64_t fullTriangles = 0;
+	uint64_t selectedTriangles = 0;
+	std::vector<uint32_t> lodObjectCounts(lods.size());
+
+	double selectTimeMs = TimeMs([&]()
+	{
+		for (uint32_t object = 0; object < objectCount; object++)
+		{
+			float distance = distances(random) - 1;
+			float maxError = maxScreenError * distance / projectionScale;
+
+			uint32_t lod = 0;
+			while (lod + 1 < lods.size() && lods[lod + 1].error <= maxError) { lod++; }
+
+			fullTriangles += lods[0].indices.size() / 3;
+			selectedTriangles += lods[lod].indices.size() / 3;
+			lodObjectCounts[lod]++;
+		}
+	});
+
+	std::string selectMessage = "Selecting LODs for " + std::to_string(objectCount) + " spheres took " + std::to_string(selectTimeMs) + "ms: " +
+								std::to_string(fullTriangles) + " -> " + std::to_string(selectedTriangles) + " triangles, objects per LOD:";
+	for (uint32_t count : lodObjectCounts) { selectMessage += " " + std::to_string(count); }
+	Logger::Log({ selectMessage.c_str() }, LogType::Info);
+}
\ No newline at end of file
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <cstdint>
+
+// Builds an LOD chain for a sphere, then logs how many triangles a field of objectCount copies of it costs with and without LOD selection
+void RunLodBenchmark(uint32_t gridSize, uint32_t objectCount);
\ No newline at end of file
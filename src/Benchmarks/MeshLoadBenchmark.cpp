@@ -0,0 +1,128 @@
+#include "MeshLoadBenchmark.hpp"
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+
+#include <Utility/VulkanDynamicInclude.hpp>
+#include <Utility/VulPEXMaths.hpp>
+#include <Modules/MeshProcessing/MeshOptimiser.hpp>
+#include <Modules/MeshProcessing/MeshSimplifier.hpp>
+#include <Modules/Assets/MeshFile.hpp>
+
+#include <Logger.hpp>
+
+template<typename Function>
+static double TimeMs(Function function)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	function();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void LogLoadResult(const std::string& method, double totalTimeMs, uint32_t loadCount, size_t bytesPerLoad)
+{
+	double averageMs = totalTimeMs / loadCount;
+	double gigabytesPerSecond = bytesPerLoad / (averageMs * 1e6);
+
+	std::string result = method + ": " + std::to_string(averageMs) + "ms per load, " + std::to_string(gigabytesPerSecond) + "GB/s";
+	Logger::Log({ result.c_str() }, LogType::Info);
+}
+
+void RunMeshLoadBenchmark(uint32_t gridSize, uint32_t loadCount)
+{
+	// A UV sphere with positions and normals, like a typical lit mesh
+	std::vector<Vec3> vertices;
+	for (uint32_t y = 0; y <= gridSize; y++)
+	{
+		for (uint32_t x = 0; x <= gridSize; x++)
+		{
+			float longitude = 2 * PI * x / gridSize;
+			float latitude = PI * y / gridSize;
+			Vec3 position(std::cos(longitude) * std::sin(latitude), std::sin(longitude) * std::sin(latitude), std::cos(latitude));
+
+			vertices.push_back(position);
+			vertices.push_back(position);
+		}
+	}
+
+	std::vector<uint32_t> indices;
+	for (uint32_t y = 0; y < gridSize; y++)
+	{
+		for (uint32_t x = 0; x < gridSize; x++)
+		{
+			uint32_t corner = y * (gridSize + 1) + x;
+			indices.insert(indices.end(), { corner, corner + 1, corner + gridSize + 1, corner + 1, corner + gridSize + 2, corner + gridSize + 1 });
+		}
+	}
+
+	uint32_t sizeOfVertex = 2 * sizeof(Vec3);
+	uint32_t vertexCount = vertices.size() / 2;
+	std::vector<std::pair<vk::Format, uint32_t>> vertexVarsInfo = { { (vk::Format)VulkanFormat::eVec3, 0 }, { (vk::Format)VulkanFormat::eVec3, sizeof(Vec3) } };
+
+	// What CreateMesh would have to do every time with optimisation and LODs turned on, and what the converter does once instead
+	std::vector<char> vertexData((const char*)vertices.data(), (const char*)(vertices.data() + vertices.size()));
+	std::vector<MeshProcessing::LodLevel> lods;
+
+	double buildTimeMs = TimeMs([&]()
+	{
+		MeshProcessing::OptimiseMesh(vertexData, sizeOfVertex, indices, vertexVarsInfo[0]);
+		vertexCount = vertexData.size() / sizeOfVertex;
+
+		lods = MeshProcessing::GenerateLodChain(indices, vertexData.data(), sizeOfVertex, 3, vertexCount, 4);
+		for (uint32_t i = 1; i < lods.size(); i++) { MeshProcessing::OptimiseVertexCache(lods[i].indices, vertexCount); }
+	});
+
+	const std::string path = "MeshLoadBenchmark.vpxm";
+	Assets::WriteMeshFile(path, vertexData.data(), sizeOfVertex, vertexCount, vertexVarsInfo, lods);
+
+	// Stands in for the staging ring, which is allocated long before any load
+	Assets::MeshFile meshFile;
+	meshFile.OpenMeshFile(path);
+	size_t bytesPerLoad = meshFile.GetVertexDataSize() + meshFile.GetIndexDataSize();
+	meshFile.CloseMeshFile();
+
+	std::vector<char> staging(bytesPerLoad);
+
+	std::string meshMessage = "Loading a " + std::to_string(indices.size() / 3) + " triangle sphere with " + std::to_string(lods.size()) + " LODs, " +
+							  std::to_string(bytesPerLoad) + " bytes of vertices and indices. Building it from scratch took " + std::to_string(buildTimeMs) + "ms";
+	Logger::Log({ meshMessage.c_str() }, LogType::Info);
+
+	// Both methods read from the page cache, since the file was only just written. That's the best case for reading into a buffer,
+	// which still has to allocate and copy the whole file once more than mapping does
+	double mappedTimeMs = TimeMs([&]()
+	{
+		for (uint32_t i = 0; i < loadCount; i++)
+		{
+			meshFile.OpenMeshFile(path);
+			std::memcpy(staging.data(), meshFile.GetVertexData(), meshFile.GetVertexDataSize());
+			std::memcpy(staging.data() + meshFile.GetVertexDataSize(), meshFile.GetIndexData(), meshFile.GetIndexDataSize());
+			meshFile.CloseMeshFile();
+		}
+	});
+
+	double readTimeMs = TimeMs([&]()
+	{
+		for (uint32_t i = 0; i < loadCount; i++)
+		{
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			std::vector<char> fileData(file.tellg());
+			file.seekg(0);
+			file.read(fileData.data(), fileData.size());
+
+			const Assets::MeshFileHeader* header = (const Assets::MeshFileHeader*)fileData.data();
+			size_t vertexDataSize = (size_t)header->vertexCount * header->sizeOfVertex;
+			std::memcpy(staging.data(), fileData.data() + header->vertexDataOffset, vertexDataSize);
+			std::memcpy(staging.data() + vertexDataSize, fileData.data() + header->indexDataOffset, bytesPerLoad - vertexDataSize);
+		}
+	});
+
+	LogLoadResult("Mapped", mappedTimeMs, loadCount, bytesPerLoad);
+	LogLoadResult("Read into a buffer", readTimeMs, loadCount, bytesPerLoad);
+
+	std::remove(path.c_str());
+}
\ No newline at end of file
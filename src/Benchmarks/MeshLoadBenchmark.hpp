@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstdint>
+
+// Writes a sphere with its LODs out as a mesh file, then logs how long it takes to get its vertices and indices into memory that
+// stands in for staging, by mapping the file, by reading it into a buffer first, and by building the mesh from scratch
+void RunMeshLoadBenchmark(uint32_t gridSize, uint32_t loadCount);
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "MeshOptimisationBenchmark.hpp"
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <algorithm>
+
+#include <Utility/VulkanDynamicInclude.hpp>
+#include <Utility/VulPEXMaths.hpp>
+#include <Modules/MeshProcessing/MeshOptimiser.hpp>
+
+#include <Logger.hpp>
+
+template<typename Function>
+static double TimeMs(Function function)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	function();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void RunMeshOptimisationBenchmark(uint32_t gridSize)
+{
+	// A UV sphere, which is what a naive exporter hands over: every triangle with its own three vertices, in no particular order
+	std::vector<Vec3> gridPositions;
+	for (uint32_t y = 0; y <= gridSize; y++)
+	{
+		for (uint32_t x = 0; x <= gridSize; x++)
+		{
+			float longitude = 2 * PI * x / gridSize;
+			float latitude = PI * y / gridSize;
+			gridPositions.push_back(Vec3(std::cos(longitude) * std::sin(latitude), std::sin(longitude) * std::sin(latitude), std::cos(latitude)));
+		}
+	}
+
+	std::vector<uint32_t> gridIndices;
+	for (uint32_t y = 0; y < gridSize; y++)
+	{
+		for (uint32_t x = 0; x < gridSize; x++)
+		{
+			uint32_t corner = y * (gridSize + 1) + x;
+			gridIndices.insert(gridIndices.end(), { corner, corner + 1, corner + gridSize + 1, corner + 1, corner + gridSize + 2, corner + gridSize + 1 });
+		}
+	}
+
+	std::vector<uint32_t> triangleOrder(gridIndices.size() / 3);
+	for (uint32_t i = 0; i < triangleOrder.size(); i++) { triangleOrder[i] = i; }
+	std::shuffle(triangleOrder.begin(), triangleOrder.end(), std::mt19937(1));
+
+	std::vector<Vec3> positions;
+	std::vector<uint32_t> indices;
+	for (uint32_t triangle : triangleOrder)
+	{
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			indices.push_back(positions.size());
+			positions.push_back(gridPositions[gridIndices[triangle * 3 + i]]);
+		}
+	}
+
+	std::vector<char> vertexData((const char*)positions.data(), (const char*)(positions.data() + positions.size()));
+
+	MeshProcessing::MeshOptimisationStats stats;
+	double optimiseTimeMs = TimeMs([&]()
+	{
+		stats = MeshProcessing::OptimiseMesh(vertexData, sizeof(Vec3), indices, std::make_pair((vk::Format)VulkanFormat::eVec3, 0u));
+	});
+
+	std::string result = "Optimising a " + std::to_string(indices.size() / 3) + " triangle sphere took " + std::to_string(optimiseTimeMs) + "ms: " +
+						 std::to_string(stats.vertexCountBefore) + " -> " + std::to_string(stats.vertexCountAfter) + " vertices, ACMR " +
+						 std::to_string(stats.before.acmr) + " -> " + std::to_string(stats.after.acmr) + ", ATVR " + std::to_string(stats.before.atvr) +
+						 " -> " + std::to_string(stats.after.atvr);
+
+	Logger::Log({ result.c_str() }, LogType::Info);
+}
\ No newline at end of file
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <cstdint>
+
+// Optimises a shuffled, unindexed sphere, and logs how long it took and what it did to the vertex count, ACMR and ATVR
+void RunMeshOptimisationBenchmark(uint32_t gridSize);
\ No newline at end of file
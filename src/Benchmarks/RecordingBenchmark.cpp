@@ -0,0 +1,123 @@
+#include "RecordingBenchmark.hpp"
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+
+#include <VulkanApplication.hpp>
+#include <Modules/DataStructures/DefaultVertex.hpp>
+
+#include <Logger.hpp>
+#include <FileHandling.hpp>
+
+static void RenderFrames(VulkanApplication& vkApp, uint32_t frameCount, double& totalRecordTimeMs)
+{
+	for (uint32_t i = 0; i < frameCount && vkApp.IsRunning(); i++)
+	{
+		vkApp.RenderFrame();
+		totalRecordTimeMs += vkApp.GetFrameStats().recordTimeMs;
+
+		glfwPollEvents();
+	}
+}
+
+// Builds a fresh application for every thread count, since the job system's size can only be set before Init
+// Half of the draws are geometry and half are indirect objects, so that both kinds of draw get split across the workers
+static double MeasureRecordTime(uint32_t drawCount, uint32_t framesPerRun, uint32_t threadCount)
+{
+	std::map<int, int> windowHints = {{GLFW_RESIZABLE, GLFW_FALSE}};
+	VulkanApplication vkApp(windowHints);
+
+	WindowInfo winInfo
+	{
+		nullptr,						//targetMonitor
+		"VulPEX Recording Benchmark",	//title
+		800,							//width
+		600								//height
+	};
+
+	vk::ApplicationInfo appInfo(
+		"Recording Benchmark",		//pApplicationName
+		VK_MAKE_VERSION(0, 0, 1),	//applicationVersion
+		nullptr,					//pEngineName
+		0,							//engineVersion
+		VK_API_VERSION_1_3			//apiVersion
+	);
+
+	ShaderInfo shaderInfo
+	{
+		FileHandling::LoadFileToByteArray("Assets/Shaders/SPIR-V/defaultVert.spv"),	//vertBytecode
+		FileHandling::LoadFileToByteArray("Assets/Shaders/SPIR-V/defaultFrag.spv")	//fragBytecode
+	};
+
+	// The thread calling RenderFrame records slices too, so it counts as one of the threads
+	vkApp.ConfigureJobSystem(threadCount - 1);
+	vkApp.ConfigureIndirectDrawing(3 * drawCount, 3 * drawCount, drawCount);
+	vkApp.Init(winInfo, appInfo, {}, {});
+
+	std::array vertexInfo = DataStructures::Vertex::GetVarInfo();
+	vkApp.GraphicsPipelineSetup(shaderInfo, DataStructures::Vertex::GetSizeOf(), vertexInfo.data(), vertexInfo.size());
+
+	// Lots of tiny triangles in a grid, each its own draw, so that recording cost dominates everything else
+	uint32_t gridWidth = (uint32_t)std::ceil(std::sqrt((float)drawCount));
+	float cellSize = 2.0f / gridWidth;
+
+	std::vector<uint32_t> indices = { 0, 1, 2 };
+	for (uint32_t i = 0; i < drawCount; i++)
+	{
+		float x = -1.0f + (i % gridWidth) * cellSize;
+		float y = -1.0f + (i / gridWidth) * cellSize;
+
+		std::vector<DataStructures::Vertex> verts = {
+			{{ x, y }, {1.0f, 0.0f, 0.0f}},
+			{{ x + cellSize, y }, {0.0f, 1.0f, 0.0f}},
+			{{ x, y + cellSize }, {0.0f, 0.0f, 1.0f}}
+		};
+
+		if (i % 2 == 0)
+		{
+			vkApp.CreateGeometry(verts, indices);
+		}
+		else
+		{
+			vkApp.CreateObject(vkApp.CreateMesh(verts, indices));
+		}
+	}
+
+	// Let every thread have a slice, however small, so that the scaling is down to the thread count alone
+	vkApp.ConfigureParallelRecording(threadCount, 1);
+
+	// Warm up, so that uploads and first-use costs stay out of the results
+	double ignoredRecordTimeMs = 0;
+	RenderFrames(vkApp, 10, ignoredRecordTimeMs);
+
+	double totalRecordTimeMs = 0;
+	RenderFrames(vkApp, framesPerRun, totalRecordTimeMs);
+
+	vkApp.SynchroniseBeforeQuit();
+
+	return totalRecordTimeMs / framesPerRun;
+}
+
+void RunRecordingBenchmark(uint32_t drawCount, uint32_t framesPerRun)
+{
+	uint32_t maxThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	double serialRecordTimeMs = 0;
+
+	for (uint32_t threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2)
+	{
+		double averageRecordTimeMs = MeasureRecordTime(drawCount, framesPerRun, threadCount);
+		if (threadCount == 1) { serialRecordTimeMs = averageRecordTimeMs; }
+
+		double speedup = serialRecordTimeMs / averageRecordTimeMs;
+
+		// Efficiency is how much of each extra thread actually went into recording, 100% being perfect scaling
+		std::string result = std::to_string(drawCount) + " draws, " + std::to_string(threadCount) + " threads (" +
+							 std::to_string(threadCount - 1) + " job workers): " + std::to_string(averageRecordTimeMs) + "ms average recording time, " +
+							 std::to_string(speedup) + "x speedup, " + std::to_string(100 * speedup / threadCount) + "% per-thread efficiency";
+
+		Logger::Log({ result.c_str() }, LogType::Info);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstdint>
+
+// Records drawCount draws every frame with the job system sized for 1, 2, 4... threads, up to the number of hardware threads
+// Logs the average recording time for each, along with its speedup and per-thread efficiency over a single thread
+void RunRecordingBenchmark(uint32_t drawCount, uint32_t framesPerRun);
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "VertexEncodingBenchmark.hpp"
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#include <Modules/DataStructures/DefaultVertex.hpp>
+#include <Modules/MeshProcessing/VertexEncoding.hpp>
+
+#include <Logger.hpp>
+
+template<typename Function>
+static double TimeMs(Function function)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	function();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void RunVertexEncodingBenchmark(uint32_t vertexCount, uint32_t iterations)
+{
+	std::vector<DataStructures::Vertex> verts;
+	verts.reserve(vertexCount);
+
+	for (uint32_t i = 0; i < vertexCount; i++)
+	{
+		float t = (float)i / vertexCount;
+		verts.push_back(DataStructures::Vertex({ t * 2 - 1, 1 - t * 2 }, { t, 1 - t, 0.5f }));
+	}
+
+	std::vector<DataStructures::PackedVertex> perVertexOutput(vertexCount);
+	std::vector<DataStructures::PackedVertex> streamOutput;
+
+	double perVertexTimeMs = TimeMs([&]()
+	{
+		for (uint32_t i = 0; i < iterations; i++)
+		{
+			for (uint32_t vertex = 0; vertex < vertexCount; vertex++)
+			{
+				perVertexOutput[vertex] = DataStructures::PackedVertex(verts[vertex].pos, verts[vertex].colour);
+			}
+		}
+	});
+
+	double streamTimeMs = TimeMs([&]()
+	{
+		for (uint32_t i = 0; i < iterations; i++)
+		{
+			streamOutput = MeshProcessing::EncodeVertices<DataStructures::PackedVertex>(verts);
+		}
+	});
+
+	if (std::memcmp(perVertexOutput.data(), streamOutput.data(), sizeof(DataStructures::PackedVertex) * vertexCount) != 0)
+	{
+		throw std::runtime_error("Encoding the vertex stream doesn't match encoding each vertex on its own");
+	}
+
+	std::string result = "Encoding " + std::to_string(vertexCount) + " vertices " + std::to_string(iterations) + " times: per vertex " +
+						 std::to_string(perVertexTimeMs) + "ms, whole stream " + std::to_string(streamTimeMs) + "ms (" +
+						 std::to_string(perVertexTimeMs / streamTimeMs) + "x). " + std::to_string(sizeof(DataStructures::Vertex) * vertexCount) +
+						 " bytes down to " + std::to_string(sizeof(DataStructures::PackedVertex) * vertexCount);
+
+	Logger::Log({ result.c_str() }, LogType::Info);
+}
\ No newline at end of file
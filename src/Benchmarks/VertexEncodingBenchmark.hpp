@@ -0,0 +1,6 @@
+#pragma once
+
+#include <cstdint>
+
+// Compares packing float vertices one at a time against encoding the whole stream at once, and logs how much smaller it gets
+void RunVertexEncodingBenchmark(uint32_t vertexCount, uint32_t iterations);
\ No newline at end of file
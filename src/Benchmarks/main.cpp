@@ -0,0 +1,68 @@
+#include <stdexcept>
+#include <string>
+
+#include <Logger.hpp>
+
+#include "RecordingBenchmark.hpp"
+#include "JobSystemBenchmark.hpp"
+#include "IndexNarrowingBenchmark.hpp"
+#include "VertexEncodingBenchmark.hpp"
+#include "MeshOptimisationBenchmark.hpp"
+#include "LodBenchmark.hpp"
+#include "MeshLoadBenchmark.hpp"
+
+// Runs every benchmark, or just the one named by the first argument
+int main(int argc, char** argv)
+{
+	std::string selectedBenchmark = argc > 1 ? argv[1] : "all";
+
+	try
+	{
+		if (selectedBenchmark == "all" || selectedBenchmark == "recording")
+		{
+			RunRecordingBenchmark(10000, 200);
+		}
+
+		if (selectedBenchmark == "all" || selectedBenchmark == "jobs")
+		{
+			RunJobSystemBenchmark(10000, 16 * 1024 * 1024);
+		}
+
+		if (selectedBenchmark == "all" || selectedBenchmark == "indices")
+		{
+			RunIndexNarrowingBenchmark(3 * 1024 * 1024, 100);
+		}
+
+		if (selectedBenchmark == "all" || selectedBenchmark == "encoding")
+		{
+			RunVertexEncodingBenchmark(1024 * 1024, 20);
+		}
+
+		if (selectedBenchmark == "all" || selectedBenchmark == "meshopt")
+		{
+			RunMeshOptimisationBenchmark(512);
+		}
+
+		if (selectedBenchmark == "all" || selectedBenchmark == "lod")
+		{
+			RunLodBenchmark(256, 10000);
+		}
+
+		if (selectedBenchmark == "all" || selectedBenchmark == "meshload")
+		{
+			RunMeshLoadBenchmark(512, 50);
+		}
+
+		return 0;
+	}
+	catch (const std::exception& ex)
+	{
+		Logger::Log( { "Benchmark encountered an exception: ", ex.what() }, LogType::Fatal );
+		return 1;
+	}
+	catch(...)
+	{
+		Logger::Log( { "Benchmark encountered an unknown error." }, LogType::Fatal );
+		return 1;
+	}
+}
\ No newline at end of file
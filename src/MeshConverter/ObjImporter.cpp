@@ -0,0 +1,217 @@
+#include "ObjImporter.hpp"
+
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <Utility/VulPEXMaths.hpp>
+#include <Modules/MeshProcessing/VertexEncoding.hpp>
+
+// One corner of a face, as indices into each attribute list. -1 means the corner didn't have that attribute
+struct ObjCorner
+{
+	int64_t position = -1;
+	int64_t texCoord = -1;
+	int64_t normal = -1;
+};
+
+// OBJ indices start at 1, and negative ones count back from the most recent attribute
+static int64_t ResolveObjIndex(long index, size_t attributeCount, const std::string& path, uint32_t lineNumber)
+{
+	int64_t resolved = index > 0 ? index - 1 : (int64_t)attributeCount + index;
+	if (index == 0 || resolved < 0 || resolved >= (int64_t)attributeCount)
+	{
+		throw std::runtime_error(path + ":" + std::to_string(lineNumber) + " refers to attribute " + std::to_string(index) + ", but there are only " +
+								 std::to_string(attributeCount));
+	}
+
+	return resolved;
+}
+
+ImportedMesh ImportObj(const std::string& path)
+{
+	std::ifstream file(path);
+	if (!file.is_open())
+	{
+		throw std::runtime_error("Failed to open " + path);
+	}
+
+	std::vector<Vec3> positions;
+	std::vector<Vec3> normals;
+	std::vector<Vec2> texCoords;
+	std::vector<ObjCorner> corners;
+
+	bool hasNormals = false;
+	bool hasTexCoords = false;
+
+	std::string line;
+	uint32_t lineNumber = 0;
+	std::vector<ObjCorner> faceCorners;
+
+	while (std::getline(file, line))
+	{
+		lineNumber++;
+
+		const char* cursor = line.c_str();
+		char* end = nullptr;
+
+		if (std::strncmp(cursor, "v ", 2) == 0 || std::strncmp(cursor, "vn ", 3) == 0)
+		{
+			bool isNormal = cursor[1] == 'n';
+			cursor += isNormal ? 3 : 2;
+
+			Vec3 value(0);
+			for (uint32_t i = 0; i < 3; i++)
+			{
+				value[i] = std::strtof(cursor, &end);
+				cursor = end;
+			}
+
+			(isNormal ? normals : positions).push_back(value);
+		}
+		else if (std::strncmp(cursor, "vt ", 3) == 0)
+		{
+			cursor += 3;
+
+			Vec2 value(0);
+			for (uint32_t i = 0; i < 2; i++)
+			{
+				value[i] = std::strtof(cursor, &end);
+				cursor = end;
+			}
+
+			texCoords.push_back(value);
+		}
+		else if (std::strncmp(cursor, "f ", 2) == 0)
+		{
+			cursor += 2;
+			faceCorners.clear();
+
+			// Each corner is v, v/vt, v//vn or v/vt/vn
+			while (true)
+			{
+				long positionIndex = std::strtol(cursor, &end, 10);
+				if (end == cursor) { break; }
+				cursor = end;
+
+				ObjCorner corner;
+				corner.position = ResolveObjIndex(positionIndex, positions.size(), path, lineNumber);
+
+				if (*cursor == '/')
+				{
+					cursor++;
+					if (*cursor != '/')
+					{
+						corner.texCoord = ResolveObjIndex(std::strtol(cursor, &end, 10), texCoords.size(), path, lineNumber);
+						cursor = end;
+						hasTexCoords = true;
+					}
+
+					if (*cursor == '/')
+					{
+						cursor++;
+						corner.normal = ResolveObjIndex(std::strtol(cursor, &end, 10), normals.size(), path, lineNumber);
+						cursor = end;
+						hasNormals = true;
+					}
+				}
+
+				faceCorners.push_back(corner);
+			}
+
+			for (uint32_t i = 1; i + 1 < faceCorners.size(); i++)
+			{
+				corners.insert(corners.end(), { faceCorners[0], faceCorners[i], faceCorners[i + 1] });
+			}
+		}
+	}
+
+	ImportedMesh mesh;
+	mesh.vertexVarsInfo.push_back({ (vk::Format)VulkanFormat::eVec3, 0 });
+	mesh.sizeOfVertex = sizeof(Vec3);
+
+	uint32_t normalOffset = mesh.sizeOfVertex;
+	if (hasNormals)
+	{
+		mesh.vertexVarsInfo.push_back({ (vk::Format)VulkanFormat::eVec3, normalOffset });
+		mesh.sizeOfVertex += sizeof(Vec3);
+	}
+
+	uint32_t texCoordOffset = mesh.sizeOfVertex;
+	if (hasTexCoords)
+	{
+		mesh.vertexVarsInfo.push_back({ (vk::Format)VulkanFormat::eVec2, texCoordOffset });
+		mesh.sizeOfVertex += sizeof(Vec2);
+	}
+
+	// Keyed on all three attribute indices, which is enough to tell corners apart without comparing any floats
+	std::unordered_map<std::string, uint32_t> cornerVertices;
+	mesh.indices.reserve(corners.size());
+
+	for (const ObjCorner& corner : corners)
+	{
+		std::string key((const char*)&corner, sizeof(ObjCorner));
+		std::pair<std::unordered_map<std::string, uint32_t>::iterator, bool> inserted = cornerVertices.emplace(key, mesh.vertexCount);
+
+		if (inserted.second)
+		{
+			// Attributes the corner didn't have are left as zero
+			mesh.vertexData.resize(mesh.vertexData.size() + mesh.sizeOfVertex, 0);
+			char* vertex = mesh.vertexData.data() + (size_t)mesh.vertexCount * mesh.sizeOfVertex;
+
+			std::memcpy(vertex, &positions[corner.position], sizeof(Vec3));
+			if (hasNormals && corner.normal >= 0) { std::memcpy(vertex + normalOffset, &normals[corner.normal], sizeof(Vec3)); }
+			if (hasTexCoords && corner.texCoord >= 0) { std::memcpy(vertex + texCoordOffset, &texCoords[corner.texCoord], sizeof(Vec2)); }
+
+			mesh.vertexCount++;
+		}
+
+		mesh.indices.push_back(inserted.first->second);
+	}
+
+	if (mesh.indices.empty())
+	{
+		throw std::runtime_error(path + " has no faces");
+	}
+
+	return mesh;
+}
+
+void EncodeImportedMesh(ImportedMesh& mesh, MeshLayout layout)
+{
+	if (layout == MeshLayout::eFloat) { return; }
+
+	std::vector<std::pair<vk::Format, uint32_t>> encodedVarsInfo;
+	uint32_t sizeOfEncodedVertex = 0;
+
+	// Attributes come in the order ImportObj adds them, so position is first, and a normal is the only other eVec3
+	for (uint32_t i = 0; i < mesh.vertexVarsInfo.size(); i++)
+	{
+		VulkanFormat format = VulkanFormat::eHalf2;
+		uint32_t size = sizeof(uint16_t) * 2;
+
+		if (i == 0)
+		{
+			format = layout == MeshLayout::ePacked ? VulkanFormat::eHalf4 : VulkanFormat::eVec3;
+			size = layout == MeshLayout::ePacked ? sizeof(uint16_t) * 4 : sizeof(Vec3);
+		}
+		else if (mesh.vertexVarsInfo[i].first == (vk::Format)VulkanFormat::eVec3)
+		{
+			format = VulkanFormat::eA2B10G10R10Snorm;
+			size = sizeof(uint32_t);
+		}
+
+		encodedVarsInfo.push_back({ (vk::Format)format, sizeOfEncodedVertex });
+		sizeOfEncodedVertex += size;
+	}
+
+	std::vector<char> encodedData((size_t)sizeOfEncodedVertex * mesh.vertexCount);
+	MeshProcessing::EncodeVertices(mesh.vertexData.data(), mesh.sizeOfVertex, mesh.vertexVarsInfo.data(), encodedData.data(), sizeOfEncodedVertex,
+								   encodedVarsInfo.data(), encodedVarsInfo.size(), mesh.vertexCount);
+
+	mesh.vertexData = std::move(encodedData);
+	mesh.sizeOfVertex = sizeOfEncodedVertex;
+	mesh.vertexVarsInfo = std::move(encodedVarsInfo);
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+#include <Utility/VulkanDynamicInclude.hpp>
+
+// Interleaved vertices in whatever layout the file had attributes for: an eVec3 position, then an eVec3 normal and an eVec2
+// texture coordinate if any face used them
+struct ImportedMesh
+{
+	std::vector<char> vertexData;
+	uint32_t sizeOfVertex = 0;
+	uint32_t vertexCount = 0;
+	std::vector<std::pair<vk::Format, uint32_t>> vertexVarsInfo;
+
+	std::vector<uint32_t> indices;
+};
+
+// The vertex layouts a mesh can be written out in. eFloat is exactly what ImportObj produces
+// eCompact keeps eVec3 positions, but stores normals as eA2B10G10R10Snorm and texture coordinates as eHalf2, for 20 bytes a vertex instead of 32
+// ePacked stores positions as eHalf4 as well, for 16 bytes, which is only exact enough for meshes within a few hundred units of the origin
+enum class MeshLayout
+{
+	eFloat,
+	eCompact,
+	ePacked
+};
+
+// Reads the positions, normals, texture coordinates and faces of a Wavefront OBJ, and ignores everything else
+// Faces with more than three corners are split into a fan. Corners that use the same attributes share a vertex
+// Throws if the file can't be read, or a face refers to an attribute that doesn't exist
+ImportedMesh ImportObj(const std::string& path);
+
+// Re-encodes the mesh's vertices into layout with MeshProcessing::EncodeVertices
+// Optimising and simplifying need float positions, so this is the last thing to do before the mesh is written out
+void EncodeImportedMesh(ImportedMesh& mesh, MeshLayout layout);
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Logger.hpp>
+
+#include <Modules/MeshProcessing/MeshOptimiser.hpp>
+#include <Modules/MeshProcessing/MeshSimplifier.hpp>
+#include <Modules/Assets/MeshFile.hpp>
+
+#include "ObjImporter.hpp"
+
+static void LogUsage()
+{
+	Logger::Log({ "Usage: MeshConverter <input.obj> <output.vpxm> [--lods <count>] [--reduction <fraction>] [--no-optimise] [--layout <float|compact|packed>]" }, LogType::Info);
+}
+
+// Does everything VulkanApplication would otherwise do to a mesh every time it's created, once, ahead of time
+// Optimises the mesh for the vertex cache, overdraw and vertex fetch, builds its LOD chain, and writes it out as a mesh file
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		LogUsage();
+		return 1;
+	}
+
+	std::string inputPath = argv[1];
+	std::string outputPath = argv[2];
+
+	uint32_t lodCount = 4;
+	float reduction = 0.5f;
+	bool optimise = true;
+	MeshLayout layout = MeshLayout::eFloat;
+
+	try
+	{
+		for (int i = 3; i < argc; i++)
+		{
+			std::string option = argv[i];
+
+			if (option == "--lods" && i + 1 < argc)
+			{
+				lodCount = std::stoul(argv[++i]);
+			}
+			else if (option == "--reduction" && i + 1 < argc)
+			{
+				reduction = std::stof(argv[++i]);
+			}
+			else if (option == "--no-optimise")
+			{
+				optimise = false;
+			}
+			else if (option == "--layout" && i + 1 < argc)
+			{
+				std::string layoutName = argv[++i];
+				if (layoutName == "float") { layout = MeshLayout::eFloat; }
+				else if (layoutName == "compact") { layout = MeshLayout::eCompact; }
+				else if (layoutName == "packed") { layout = MeshLayout::ePacked; }
+				else { throw std::runtime_error("Unknown layout " + layoutName + ", it has to be float, compact or packed"); }
+			}
+			else
+			{
+				LogUsage();
+				return 1;
+			}
+		}
+
+		if (lodCount < 1 || lodCount > Assets::c_maxMeshFileLods || reduction <= 0 || reduction >= 1)
+		{
+			throw std::runtime_error("Needs between 1 and " + std::to_string(Assets::c_maxMeshFileLods) + " LODs, and a reduction between 0 and 1");
+		}
+
+		ImportedMesh mesh = ImportObj(inputPath);
+
+		std::string importMessage = "Imported " + inputPath + ": " + std::to_string(mesh.vertexCount) + " vertices, " +
+									std::to_string(mesh.indices.size() / 3) + " triangles, " + std::to_string(mesh.sizeOfVertex) + " bytes per vertex";
+		Logger::Log({ importMessage.c_str() }, LogType::Info);
+
+		// Position always comes first, see ImportObj
+		if (optimise)
+		{
+			MeshProcessing::MeshOptimisationStats stats = MeshProcessing::OptimiseMesh(mesh.vertexData, mesh.sizeOfVertex, mesh.indices, mesh.vertexVarsInfo[0]);
+			mesh.vertexCount = mesh.vertexData.size() / mesh.sizeOfVertex;
+
+			std::string statsMessage = "Optimised: " + std::to_string(stats.vertexCountBefore) + " -> " + std::to_string(stats.vertexCountAfter) +
+									   " vertices, ACMR " + std::to_string(stats.before.acmr) + " -> " + std::to_string(stats.after.acmr) + ", ATVR " +
+									   std::to_string(stats.before.atvr) + " -> " + std::to_string(stats.after.atvr);
+			Logger::Log({ statsMessage.c_str() }, LogType::Info);
+		}
+
+		std::vector<MeshProcessing::LodLevel> lods = MeshProcessing::GenerateLodChain(mesh.indices, mesh.vertexData.data(), mesh.sizeOfVertex, 3,
+																					  mesh.vertexCount, lodCount, reduction);
+
+		std::string lodMessage = "LODs:";
+		for (uint32_t i = 0; i < lods.size(); i++)
+		{
+			if (optimise && i > 0) { MeshProcessing::OptimiseVertexCache(lods[i].indices, mesh.vertexCount); }
+
+			lodMessage += " " + std::to_string(lods[i].indices.size() / 3) + " (" + std::to_string(lods[i].error) + ")";
+		}
+		Logger::Log({ lodMessage.c_str() }, LogType::Info);
+
+		if (layout != MeshLayout::eFloat)
+		{
+			EncodeImportedMesh(mesh, layout);
+
+			std::string layoutMessage = "Encoded to " + std::to_string(mesh.sizeOfVertex) + " bytes per vertex";
+			Logger::Log({ layoutMessage.c_str() }, LogType::Info);
+		}
+
+		Assets::WriteMeshFile(outputPath, mesh.vertexData.data(), mesh.sizeOfVertex, mesh.vertexCount, mesh.vertexVarsInfo, lods);
+		Logger::Log({ "Wrote ", outputPath.c_str() }, LogType::Info);
+
+		return 0;
+	}
+	catch (const std::exception& ex)
+	{
+		Logger::Log( { "Mesh conversion encountered an exception: ", ex.what() }, LogType::Fatal );
+		return 1;
+	}
+}
\ No newline at end of file
@@ -94,15 +94,39 @@ int entryPoint()
 		2, 3, 0 
 	};
 
+	vkApp.ConfigureExtendedDynamicState(true);
+
     vkApp.Init(winInfo, appInfo, extensions, {});
 
-	std::array vertexInfo = DataStructures::Vertex::GetVarInfo();
-	vkApp.GraphicsPipelineSetup(shaderInfo, DataStructures::Vertex::GetSizeOf(), vertexInfo.data(), vertexInfo.size(), verts, indices);
+	vkApp.ConfigureDynamicRendering(true);
+
+	// Less than half the size of the float vertices, and the shaders can't tell the difference
+	std::vector<DataStructures::PackedVertex> packedVerts = MeshProcessing::EncodeVertices<DataStructures::PackedVertex>(verts);
+
+	std::array vertexInfo = DataStructures::PackedVertex::GetVarInfo();
+	vkApp.GraphicsPipelineSetup(shaderInfo, DataStructures::PackedVertex::GetSizeOf(), vertexInfo.data(), vertexInfo.size());
+
+	// TODO: When the player passes vertices here, ensure thet they're of the same type as DataStrcutures::Vertex
+	GeometryHandle quad = vkApp.CreateGeometry(packedVerts, indices);
+
+	// Nothing is added or removed after this point, so there's no need to record commands every frame
+	vkApp.ConfigureCommandBufferCaching(true);
+
+	// The quad never changes, so everything after the first frame should upload nothing
+	vk::DeviceSize totalBytesUploaded = 0;
+	uint64_t totalCommandBuffersRecorded = 0;
+
+	double totalFrameTimeMs = 0;
+	uint64_t frameCount = 0;
 
     while (vkApp.IsRunning())
     {
-		// TODO: When the player passes vertices here, ensure thet they're of the same type as DataStrcutures::Vertex
-    	vkApp.RenderFrame(DataStructures::Vertex::GetSizeOf(), verts, indices);
+    	vkApp.RenderFrame();
+		totalBytesUploaded += vkApp.GetFrameStats().bytesUploaded;
+		totalCommandBuffersRecorded += vkApp.GetFrameStats().commandBuffersRecorded;
+
+		totalFrameTimeMs += vkApp.GetFrameStats().cpuFrameTimeMs;
+		frameCount++;
 		
     	// Events (input, etc.)
     	glfwPollEvents();
@@ -111,6 +135,16 @@ int entryPoint()
 	// Would be nice to have this happen automatically somehow...
 	vkApp.SynchroniseBeforeQuit();
 
+	vkApp.LogMemoryStats();
+	vkApp.LogPipelineStats();
+	Logger::Log({ "Total bytes uploaded: ", std::to_string(totalBytesUploaded).c_str() }, LogType::Info);
+	Logger::Log({ "Command buffers recorded: ", std::to_string(totalCommandBuffersRecorded).c_str(), " over ", std::to_string(frameCount).c_str(), " frames" }, LogType::Info);
+
+	if (frameCount > 0)
+	{
+		Logger::Log({ "Average CPU frame time (ms): ", std::to_string(totalFrameTimeMs / frameCount).c_str() }, LogType::Info);
+	}
+
 	return 0;
 }
 
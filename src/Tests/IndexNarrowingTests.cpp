@@ -0,0 +1,35 @@
+#include "IndexNarrowingTests.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+
+#include <Modules/MeshProcessing/IndexNarrowing.hpp>
+
+#include "TestCheck.hpp"
+
+static bool IndicesRejected(const std::vector<uint32_t>& indices, uint32_t vertexCount)
+{
+	try
+	{
+		MeshProcessing::ValidateIndices(indices.data(), indices.size(), vertexCount);
+	}
+	catch (const std::runtime_error&)
+	{
+		return true;
+	}
+
+	return false;
+}
+
+void RunIndexValidationTests()
+{
+	TEST_CHECK(!IndicesRejected({ 0, 1, 2, 2, 3, 0 }, 4));
+	TEST_CHECK(IndicesRejected({ 0, 1, 4 }, 4));
+
+	// 65537 would narrow to 1, which is a perfectly good vertex of a 16-bit mesh
+	TEST_CHECK(IndicesRejected({ 0, 1, 65537 }, 4));
+
+	// Primitive restart is the one index allowed past the end
+	TEST_CHECK(!IndicesRejected({ 0, 1, 2, 0xFFFFFFFF, 2, 3, 0 }, 4));
+}
\ No newline at end of file
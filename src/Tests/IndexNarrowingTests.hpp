@@ -0,0 +1,4 @@
+#pragma once
+
+// Indices past the last vertex are rejected before they can be narrowed into a different, valid index
+void RunIndexValidationTests();
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "JobSystemTests.hpp"
+
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+#include <Modules/Threading/JobSystem.hpp>
+
+#include "TestCheck.hpp"
+
+void RunJobSystemShutdownTests()
+{
+	// With no workers, nothing runs a job until someone waits, so destroying the system is the last chance to run them
+	{
+		Threading::JobSystem jobSystem;
+		jobSystem.CreateJobSystem(0);
+
+		Threading::JobCounter counter;
+		std::atomic<uint32_t> jobsRun = 0;
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			jobSystem.Run([&jobsRun]() { jobsRun++; }, &counter);
+		}
+
+		// Continuations are queued by the job that finishes their dependency, in the middle of shutting down
+		Threading::JobCounter continuationCounter;
+		jobSystem.RunAfter(&counter, [&jobsRun]() { jobsRun++; }, &continuationCounter);
+
+		jobSystem.DestroyJobSystem();
+
+		TEST_CHECK(jobsRun == 17);
+		TEST_CHECK(counter.IsComplete());
+		TEST_CHECK(continuationCounter.IsComplete());
+
+		// Cleanup that waits on its jobs after the system is gone, the way the pipeline wrapper does, returns straight away
+		jobSystem.Wait(&counter);
+
+		// And cleanup that queues more runs it there and then
+		Threading::JobCounter lateCounter;
+		jobSystem.Run([&jobsRun]() { jobsRun++; }, &lateCounter);
+		jobSystem.Wait(&lateCounter);
+
+		TEST_CHECK(jobsRun == 18);
+	}
+
+	// With workers, the same jobs run on whichever threads get to them first, but they all still run
+	{
+		Threading::JobSystem jobSystem;
+		jobSystem.CreateJobSystem(4);
+
+		Threading::JobCounter counter;
+		std::atomic<uint32_t> jobsRun = 0;
+		for (uint32_t i = 0; i < 1024; i++)
+		{
+			jobSystem.Run([&jobsRun]() { jobsRun++; }, &counter);
+		}
+
+		jobSystem.DestroyJobSystem();
+
+		TEST_CHECK(jobsRun == 1024);
+		TEST_CHECK(counter.IsComplete());
+	}
+}
+
+void RunJobSystemBackgroundTests()
+{
+	// With no workers, the waiting thread is the only one that could run anything, so it's the clearest case
+	{
+		Threading::JobSystem jobSystem;
+		jobSystem.CreateJobSystem(0);
+
+		Threading::JobCounter buildCounter;
+		std::atomic<bool> buildRun = false;
+		jobSystem.RunBackground([&buildRun]() { buildRun = true; }, &buildCounter);
+
+		Threading::JobCounter recordingCounter;
+		std::atomic<uint32_t> recordingJobsRun = 0;
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			jobSystem.Run([&recordingJobsRun]() { recordingJobsRun++; }, &recordingCounter);
+		}
+
+		jobSystem.Wait(&recordingCounter);
+
+		TEST_CHECK(recordingJobsRun == 4);
+		TEST_CHECK(!buildRun);
+
+		// Waiting on the build itself is what runs it, the way GetOrCreatePipeline and DestroyPipeline do
+		jobSystem.Wait(&buildCounter);
+		TEST_CHECK(buildRun);
+
+		jobSystem.DestroyJobSystem();
+	}
+
+	// With workers, frames keep waiting on recording while slow builds are still queued, and none of the builds run on the frame's thread
+	{
+		Threading::JobSystem jobSystem;
+		jobSystem.CreateJobSystem(2);
+
+		std::thread::id frameThread = std::this_thread::get_id();
+		std::atomic<uint32_t> buildsOnFrameThread = 0;
+		std::atomic<uint32_t> buildsRun = 0;
+
+		Threading::JobCounter buildCounter;
+		for (uint32_t i = 0; i < 32; i++)
+		{
+			jobSystem.RunBackground([&]()
+			{
+				if (std::this_thread::get_id() == frameThread) { buildsOnFrameThread++; }
+
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+				buildsRun++;
+			}, &buildCounter);
+		}
+
+		for (uint32_t frame = 0; frame < 50; frame++)
+		{
+			Threading::JobCounter recordingCounter;
+			std::atomic<uint32_t> recordingJobsRun = 0;
+			for (uint32_t i = 0; i < 8; i++)
+			{
+				jobSystem.Run([&recordingJobsRun]() { recordingJobsRun++; }, &recordingCounter);
+			}
+
+			jobSystem.Wait(&recordingCounter);
+			TEST_CHECK(recordingJobsRun == 8);
+		}
+
+		TEST_CHECK(buildsOnFrameThread == 0);
+
+		jobSystem.Wait(&buildCounter);
+		TEST_CHECK(buildsRun == 32);
+
+		jobSystem.DestroyJobSystem();
+	}
+}
\ No newline at end of file
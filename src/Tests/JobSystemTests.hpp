@@ -0,0 +1,7 @@
+#pragma once
+
+// Every job queued before a job system is destroyed runs, including on a system with no workers
+void RunJobSystemShutdownTests();
+
+// Waiting on one group of jobs, the way a frame waits on its recording jobs, never runs a background job from another group
+void RunJobSystemBackgroundTests();
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "ShaderReflectionTests.hpp"
+
+#include <vector>
+#include <cstring>
+#include <initializer_list>
+
+#include <Modules/Reflection/ShaderReflection.hpp>
+
+#include "TestCheck.hpp"
+
+static void EmitInstruction(std::vector<uint32_t>& words, uint32_t opcode, std::initializer_list<uint32_t> operands)
+{
+	words.push_back((uint32_t)(operands.size() + 1) << 16 | opcode);
+	words.insert(words.end(), operands.begin(), operands.end());
+}
+
+// What glslang makes (minus names and debug info) of a SPIR-V 1.0 module with two vertex entry points
+// Both take a mat4 at location 2, "main" reads the uniform block at binding 0 and "other" reads the one at binding 1
+//
+//	layout(location = 2) in mat4 inModel;
+//	layout(binding = 0) uniform A { vec4 a; };
+//	layout(binding = 1) uniform B { vec4 b; };
+static std::vector<char> BuildTwoEntryPointModule()
+{
+	enum : uint32_t
+	{
+		idVoid = 1, idFunctionType, idFloat, idVec4, idMat4, idInputMat4Pointer, idInModel, idBlock, idUniformBlockPointer,
+		idUniformA, idUniformB, idMain, idMainLabel, idOther, idOtherLabel, idUniformVec4Pointer, idInt, idZero,
+		idMainAccess, idOtherAccess, idBound
+	};
+
+	std::vector<uint32_t> words = { 0x07230203, 0x00010000, 0, idBound, 0 };
+
+	EmitInstruction(words, 17, { 1 });									// OpCapability Shader
+	EmitInstruction(words, 14, { 0, 1 });								// OpMemoryModel Logical GLSL450
+	EmitInstruction(words, 15, { 0, idMain, 0x6E69616D, 0, idInModel });		// OpEntryPoint Vertex "main"
+	EmitInstruction(words, 15, { 0, idOther, 0x6568746F, 0x72, idInModel });	// OpEntryPoint Vertex "other"
+
+	EmitInstruction(words, 71, { idInModel, 30, 2 });					// OpDecorate Location 2
+	EmitInstruction(words, 71, { idBlock, 2 });							// OpDecorate Block
+	EmitInstruction(words, 72, { idBlock, 0, 35, 0 });					// OpMemberDecorate Offset 0
+	EmitInstruction(words, 71, { idUniformA, 34, 0 });					// OpDecorate DescriptorSet 0
+	EmitInstruction(words, 71, { idUniformA, 33, 0 });					// OpDecorate Binding 0
+	EmitInstruction(words, 71, { idUniformB, 34, 0 });
+	EmitInstruction(words, 71, { idUniformB, 33, 1 });
+
+	EmitInstruction(words, 19, { idVoid });								// OpTypeVoid
+	EmitInstruction(words, 33, { idFunctionType, idVoid });				// OpTypeFunction
+	EmitInstruction(words, 22, { idFloat, 32 });						// OpTypeFloat
+	EmitInstruction(words, 23, { idVec4, idFloat, 4 });					// OpTypeVector
+	EmitInstruction(words, 24, { idMat4, idVec4, 4 });					// OpTypeMatrix
+	EmitInstruction(words, 32, { idInputMat4Pointer, 1, idMat4 });		// OpTypePointer Input
+	EmitInstruction(words, 59, { idInputMat4Pointer, idInModel, 1 });	// OpVariable Input
+	EmitInstruction(words, 30, { idBlock, idVec4 });					// OpTypeStruct
+	EmitInstruction(words, 32, { idUniformBlockPointer, 2, idBlock });	// OpTypePointer Uniform
+	EmitInstruction(words, 59, { idUniformBlockPointer, idUniformA, 2 });	// OpVariable Uniform
+	EmitInstruction(words, 59, { idUniformBlockPointer, idUniformB, 2 });
+	EmitInstruction(words, 32, { idUniformVec4Pointer, 2, idVec4 });
+	EmitInstruction(words, 21, { idInt, 32, 1 });						// OpTypeInt
+	EmitInstruction(words, 43, { idInt, idZero, 0 });					// OpConstant
+
+	EmitInstruction(words, 54, { idVoid, idMain, 0, idFunctionType });	// OpFunction
+	EmitInstruction(words, 248, { idMainLabel });						// OpLabel
+	EmitInstruction(words, 65, { idUniformVec4Pointer, idMainAccess, idUniformA, idZero });	// OpAccessChain
+	EmitInstruction(words, 253, {});									// OpReturn
+	EmitInstruction(words, 56, {});										// OpFunctionEnd
+
+	EmitInstruction(words, 54, { idVoid, idOther, 0, idFunctionType });
+	EmitInstruction(words, 248, { idOtherLabel });
+	EmitInstruction(words, 65, { idUniformVec4Pointer, idOtherAccess, idUniformB, idZero });
+	EmitInstruction(words, 253, {});
+	EmitInstruction(words, 56, {});
+
+	std::vector<char> bytecode(words.size() * 4);
+	std::memcpy(bytecode.data(), words.data(), bytecode.size());
+
+	return bytecode;
+}
+
+void RunShaderReflectionMatrixInputTests()
+{
+	Reflection::ShaderReflection reflection = Reflection::ReflectShader(BuildTwoEntryPointModule());
+
+	TEST_CHECK(reflection.stage == vk::ShaderStageFlagBits::eVertex);
+	TEST_CHECK(reflection.inputs.size() == 4);
+
+	for (uint32_t column = 0; column < reflection.inputs.size(); column++)
+	{
+		TEST_CHECK(reflection.inputs[column].location == 2 + column);
+		TEST_CHECK(reflection.inputs[column].format == vk::Format::eR32G32B32A32Sfloat);
+		TEST_CHECK(reflection.inputs[column].size == 16);
+	}
+}
+
+void RunShaderReflectionEntryPointTests()
+{
+	std::vector<char> bytecode = BuildTwoEntryPointModule();
+
+	Reflection::ShaderReflection mainReflection = Reflection::ReflectShader(bytecode, "main");
+	TEST_CHECK(mainReflection.descriptorBindings.size() == 1);
+	TEST_CHECK(mainReflection.descriptorBindings[0].binding == 0);
+	TEST_CHECK(mainReflection.descriptorBindings[0].type == vk::DescriptorType::eUniformBuffer);
+
+	Reflection::ShaderReflection otherReflection = Reflection::ReflectShader(bytecode, "other");
+	TEST_CHECK(otherReflection.descriptorBindings.size() == 1);
+	TEST_CHECK(otherReflection.descriptorBindings[0].binding == 1);
+
+	// Neither uses push constants, so there's no range to report
+	TEST_CHECK(mainReflection.pushConstantRange.size == 0);
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+
+// Matrix vertex inputs are split into one attribute per column
+void RunShaderReflectionMatrixInputTests();
+
+// Each entry point only gets the descriptor bindings it actually uses, even when the module declares more
+void RunShaderReflectionEntryPointTests();
\ No newline at end of file
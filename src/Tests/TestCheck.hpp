@@ -0,0 +1,7 @@
+#pragma once
+
+#include <string>
+#include <stdexcept>
+
+// Throws with the condition and where it is, so that main can report exactly which check failed
+#define TEST_CHECK(condition) if (!(condition)) { throw std::runtime_error(std::string(__FILE__) + ":" + std::to_string(__LINE__) + ": " + #condition); }
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include <Logger.hpp>
+
+#include "JobSystemTests.hpp"
+#include "ShaderReflectionTests.hpp"
+#include "IndexNarrowingTests.hpp"
+
+// Runs every test, or just the one named by the first argument, and fails if any of them do
+int main(int argc, char** argv)
+{
+	std::string selectedTest = argc > 1 ? argv[1] : "all";
+
+	std::vector<std::pair<std::string, void(*)()>> tests =
+	{
+		{ "jobshutdown", RunJobSystemShutdownTests },
+		{ "jobbackground", RunJobSystemBackgroundTests },
+		{ "reflectionmatrix", RunShaderReflectionMatrixInputTests },
+		{ "reflectionentrypoints", RunShaderReflectionEntryPointTests },
+		{ "indexvalidation", RunIndexValidationTests },
+	};
+
+	uint32_t failedCount = 0;
+	for (const std::pair<std::string, void(*)()>& test : tests)
+	{
+		if (selectedTest != "all" && selectedTest != test.first) { continue; }
+
+		try
+		{
+			test.second();
+			Logger::Log({ "Passed: ", test.first.c_str() }, LogType::Info);
+		}
+		catch (const std::exception& ex)
+		{
+			Logger::Log({ "Failed: ", test.first.c_str(), ": ", ex.what() }, LogType::Error);
+			failedCount++;
+		}
+	}
+
+	return failedCount > 0 ? 1 : 0;
+}
\ No newline at end of file
@@ -1,42 +1,37 @@
 #include "BufferWrapper.hpp"
 
-// Private
-uint32_t BufferWrapper::findMemoryType(vk::PhysicalDevice physDevice, uint32_t typeFilter, vk::MemoryPropertyFlags properties)
-{
-	vk::PhysicalDeviceMemoryProperties memoryProperties = physDevice.getMemoryProperties();
-
-	for(uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
-	{
-		// The first memory type that fits the filter and the selected properties will be accepted
-		if ((typeFilter & (1 << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
-		{
-			return i;
-		}
-	}
-
-	throw std::runtime_error("Could not find suitable memory type");
-}
+#include <set>
 
 // Public
-void BufferWrapper::CreateBuffer(vk::PhysicalDevice physDevice, vk::Device virtualDevice, vk::BufferCreateInfo bufferInfo, vk::MemoryPropertyFlags memoryProperties)
+void BufferWrapper::CreateBuffer(vk::Device virtualDevice, DeviceMemoryAllocator* allocator, vk::BufferCreateInfo bufferInfo, vk::MemoryPropertyFlags memoryProperties)
 {
 	m_bufferInfo = bufferInfo;
 	m_buffer = virtualDevice.createBuffer(bufferInfo);
 
 	vk::MemoryRequirements memoryRequirements = virtualDevice.getBufferMemoryRequirements(m_buffer);
 
-	uint32_t memoryType = findMemoryType(physDevice, memoryRequirements.memoryTypeBits, memoryProperties);
-	vk::MemoryAllocateInfo allocateInfo(
-		memoryRequirements.size,	//allocationSize
-		memoryType					//memoryTypeIndex
-	);
+	// We no longer own our memory, we just get handed a slice of one of the allocator's blocks
+	m_allocation = allocator->Allocate(virtualDevice, memoryRequirements, memoryProperties, AllocationType::eLinear);
 
-	m_bufferMemory = virtualDevice.allocateMemory(allocateInfo);
-
-	virtualDevice.bindBufferMemory(m_buffer, m_bufferMemory, 0);
+	virtualDevice.bindBufferMemory(m_buffer, m_allocation.memory, m_allocation.offset);
+}
 
-	vk::FenceCreateInfo fenceInfo;
-	m_copyDone = virtualDevice.createFence(fenceInfo);
+void BufferWrapper::CreateBuffer(vk::Device virtualDevice, DeviceMemoryAllocator* allocator, vk::DeviceSize size, vk::BufferUsageFlags usage,
+								 const std::vector<uint32_t>& queueFamilyIndices, vk::MemoryPropertyFlags memoryProperties)
+{
+	// Concurrent sharing doesn't allow duplicate queue family indices
+	std::set<uint32_t> uniqueQueueFamilySet(queueFamilyIndices.begin(), queueFamilyIndices.end());
+	std::vector<uint32_t> uniqueQueueFamilies(uniqueQueueFamilySet.begin(), uniqueQueueFamilySet.end());
+
+	vk::BufferCreateInfo bufferInfo(
+		{},																							//flags
+		size,																						//size
+		usage,																						//usage
+		uniqueQueueFamilies.size() > 1 ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive,	//sharingMode
+		uniqueQueueFamilies.size() > 1 ? (uint32_t)uniqueQueueFamilies.size() : 0,					//queueFamilyIndexCount
+		uniqueQueueFamilies.size() > 1 ? uniqueQueueFamilies.data() : nullptr						//pQueueFamilyIndices
+	);
+	CreateBuffer(virtualDevice, allocator, bufferInfo, memoryProperties);
 }
 
 void BufferWrapper::FillBuffer(vk::Device device, void* data, uint32_t elementSize, uint32_t elementCount)
@@ -44,55 +39,38 @@ void BufferWrapper::FillBuffer(vk::Device device, void* data, uint32_t elementSi
 	m_elementSize = elementSize;
 	m_elementCount = elementCount;
 
-	void* dataLocation;
-	dataLocation = device.mapMemory(m_bufferMemory, 0, m_bufferInfo.size);
-	std::memcpy(dataLocation, data, m_elementSize * m_elementCount);
-	device.unmapMemory(m_bufferMemory);
-}
+	// Host-visible blocks are persistently mapped by the allocator, and mapping memory that's already mapped isn't allowed
+	if (m_allocation.mappedData == nullptr)
+	{
+		throw std::runtime_error("Attempted to fill a buffer that is not host-visible");
+	}
 
-void BufferWrapper::CopyBuffer(vk::Device device, vk::Queue transferQueue, CommandPoolWrapper* commandPool, vk::Buffer destination)
-{
-	uint32_t bufferIndex = commandPool->CreateCommandBuffers(device, vk::CommandBufferLevel::ePrimary, 1)[0];
+	std::memcpy(m_allocation.mappedData, data, m_elementSize * m_elementCount);
 
-	commandPool->BeginRecordingToBuffer(bufferIndex, vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+	// Host-visible isn't necessarily host-coherent, so the write may need flushing before the device can see it
+	m_allocation.Flush(device, 0, m_elementSize * m_elementCount);
+}
 
+TransferTicket BufferWrapper::CopyBuffer(vk::Device device, TransferQueueWrapper* transferQueue, vk::Buffer destination)
+{
 	vk::BufferCopy copyRegion(
 		0,									//srcOffset
 		0,									//dstOffset
 		m_elementSize * m_elementCount		//size
 	);
 
-	commandPool->GetCommandBuffer(bufferIndex).copyBuffer(m_buffer, destination, copyRegion);
-
-	commandPool->EndRecordingToBuffer(bufferIndex);
-
-	vk::CommandBuffer commandBuffer = commandPool->GetCommandBuffer(bufferIndex);
-	vk::SubmitInfo submitInfo(
-		0,					//waitSemaphoreCount
-		nullptr,			//pWaitSemaphores
-		nullptr,			//pWaitDstStageMask
-		1,					//commandBufferCount
-		&commandBuffer,		//pCommandBuffers
-		0,					//signalSemaphoreCount
-		nullptr				//pSignalSemaphores
-	);
-
-	transferQueue.submit(submitInfo, m_copyDone);
-	vk::Result result = device.waitForFences(m_copyDone, vk::True, UINT64_MAX);
-	if (result == vk::Result::eTimeout)
-	{
-		throw std::runtime_error("Timed out while waiting for fence \"m_copyDone\"");
-	}
-	device.resetFences(m_copyDone);
-
-	device.freeCommandBuffers(commandPool->GetCommandPool(), commandPool->GetCommandBuffer(bufferIndex));
+	return CopyBuffer(device, transferQueue, destination, { copyRegion });
 }
 
-void BufferWrapper::DestroyBuffer(vk::Device device)
+TransferTicket BufferWrapper::CopyBuffer(vk::Device device, TransferQueueWrapper* transferQueue, vk::Buffer destination,
+										 std::vector<vk::BufferCopy> copyRegions)
 {
-	if (m_copyDone != nullptr) { device.destroyFence(m_copyDone); }
+	return transferQueue->SubmitCopies(device, m_buffer, destination, copyRegions);
+}
 
-	device.destroyBuffer(m_buffer);
+void BufferWrapper::DestroyBuffer(vk::Device device, DeviceMemoryAllocator* allocator)
+{
+	if (m_buffer != nullptr) { device.destroyBuffer(m_buffer); }
 
-	device.freeMemory(m_bufferMemory);
+	allocator->Free(device, m_allocation);
 }
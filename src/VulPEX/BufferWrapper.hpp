@@ -1,35 +1,40 @@
 #pragma once
 
+#include <vector>
+
 #include "Utility/VulkanDynamicInclude.hpp"
 
-#include "CommandPoolWrapper.hpp"
+#include "TransferQueueWrapper.hpp"
+#include "DeviceMemoryAllocator.hpp"
 
 class BufferWrapper
 {
 	// Vulkan resources
 	vk::Buffer m_buffer;
-	vk::DeviceMemory m_bufferMemory;
+	MemoryAllocation m_allocation;
 
 	vk::BufferCreateInfo m_bufferInfo;
 
-	vk::Fence m_copyDone;
-
 	// Other resources
 	uint32_t m_elementSize;
 	uint32_t m_elementCount;
 
-	// Helpers
-	static uint32_t findMemoryType(vk::PhysicalDevice physDevice, uint32_t typeFilter, vk::MemoryPropertyFlags properties);
-
 public:
-	void CreateBuffer(vk::PhysicalDevice physDevice, vk::Device virtualDevice, vk::BufferCreateInfo bufferInfo, vk::MemoryPropertyFlags memoryProperties);
+	void CreateBuffer(vk::Device virtualDevice, DeviceMemoryAllocator* allocator, vk::BufferCreateInfo bufferInfo, vk::MemoryPropertyFlags memoryProperties);
+	// Shares the buffer concurrently if queueFamilyIndices holds more than one distinct family, otherwise it's exclusive
+	void CreateBuffer(vk::Device virtualDevice, DeviceMemoryAllocator* allocator, vk::DeviceSize size, vk::BufferUsageFlags usage,
+					  const std::vector<uint32_t>& queueFamilyIndices, vk::MemoryPropertyFlags memoryProperties);
 
 	void FillBuffer(vk::Device device, void* data, uint32_t elementSize, uint32_t elementCount);
-	void CopyBuffer(vk::Device device, vk::Queue transferQueue, CommandPoolWrapper* commandPool, vk::Buffer destination);
+
+	// These return straight away. Poll or wait on the returned ticket to find out when the copy has actually happened
+	TransferTicket CopyBuffer(vk::Device device, TransferQueueWrapper* transferQueue, vk::Buffer destination);
+	TransferTicket CopyBuffer(vk::Device device, TransferQueueWrapper* transferQueue, vk::Buffer destination, std::vector<vk::BufferCopy> copyRegions);
 
 	// Getters
 	vk::Buffer GetBuffer() const { return m_buffer; };
+	MemoryAllocation GetAllocation() const { return m_allocation; };
 
 	// Cleanup
-	void DestroyBuffer(vk::Device device);
+	void DestroyBuffer(vk::Device device, DeviceMemoryAllocator* allocator);
 };
\ No newline at end of file
@@ -31,7 +31,7 @@ std::vector<uint32_t> CommandPoolWrapper::CreateCommandBuffers(vk::Device device
 	return newBufferIndices;
 }
 
-void CommandPoolWrapper::BeginRecordingToBuffer(uint32_t bufferIndex, vk::CommandBufferUsageFlagBits usageFlags,
+void CommandPoolWrapper::BeginRecordingToBuffer(uint32_t bufferIndex, vk::CommandBufferUsageFlags usageFlags,
 												vk::CommandBufferInheritanceInfo secondaryInheritanceInfo)
 {
 	vk::CommandBufferBeginInfo cbBeginInfo(
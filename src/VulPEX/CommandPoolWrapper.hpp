@@ -12,7 +12,7 @@ public:
 	void CreateCommandPool(vk::Device device, vk::CommandPoolCreateFlagBits bufferType, uint32_t queueFamilyIndex);
 	std::vector<uint32_t>  CreateCommandBuffers(vk::Device device, vk::CommandBufferLevel bufferLevel, uint32_t numBuffers);
 
-	void BeginRecordingToBuffer(uint32_t bufferIndex, vk::CommandBufferUsageFlagBits usageFlags = {},
+	void BeginRecordingToBuffer(uint32_t bufferIndex, vk::CommandBufferUsageFlags usageFlags = {},
 								vk::CommandBufferInheritanceInfo secondaryInheritanceInfo = {});
 	void EndRecordingToBuffer(uint32_t bufferIndex);
 	
@@ -0,0 +1,238 @@
+#include "ComputePipelineWrapper.hpp"
+
+#include <map>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+
+// Private
+vk::ShaderModule ComputePipelineWrapper::CreateShaderModule(vk::Device device, const std::vector<char>& bytecode)
+{
+	vk::ShaderModuleCreateInfo moduleInfo(
+		{},									//flags
+		bytecode.size(),					//codeSize
+		(const uint32_t*)bytecode.data(),	//pCode | This expects a uint32_t
+		nullptr								//pNext
+	);
+
+	return device.createShaderModule(moduleInfo);
+}
+
+void ComputePipelineWrapper::CreatePipelineLayout(vk::Device device)
+{
+	// Sets have to be contiguous, so any gaps are filled with empty ones
+	uint32_t setCount = m_reflection.descriptorBindings.empty() ? 0 : m_reflection.descriptorBindings.back().set + 1;
+	std::vector<std::vector<vk::DescriptorSetLayoutBinding>> sets(setCount);
+
+	for (const Reflection::DescriptorBinding& binding : m_reflection.descriptorBindings)
+	{
+		vk::DescriptorSetLayoutBinding layoutBinding(
+			binding.binding,	//binding
+			binding.type,		//descriptorType
+			binding.count,		//descriptorCount
+			binding.stages,		//stageFlags
+			nullptr				//pImmutableSamplers
+		);
+
+		sets[binding.set].push_back(layoutBinding);
+	}
+
+	for (const std::vector<vk::DescriptorSetLayoutBinding>& set : sets)
+	{
+		vk::DescriptorSetLayoutCreateInfo setLayoutInfo(
+			{},						//flags
+			(uint32_t)set.size(),	//bindingCount
+			set.data()				//pBindings
+		);
+
+		m_setLayouts.push_back(device.createDescriptorSetLayout(setLayoutInfo));
+	}
+
+	vk::PipelineLayoutCreateInfo pipelineLayoutInfo(
+		{},													//flags
+		(uint32_t)m_setLayouts.size(),						//setLayoutCount
+		m_setLayouts.data(),								//pSetLayouts
+		m_reflection.pushConstantRange.size > 0 ? 1u : 0u,	//pushConstantRangeCount
+		&m_reflection.pushConstantRange						//pPushConstantRanges
+	);
+
+	m_pipelineLayout = device.createPipelineLayout(pipelineLayoutInfo);
+}
+
+void ComputePipelineWrapper::CreateDescriptorPool(vk::Device device, uint32_t maxSetsPerLayout)
+{
+	if (m_setLayouts.empty()) { return; }
+
+	std::map<vk::DescriptorType, uint32_t> descriptorCounts;
+	for (const Reflection::DescriptorBinding& binding : m_reflection.descriptorBindings)
+	{
+		descriptorCounts[binding.type] += binding.count * maxSetsPerLayout;
+	}
+
+	std::vector<vk::DescriptorPoolSize> poolSizes;
+	for (const std::pair<const vk::DescriptorType, uint32_t>& descriptorCount : descriptorCounts)
+	{
+		poolSizes.push_back(vk::DescriptorPoolSize(descriptorCount.first, descriptorCount.second));
+	}
+
+	vk::DescriptorPoolCreateInfo poolInfo(
+		{},														//flags
+		(uint32_t)m_setLayouts.size() * maxSetsPerLayout,		//maxSets
+		(uint32_t)poolSizes.size(),								//poolSizeCount
+		poolSizes.data()										//pPoolSizes
+	);
+
+	m_descriptorPool = device.createDescriptorPool(poolInfo);
+}
+
+// Public
+void ComputePipelineWrapper::CreateComputePipeline(vk::Device device, vk::PipelineCache pipelineCache, ComputeShaderInfo shaderInfo,
+												   uint32_t maxSetsPerLayout)
+{
+	m_reflection = Reflection::ReflectShader(shaderInfo.bytecode, shaderInfo.entryPoint);
+	if (m_reflection.stage != vk::ShaderStageFlagBits::eCompute)
+	{
+		throw std::runtime_error("Compute pipelines need a compute shader, but entry point \"" + shaderInfo.entryPoint + "\" is a different stage");
+	}
+
+	CreatePipelineLayout(device);
+	CreateDescriptorPool(device, maxSetsPerLayout);
+
+	vk::ShaderModule shaderModule = CreateShaderModule(device, shaderInfo.bytecode);
+
+	std::vector<vk::SpecializationMapEntry> mapEntries;
+	std::vector<uint32_t> specialisationData;
+	vk::SpecializationInfo specialisationInfo = GetSpecialisationInfo(shaderInfo.specialisationConstants, mapEntries, specialisationData);
+
+	vk::PipelineShaderStageCreateInfo shaderStageInfo(
+		{},														//flags
+		vk::ShaderStageFlagBits::eCompute,						//stage
+		shaderModule,											//module
+		shaderInfo.entryPoint.c_str(),							//pName
+		mapEntries.empty() ? nullptr : &specialisationInfo		//pSpecializationInfo
+	);
+
+	vk::ComputePipelineCreateInfo pipelineInfo(
+		{},						//flags
+		shaderStageInfo,		//stage
+		m_pipelineLayout,		//layout
+		nullptr,				//basePipelineHandle
+		-1						//basePipelineIndex
+	);
+
+	std::chrono::steady_clock::time_point creationStart = std::chrono::steady_clock::now();
+
+	vk::Result result;
+	std::tie(result, m_pipeline) = device.createComputePipeline(pipelineCache, pipelineInfo);
+
+	m_creationTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - creationStart).count();
+
+	// The module is compiled into the pipeline, so it's not needed any more
+	device.destroyShaderModule(shaderModule);
+
+	if (result != vk::Result::eSuccess)
+	{
+		throw std::runtime_error("Failed to create compute pipeline: " + vk::to_string(result));
+	}
+}
+
+vk::DescriptorSet ComputePipelineWrapper::AllocateDescriptorSet(vk::Device device, uint32_t set)
+{
+	if (set >= m_setLayouts.size())
+	{
+		throw std::runtime_error("Compute shader has no descriptor set " + std::to_string(set));
+	}
+
+	vk::DescriptorSetAllocateInfo allocateInfo(
+		m_descriptorPool,		//descriptorPool
+		1,						//descriptorSetCount
+		&m_setLayouts[set]		//pSetLayouts
+	);
+
+	return device.allocateDescriptorSets(allocateInfo)[0];
+}
+
+void ComputePipelineWrapper::WriteBufferDescriptor(vk::Device device, vk::DescriptorSet descriptorSet, uint32_t set, uint32_t binding, vk::Buffer buffer,
+												   vk::DeviceSize offset, vk::DeviceSize range) const
+{
+	std::vector<Reflection::DescriptorBinding>::const_iterator it = std::find_if(m_reflection.descriptorBindings.begin(), m_reflection.descriptorBindings.end(),
+		[set, binding](const Reflection::DescriptorBinding& descriptorBinding) { return descriptorBinding.set == set && descriptorBinding.binding == binding; });
+
+	bool isBuffer = it != m_reflection.descriptorBindings.end() &&
+					(it->type == vk::DescriptorType::eStorageBuffer || it->type == vk::DescriptorType::eUniformBuffer);
+	if (!isBuffer)
+	{
+		throw std::runtime_error("Compute shader has no buffer at set " + std::to_string(set) + ", binding " + std::to_string(binding));
+	}
+
+	vk::DescriptorBufferInfo bufferInfo(
+		buffer,		//buffer
+		offset,		//offset
+		range		//range
+	);
+
+	vk::WriteDescriptorSet descriptorWrite(
+		descriptorSet,	//dstSet
+		binding,		//dstBinding
+		0,				//dstArrayElement
+		1,				//descriptorCount
+		it->type,		//descriptorType
+		nullptr,		//pImageInfo
+		&bufferInfo,	//pBufferInfo
+		nullptr			//pTexelBufferView
+	);
+
+	device.updateDescriptorSets(descriptorWrite, nullptr);
+}
+
+void ComputePipelineWrapper::RecordBind(vk::CommandBuffer commandBuffer, const std::vector<vk::DescriptorSet>& descriptorSets, const void* pushConstants,
+										uint32_t pushConstantsSize) const
+{
+	commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_pipeline);
+
+	if (!descriptorSets.empty())
+	{
+		commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_pipelineLayout, 0, descriptorSets, nullptr);
+	}
+
+	if (pushConstants != nullptr && pushConstantsSize > 0)
+	{
+		commandBuffer.pushConstants(m_pipelineLayout, vk::ShaderStageFlagBits::eCompute, m_reflection.pushConstantRange.offset, pushConstantsSize,
+									pushConstants);
+	}
+}
+
+void ComputePipelineWrapper::RecordDispatch(vk::CommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) const
+{
+	// Empty dispatches are allowed, but there's no point recording them
+	if (groupCountX == 0 || groupCountY == 0 || groupCountZ == 0) { return; }
+
+	commandBuffer.dispatch(groupCountX, groupCountY, groupCountZ);
+}
+
+void ComputePipelineWrapper::RecordDispatchForItems(vk::CommandBuffer commandBuffer, uint32_t itemCountX, uint32_t itemCountY, uint32_t itemCountZ) const
+{
+	RecordDispatch(commandBuffer,
+				   (itemCountX + m_reflection.localSize[0] - 1) / m_reflection.localSize[0],
+				   (itemCountY + m_reflection.localSize[1] - 1) / m_reflection.localSize[1],
+				   (itemCountZ + m_reflection.localSize[2] - 1) / m_reflection.localSize[2]);
+}
+
+void ComputePipelineWrapper::DestroyComputePipeline(vk::Device device)
+{
+	if (m_pipeline != nullptr) { device.destroyPipeline(m_pipeline); }
+	if (m_pipelineLayout != nullptr) { device.destroyPipelineLayout(m_pipelineLayout); }
+
+	for (vk::DescriptorSetLayout setLayout : m_setLayouts)
+	{
+		device.destroyDescriptorSetLayout(setLayout);
+	}
+	m_setLayouts.clear();
+
+	// Takes every set allocated from it along with it
+	if (m_descriptorPool != nullptr) { device.destroyDescriptorPool(m_descriptorPool); }
+
+	m_pipeline = nullptr;
+	m_pipelineLayout = nullptr;
+	m_descriptorPool = nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include <string>
+
+#include "Utility/VulkanDynamicInclude.hpp"
+
+#include "PipelineStateDescription.hpp"
+#include "Modules/Reflection/ShaderReflection.hpp"
+
+struct ComputeShaderInfo
+{
+	std::vector<char> bytecode;
+	std::string entryPoint = "main";
+
+	SpecialisationConstants specialisationConstants;
+};
+
+// One compute pipeline, along with the layouts and descriptor pool it needs, all built from the reflected shader
+class ComputePipelineWrapper
+{
+	// Vulkan resources
+	vk::Pipeline m_pipeline = nullptr;
+	vk::PipelineLayout m_pipelineLayout = nullptr;
+	std::vector<vk::DescriptorSetLayout> m_setLayouts;
+
+	vk::DescriptorPool m_descriptorPool = nullptr;
+
+	// Misc resources
+	Reflection::ShaderReflection m_reflection;
+
+	double m_creationTimeMs = 0;
+
+	vk::ShaderModule CreateShaderModule(vk::Device device, const std::vector<char>& bytecode);
+
+	void CreatePipelineLayout(vk::Device device);
+	void CreateDescriptorPool(vk::Device device, uint32_t maxSetsPerLayout);
+
+public:
+	// pipelineCache can be nullptr, but then the shader gets compiled from scratch every time
+	// maxSetsPerLayout is how many descriptor sets of each of the shader's sets can be allocated with AllocateDescriptorSet
+	void CreateComputePipeline(vk::Device device, vk::PipelineCache pipelineCache, ComputeShaderInfo shaderInfo, uint32_t maxSetsPerLayout = 1);
+
+	// Sets come from the pipeline's own pool, and are freed along with it
+	vk::DescriptorSet AllocateDescriptorSet(vk::Device device, uint32_t set);
+
+	// The descriptor type is whatever the shader declared at that binding. Throws if the shader has no buffer there
+	void WriteBufferDescriptor(vk::Device device, vk::DescriptorSet descriptorSet, uint32_t set, uint32_t binding, vk::Buffer buffer,
+							   vk::DeviceSize offset = 0, vk::DeviceSize range = vk::WholeSize) const;
+
+	// Binds the pipeline, then descriptorSets from set 0 onwards, then pushConstants if there are any
+	void RecordBind(vk::CommandBuffer commandBuffer, const std::vector<vk::DescriptorSet>& descriptorSets, const void* pushConstants = nullptr,
+					uint32_t pushConstantsSize = 0) const;
+
+	// Expects RecordBind to have been called first
+	void RecordDispatch(vk::CommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1) const;
+	// Rounds up to whole workgroups, using the shader's local size, so the shader has to ignore invocations past the end itself
+	void RecordDispatchForItems(vk::CommandBuffer commandBuffer, uint32_t itemCountX, uint32_t itemCountY = 1, uint32_t itemCountZ = 1) const;
+
+	// Getters
+	vk::Pipeline GetPipeline() const { return m_pipeline; };
+	vk::PipelineLayout GetPipelineLayout() const { return m_pipelineLayout; };
+
+	const Reflection::ShaderReflection& GetReflection() const { return m_reflection; };
+
+	double GetCreationTimeMs() const { return m_creationTimeMs; };
+
+	// Bools
+	bool IsCreated() const { return m_pipeline != nullptr; };
+
+	// Cleanup
+	void DestroyComputePipeline(vk::Device device);
+};
\ No newline at end of file
@@ -0,0 +1,328 @@
+#include "DeviceMemoryAllocator.hpp"
+
+#include <algorithm>
+
+#include <Logger.hpp>
+
+static vk::DeviceSize AlignUp(vk::DeviceSize value, vk::DeviceSize alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static bool IsGranularityConflict(AllocationType a, AllocationType b)
+{
+	return (a == AllocationType::eLinear && b == AllocationType::eNonLinear) || (a == AllocationType::eNonLinear && b == AllocationType::eLinear);
+}
+
+// Whether the last byte of one resource and the first byte of another land on the same bufferImageGranularity "page"
+static bool IsOnSamePage(vk::DeviceSize lastByteOfA, vk::DeviceSize firstByteOfB, vk::DeviceSize pageSize)
+{
+	return (lastByteOfA & ~(pageSize - 1)) == (firstByteOfB & ~(pageSize - 1));
+}
+
+static vk::DeviceSize AlignDown(vk::DeviceSize value, vk::DeviceSize alignment)
+{
+	return value & ~(alignment - 1);
+}
+
+void MemoryAllocation::Flush(vk::Device device, vk::DeviceSize writeOffset, vk::DeviceSize writeSize) const
+{
+	if (block == nullptr || mappedData == nullptr || block->isHostCoherent)
+	{
+		return;
+	}
+
+	if (writeSize == vk::WholeSize)
+	{
+		writeSize = size - writeOffset;
+	}
+
+	if (writeSize == 0)
+	{
+		return;
+	}
+
+	// The range is widened to whole atoms, which can spill into a neighbouring allocation. That's harmless since flushing
+	// only publishes what the host already wrote, but it can't go past the end of the block
+	vk::DeviceSize start = AlignDown(offset + writeOffset, block->nonCoherentAtomSize);
+	vk::DeviceSize end = std::min(AlignUp(offset + writeOffset + writeSize, block->nonCoherentAtomSize), block->size);
+
+	vk::MappedMemoryRange range(
+		memory,			//memory
+		start,			//offset
+		end - start		//size
+	);
+
+	device.flushMappedMemoryRanges(range);
+}
+
+// Private
+uint32_t DeviceMemoryAllocator::FindMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const
+{
+	for(uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; i++)
+	{
+		// The first memory type that fits the filter and the selected properties will be accepted
+		if ((typeFilter & (1 << i)) && (m_memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+		{
+			return i;
+		}
+	}
+
+	throw std::runtime_error("Could not find suitable memory type");
+}
+
+MemoryBlock* DeviceMemoryAllocator::CreateBlock(vk::Device device, uint32_t memoryTypeIndex, vk::DeviceSize size)
+{
+	vk::MemoryAllocateInfo allocateInfo(
+		size,				//allocationSize
+		memoryTypeIndex		//memoryTypeIndex
+	);
+
+	std::unique_ptr<MemoryBlock> block = std::make_unique<MemoryBlock>();
+	block->memory = device.allocateMemory(allocateInfo);
+	block->size = size;
+	block->memoryTypeIndex = memoryTypeIndex;
+	block->subAllocations.push_back({ 0, size, AllocationType::eFree });
+
+	// Mapping is expensive, so host-visible blocks get mapped once here rather than every time someone wants to write to them
+	if (m_memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible)
+	{
+		block->mappedData = device.mapMemory(block->memory, 0, vk::WholeSize);
+		block->isHostCoherent = bool(m_memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & vk::MemoryPropertyFlagBits::eHostCoherent);
+		block->nonCoherentAtomSize = m_nonCoherentAtomSize;
+	}
+
+	m_blocks[memoryTypeIndex].push_back(std::move(block));
+
+	return m_blocks[memoryTypeIndex].back().get();
+}
+
+bool DeviceMemoryAllocator::TryAllocateFromBlock(MemoryBlock* block, vk::MemoryRequirements requirements, AllocationType type,
+												 MemoryAllocation& allocation)
+{
+	std::vector<MemorySubAllocation>& subAllocs = block->subAllocations;
+
+	// First fit. Blocks rarely have more than a few dozen ranges in them, so this hasn't been worth anything cleverer yet
+	for (size_t i = 0; i < subAllocs.size(); i++)
+	{
+		MemorySubAllocation freeRange = subAllocs[i];
+		if (freeRange.type != AllocationType::eFree || freeRange.size < requirements.size) { continue; }
+
+		vk::DeviceSize offset = AlignUp(freeRange.offset, requirements.alignment);
+
+		// Free ranges are always merged, so whatever comes before us is guaranteed to be in use
+		if (i > 0 && m_bufferImageGranularity > 1)
+		{
+			const MemorySubAllocation& previous = subAllocs[i - 1];
+			if (IsGranularityConflict(previous.type, type) && IsOnSamePage(previous.offset + previous.size - 1, offset, m_bufferImageGranularity))
+			{
+				offset = AlignUp(offset, m_bufferImageGranularity);
+			}
+		}
+
+		vk::DeviceSize end = offset + requirements.size;
+		if (end > freeRange.offset + freeRange.size) { continue; }
+
+		if (i + 1 < subAllocs.size() && m_bufferImageGranularity > 1)
+		{
+			const MemorySubAllocation& next = subAllocs[i + 1];
+			if (IsGranularityConflict(type, next.type) && IsOnSamePage(end - 1, next.offset, m_bufferImageGranularity))
+			{
+				continue;
+			}
+		}
+
+		// Split the free range into [padding][allocation][remainder], leaving out whichever ends are empty
+		std::vector<MemorySubAllocation> replacement;
+		if (offset > freeRange.offset)
+		{
+			replacement.push_back({ freeRange.offset, offset - freeRange.offset, AllocationType::eFree });
+		}
+
+		replacement.push_back({ offset, requirements.size, type });
+
+		if (end < freeRange.offset + freeRange.size)
+		{
+			replacement.push_back({ end, freeRange.offset + freeRange.size - end, AllocationType::eFree });
+		}
+
+		subAllocs.erase(subAllocs.begin() + i);
+		subAllocs.insert(subAllocs.begin() + i, replacement.begin(), replacement.end());
+
+		block->usedBytes += requirements.size;
+
+		allocation.block = block;
+		allocation.memory = block->memory;
+		allocation.offset = offset;
+		allocation.size = requirements.size;
+		allocation.mappedData = block->mappedData != nullptr ? (char*)block->mappedData + offset : nullptr;
+
+		return true;
+	}
+
+	return false;
+}
+
+void DeviceMemoryAllocator::FreeBlock(vk::Device device, MemoryBlock* block)
+{
+	std::vector<std::unique_ptr<MemoryBlock>>& blocks = m_blocks[block->memoryTypeIndex];
+
+	// Unmapping happens implicitly when memory is freed
+	device.freeMemory(block->memory);
+
+	blocks.erase(std::find_if(blocks.begin(), blocks.end(), [block](const std::unique_ptr<MemoryBlock>& b) { return b.get() == block; }));
+}
+
+// Public
+void DeviceMemoryAllocator::ConfigureAllocator(vk::DeviceSize preferredBlockSize)
+{
+	m_preferredBlockSize = preferredBlockSize;
+}
+
+void DeviceMemoryAllocator::CreateAllocator(vk::PhysicalDevice physDevice)
+{
+	m_memoryProperties = physDevice.getMemoryProperties();
+	vk::PhysicalDeviceLimits limits = physDevice.getProperties().limits;
+	m_bufferImageGranularity = limits.bufferImageGranularity;
+	m_nonCoherentAtomSize = limits.nonCoherentAtomSize;
+}
+
+MemoryAllocation DeviceMemoryAllocator::Allocate(vk::Device device, vk::MemoryRequirements requirements, vk::MemoryPropertyFlags memoryProperties,
+												 AllocationType type)
+{
+	uint32_t memoryTypeIndex = FindMemoryType(requirements.memoryTypeBits, memoryProperties);
+
+	MemoryAllocation allocation;
+
+	// Big allocations would just fragment a shared block, so they get their own
+	if (requirements.size > m_preferredBlockSize / 2)
+	{
+		MemoryBlock* dedicatedBlock = CreateBlock(device, memoryTypeIndex, requirements.size);
+		TryAllocateFromBlock(dedicatedBlock, requirements, type, allocation);
+
+		m_allocationCount++;
+		return allocation;
+	}
+
+	for (std::unique_ptr<MemoryBlock>& block : m_blocks[memoryTypeIndex])
+	{
+		if (block->size - block->usedBytes >= requirements.size && TryAllocateFromBlock(block.get(), requirements, type, allocation))
+		{
+			m_allocationCount++;
+			return allocation;
+		}
+	}
+
+	// Some heaps (e.g. the host-visible slice of VRAM) are tiny, so don't let one block eat all of it
+	vk::DeviceSize heapSize = m_memoryProperties.memoryHeaps[m_memoryProperties.memoryTypes[memoryTypeIndex].heapIndex].size;
+	vk::DeviceSize blockSize = std::max(std::min(m_preferredBlockSize, heapSize / 8), requirements.size);
+
+	MemoryBlock* newBlock = CreateBlock(device, memoryTypeIndex, blockSize);
+	if (!TryAllocateFromBlock(newBlock, requirements, type, allocation))
+	{
+		throw std::runtime_error("Could not fit allocation of size " + std::to_string(requirements.size) + " into a new memory block");
+	}
+
+	m_allocationCount++;
+	return allocation;
+}
+
+void DeviceMemoryAllocator::Free(vk::Device device, MemoryAllocation& allocation)
+{
+	if (!allocation.IsValid()) { return; }
+
+	MemoryBlock* block = allocation.block;
+	std::vector<MemorySubAllocation>& subAllocs = block->subAllocations;
+
+	std::vector<MemorySubAllocation>::iterator it = std::find_if(subAllocs.begin(), subAllocs.end(),
+		[&allocation](const MemorySubAllocation& subAlloc) { return subAlloc.offset == allocation.offset && subAlloc.type != AllocationType::eFree; });
+
+	if (it == subAllocs.end())
+	{
+		throw std::runtime_error("Attempted to free an allocation that does not belong to its memory block");
+	}
+
+	it->type = AllocationType::eFree;
+	block->usedBytes -= it->size;
+	m_allocationCount--;
+
+	// Merge with the next range, then the previous one
+	if (it + 1 != subAllocs.end() && (it + 1)->type == AllocationType::eFree)
+	{
+		it->size += (it + 1)->size;
+		it = subAllocs.erase(it + 1) - 1;
+	}
+
+	if (it != subAllocs.begin() && (it - 1)->type == AllocationType::eFree)
+	{
+		(it - 1)->size += it->size;
+		subAllocs.erase(it);
+	}
+
+	// Keep one empty block around per memory type, so that freeing and reallocating every frame doesn't hit the driver each time
+	if (block->usedBytes == 0 && m_blocks[block->memoryTypeIndex].size() > 1)
+	{
+		FreeBlock(device, block);
+	}
+
+	allocation = {};
+}
+
+MemoryAllocatorStats DeviceMemoryAllocator::GetStats() const
+{
+	MemoryAllocatorStats stats;
+	stats.allocationCount = m_allocationCount;
+
+	vk::DeviceSize totalFree = 0;
+
+	for (const std::vector<std::unique_ptr<MemoryBlock>>& blocks : m_blocks)
+	{
+		for (const std::unique_ptr<MemoryBlock>& block : blocks)
+		{
+			stats.blockCount++;
+			stats.bytesReserved += block->size;
+			stats.bytesUsed += block->usedBytes;
+
+			for (const MemorySubAllocation& subAlloc : block->subAllocations)
+			{
+				if (subAlloc.type != AllocationType::eFree) { continue; }
+
+				totalFree += subAlloc.size;
+				stats.largestFreeRange = std::max(stats.largestFreeRange, subAlloc.size);
+			}
+		}
+	}
+
+	if (totalFree > 0)
+	{
+		stats.fragmentation = 1.0f - (float)stats.largestFreeRange / (float)totalFree;
+	}
+
+	return stats;
+}
+
+void DeviceMemoryAllocator::LogStats() const
+{
+	MemoryAllocatorStats stats = GetStats();
+
+	std::string statsMessage = "Device memory: " + std::to_string(stats.allocationCount) + " allocations in " + std::to_string(stats.blockCount) +
+							   " blocks, " + std::to_string(stats.bytesUsed) + "/" + std::to_string(stats.bytesReserved) + " bytes used, largest free range " +
+							   std::to_string(stats.largestFreeRange) + " bytes, fragmentation " + std::to_string(stats.fragmentation);
+
+	Logger::Log({ statsMessage.c_str() }, LogType::Info);
+}
+
+void DeviceMemoryAllocator::DestroyAllocator(vk::Device device)
+{
+	for (std::vector<std::unique_ptr<MemoryBlock>>& blocks : m_blocks)
+	{
+		for (std::unique_ptr<MemoryBlock>& block : blocks)
+		{
+			device.freeMemory(block->memory);
+		}
+
+		blocks.clear();
+	}
+
+	m_allocationCount = 0;
+}
\ No newline at end of file
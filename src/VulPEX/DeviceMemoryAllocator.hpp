@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <memory>
+
+#include "Utility/VulkanDynamicInclude.hpp"
+
+// Linear resources (buffers, linear-tiled images) and non-linear resources (optimal-tiled images) can't share a
+// bufferImageGranularity-sized "page" of memory, so we need to know what each sub-allocation is for
+enum class AllocationType
+{
+	eFree,
+	eLinear,
+	eNonLinear
+};
+
+struct MemorySubAllocation
+{
+	vk::DeviceSize offset = 0;
+	vk::DeviceSize size = 0;
+	AllocationType type = AllocationType::eFree;
+};
+
+struct MemoryBlock
+{
+	vk::DeviceMemory memory = nullptr;
+	vk::DeviceSize size = 0;
+	vk::DeviceSize usedBytes = 0;
+
+	uint32_t memoryTypeIndex = 0;
+
+	// Host-visible blocks are mapped once when they're created, and stay mapped until they're freed
+	void* mappedData = nullptr;
+
+	// Writes to mapped memory that isn't host-coherent only become visible to the device once they're flushed,
+	// and flushed ranges have to start and end on a multiple of nonCoherentAtomSize
+	bool isHostCoherent = false;
+	vk::DeviceSize nonCoherentAtomSize = 1;
+
+	// Sorted by offset, and always covers the entire block. Neighbouring free ranges are merged as soon as they appear
+	std::vector<MemorySubAllocation> subAllocations;
+};
+
+// The handle that buffers hold instead of owning a vk::DeviceMemory themselves
+struct MemoryAllocation
+{
+	MemoryBlock* block = nullptr;
+
+	vk::DeviceMemory memory = nullptr;
+	vk::DeviceSize offset = 0;
+	vk::DeviceSize size = 0;
+
+	// Points at the start of this allocation, not the start of the block. nullptr if the memory isn't host-visible
+	void* mappedData = nullptr;
+
+	// Makes host writes to [offset, offset + size) of this allocation visible to the device. Does nothing for coherent memory
+	void Flush(vk::Device device, vk::DeviceSize writeOffset = 0, vk::DeviceSize writeSize = vk::WholeSize) const;
+
+	bool IsValid() const { return block != nullptr; };
+};
+
+struct MemoryAllocatorStats
+{
+	uint32_t blockCount = 0;
+	uint32_t allocationCount = 0;
+
+	vk::DeviceSize bytesReserved = 0;
+	vk::DeviceSize bytesUsed = 0;
+	vk::DeviceSize largestFreeRange = 0;
+
+	// 0 means all free memory is in one contiguous range, values approaching 1 mean it's scattered in lots of small holes
+	float fragmentation = 0;
+};
+
+class DeviceMemoryAllocator
+{
+	// Vulkan resources
+	vk::PhysicalDeviceMemoryProperties m_memoryProperties;
+	vk::DeviceSize m_bufferImageGranularity = 1;
+	vk::DeviceSize m_nonCoherentAtomSize = 1;
+
+	// Misc resources
+	std::array<std::vector<std::unique_ptr<MemoryBlock>>, VK_MAX_MEMORY_TYPES> m_blocks;
+
+	vk::DeviceSize m_preferredBlockSize = 64 * 1024 * 1024;
+
+	uint32_t m_allocationCount = 0;
+
+	// Helpers
+	uint32_t FindMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const;
+
+	MemoryBlock* CreateBlock(vk::Device device, uint32_t memoryTypeIndex, vk::DeviceSize size);
+	bool TryAllocateFromBlock(MemoryBlock* block, vk::MemoryRequirements requirements, AllocationType type, MemoryAllocation& allocation);
+
+	void FreeBlock(vk::Device device, MemoryBlock* block);
+
+public:
+	// Must be called before CreateAllocator
+	// Allocations bigger than half of preferredBlockSize will get a block all to themselves
+	void ConfigureAllocator(vk::DeviceSize preferredBlockSize);
+	void CreateAllocator(vk::PhysicalDevice physDevice);
+
+	MemoryAllocation Allocate(vk::Device device, vk::MemoryRequirements requirements, vk::MemoryPropertyFlags memoryProperties,
+							  AllocationType type = AllocationType::eLinear);
+	void Free(vk::Device device, MemoryAllocation& allocation);
+
+	// Stats
+	MemoryAllocatorStats GetStats() const;
+	void LogStats() const;
+
+	// Cleanup
+	void DestroyAllocator(vk::Device device);
+};
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "FrustumCuller.hpp"
+
+#include <cstring>
+#include <cstddef>
+
+// Has to match the start of CullData in cull.comp
+struct CullHeader
+{
+	Vec4 frustumPlanes[6];
+
+	uint32_t objectCount = 0;
+	uint32_t drawCapacity = 0;
+
+	// The objects after this are 16 byte aligned
+	uint32_t padding[2] = { 0, 0 };
+};
+static_assert(sizeof(CullHeader) == 112, "CullHeader has to be laid out exactly like it is in cull.comp");
+
+// Public
+void FrustumCuller::CreateFrustumCuller(vk::Device device, DeviceMemoryAllocator* allocator, std::vector<uint32_t> queueFamilyIndices,
+										vk::PipelineCache pipelineCache, ComputeShaderInfo shaderInfo, uint32_t capacity, bool compactDraws,
+										const IndirectDrawBuffer& drawBuffer)
+{
+	if (capacity == 0 || capacity > drawBuffer.GetCapacity())
+	{
+		throw std::runtime_error("Frustum cullers need a non-zero capacity that fits in their indirect draw buffer");
+	}
+
+	m_capacity = capacity;
+	m_compactDraws = compactDraws;
+
+	CullHeader header;
+	header.drawCapacity = drawBuffer.GetCapacity();
+
+	m_data.assign(sizeof(CullHeader) + sizeof(CullObject) * capacity, 0);
+	std::memcpy(m_data.data(), &header, sizeof(CullHeader));
+
+	m_buffer.CreateBuffer(device, allocator, m_data.size(), vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eStorageBuffer, queueFamilyIndices,
+		vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+	// Nothing is on the GPU yet, and WriteChanged only compares against what it thinks is there
+	m_dirtyRanges.MarkDirty(0, m_data.size());
+
+	// Whether to compact is baked into the shader, so the branch costs nothing
+	shaderInfo.specialisationConstants[0] = ToSpecialisationValue(compactDraws);
+	m_pipeline.CreateComputePipeline(device, pipelineCache, shaderInfo);
+
+	m_descriptorSet = m_pipeline.AllocateDescriptorSet(device, 0);
+	m_pipeline.WriteBufferDescriptor(device, m_descriptorSet, 0, 0, m_buffer.GetBuffer());
+	m_pipeline.WriteBufferDescriptor(device, m_descriptorSet, 0, 1, drawBuffer.GetBuffer());
+}
+
+void FrustumCuller::SetFrustum(const Mat4& viewProjection)
+{
+	// glm is column major, so these are the matrix's rows
+	Vec4 rows[4];
+	for (int i = 0; i < 4; i++)
+	{
+		rows[i] = Vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+	}
+
+	// Left, right, bottom, top, near and far. Near is just the z row, since Vulkan's depth starts at 0 rather than -w
+	Vec4 planes[6] = { rows[3] + rows[0], rows[3] - rows[0], rows[3] + rows[1], rows[3] - rows[1], rows[2], rows[3] - rows[2] };
+
+	// Normalised, so that testing a sphere is just comparing its signed distance with its radius
+	for (Vec4& plane : planes)
+	{
+		float length = glm::length(Vec3(plane));
+		if (length > 0) { plane /= length; }
+	}
+
+	m_dirtyRanges.WriteChanged(m_data.data(), offsetof(CullHeader, frustumPlanes), planes, sizeof(planes), sizeof(Vec4));
+}
+
+void FrustumCuller::SetObjects(const std::vector<CullObject>& objects)
+{
+	if (objects.size() > m_capacity)
+	{
+		throw std::runtime_error("Attempted to cull more objects than the frustum culler has room for");
+	}
+
+	m_objectCount = objects.size();
+
+	// Anything past the end isn't read, so it doesn't matter that it's left over from before
+	m_dirtyRanges.WriteChanged(m_data.data(), offsetof(CullHeader, objectCount), &m_objectCount, sizeof(uint32_t), sizeof(uint32_t));
+	m_dirtyRanges.WriteChanged(m_data.data(), sizeof(CullHeader), objects.data(), sizeof(CullObject) * objects.size(), sizeof(CullObject));
+}
+
+vk::DeviceSize FrustumCuller::StageDirtyRanges(StagingRing* stagingRing, std::vector<vk::BufferCopy>& copyRegions)
+{
+	return m_dirtyRanges.StageRanges(stagingRing, m_data.data(), copyRegions);
+}
+
+void FrustumCuller::RecordCulling(vk::CommandBuffer commandBuffer, const IndirectDrawBuffer& drawBuffer, uint32_t batchCount) const
+{
+	if (m_objectCount == 0) { return; }
+
+	// The previous frame might still be drawing from (or culling into) the draw buffer that we're about to overwrite
+	vk::MemoryBarrier2 beforeCullingBarrier(
+		vk::PipelineStageFlagBits2::eDrawIndirect | vk::PipelineStageFlagBits2::eComputeShader,		//srcStageMask
+		vk::AccessFlagBits2::eShaderWrite,															//srcAccessMask
+		vk::PipelineStageFlagBits2::eClear | vk::PipelineStageFlagBits2::eComputeShader,			//dstStageMask
+		vk::AccessFlagBits2::eTransferWrite | vk::AccessFlagBits2::eShaderRead |
+			vk::AccessFlagBits2::eShaderWrite														//dstAccessMask
+	);
+
+	vk::DependencyInfo beforeCullingDependency(
+		{},							//dependencyFlags
+		1,							//memoryBarrierCount
+		&beforeCullingBarrier,		//pMemoryBarriers
+		0,							//bufferMemoryBarrierCount
+		nullptr,					//pBufferMemoryBarriers
+		0,							//imageMemoryBarrierCount
+		nullptr						//pImageMemoryBarriers
+	);
+	commandBuffer.pipelineBarrier2(beforeCullingDependency);
+
+	// Every batch counts its visible draws up from 0
+	if (m_compactDraws && batchCount > 0)
+	{
+		commandBuffer.fillBuffer(drawBuffer.GetBuffer(), drawBuffer.GetDrawCountOffset(0), sizeof(uint32_t) * batchCount, 0);
+
+		vk::MemoryBarrier2 clearBarrier(
+			vk::PipelineStageFlagBits2::eClear,											//srcStageMask
+			vk::AccessFlagBits2::eTransferWrite,										//srcAccessMask
+			vk::PipelineStageFlagBits2::eComputeShader,									//dstStageMask
+			vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eShaderWrite		//dstAccessMask
+		);
+
+		vk::DependencyInfo clearDependency(
+			{},					//dependencyFlags
+			1,					//memoryBarrierCount
+			&clearBarrier,		//pMemoryBarriers
+			0,					//bufferMemoryBarrierCount
+			nullptr,			//pBufferMemoryBarriers
+			0,					//imageMemoryBarrierCount
+			nullptr				//pImageMemoryBarriers
+		);
+		commandBuffer.pipelineBarrier2(clearDependency);
+	}
+
+	m_pipeline.RecordBind(commandBuffer, { m_descriptorSet });
+	m_pipeline.RecordDispatchForItems(commandBuffer, m_objectCount);
+
+	vk::MemoryBarrier2 afterCullingBarrier(
+		vk::PipelineStageFlagBits2::eComputeShader,		//srcStageMask
+		vk::AccessFlagBits2::eShaderWrite,				//srcAccessMask
+		vk::PipelineStageFlagBits2::eDrawIndirect,		//dstStageMask
+		vk::AccessFlagBits2::eIndirectCommandRead		//dstAccessMask
+	);
+
+	vk::DependencyInfo afterCullingDependency(
+		{},							//dependencyFlags
+		1,							//memoryBarrierCount
+		&afterCullingBarrier,		//pMemoryBarriers
+		0,							//bufferMemoryBarrierCount
+		nullptr,					//pBufferMemoryBarriers
+		0,							//imageMemoryBarrierCount
+		nullptr						//pImageMemoryBarriers
+	);
+	commandBuffer.pipelineBarrier2(afterCullingDependency);
+}
+
+void FrustumCuller::DestroyFrustumCuller(vk::Device device, DeviceMemoryAllocator* allocator)
+{
+	if (!IsCreated()) { return; }
+
+	m_pipeline.DestroyComputePipeline(device);
+	m_buffer.DestroyBuffer(device, allocator);
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vector>
+
+#include "Utility/VulkanDynamicInclude.hpp"
+#include "Utility/VulPEXMaths.hpp"
+
+#include "BufferWrapper.hpp"
+#include "GeometryBuffer.hpp"
+#include "IndirectDrawBuffer.hpp"
+#include "ComputePipelineWrapper.hpp"
+#include "StagingRing.hpp"
+#include "DeviceMemoryAllocator.hpp"
+
+// Everything the culling shader needs to know about one object. Has to match CullObject in cull.comp
+struct CullObject
+{
+	// xyz is the centre and w is the radius, both in the same space as the frustum. A negative radius means it's never culled
+	Vec4 boundingSphere = Vec4(0, 0, 0, -1);
+
+	uint32_t indexCount = 0;
+	uint32_t firstIndex = 0;
+	int32_t vertexOffset = 0;
+
+	// When compacting, visible objects are packed into their batch's draws starting at batchFirstDraw
+	// Otherwise every object keeps its own draw at drawIndex, and culled ones just draw no instances
+	uint32_t drawIndex = 0;
+	uint32_t batchIndex = 0;
+	uint32_t batchFirstDraw = 0;
+
+	// Copied straight into the draw, so that each object still finds its own instance data
+	uint32_t firstInstance = 0;
+
+	uint32_t padding = 0;
+};
+static_assert(sizeof(CullObject) == 48, "CullObject has to be laid out exactly like it is in cull.comp");
+
+// Tests every object's bounding sphere against the view frustum in a compute shader, and writes the draws for whatever's visible
+// straight into an IndirectDrawBuffer, so the CPU never has to look at individual objects
+class FrustumCuller
+{
+	// Vulkan resources
+	ComputePipelineWrapper m_pipeline;
+	BufferWrapper m_buffer;
+	vk::DescriptorSet m_descriptorSet = nullptr;
+
+	// Misc resources
+	// A header with the frustum planes and counts, followed by the objects, laid out exactly like the device buffer
+	std::vector<char> m_data;
+
+	// In objects
+	uint32_t m_capacity = 0;
+	uint32_t m_objectCount = 0;
+
+	// Needs drawIndirectCount, since the number of draws in each batch is only known on the GPU
+	bool m_compactDraws = false;
+
+	DirtyRangeList m_dirtyRanges;
+
+public:
+	// drawBuffer has to outlive the culler, and capacity can't be more than its capacity
+	void CreateFrustumCuller(vk::Device device, DeviceMemoryAllocator* allocator, std::vector<uint32_t> queueFamilyIndices, vk::PipelineCache pipelineCache,
+							 ComputeShaderInfo shaderInfo, uint32_t capacity, bool compactDraws, const IndirectDrawBuffer& drawBuffer);
+
+	// Pulls the six planes out of a Vulkan-style projection (depth from 0 to 1). Pass just the projection to cull in view space
+	void SetFrustum(const Mat4& viewProjection);
+	// Throws if there are more objects than the capacity
+	void SetObjects(const std::vector<CullObject>& objects);
+
+	// Copies every dirty range into the staging ring and fills out the copies needed to get them to the device buffer
+	// If the ring runs out of space, whatever didn't fit stays dirty and is picked up next frame. Returns the number of bytes staged
+	vk::DeviceSize StageDirtyRanges(StagingRing* stagingRing, std::vector<vk::BufferCopy>& copyRegions);
+
+	// Has to be recorded outside of rendering, before anything draws from drawBuffer
+	// Includes the barriers against the previous frame's draws, and between culling and drawing
+	void RecordCulling(vk::CommandBuffer commandBuffer, const IndirectDrawBuffer& drawBuffer, uint32_t batchCount) const;
+
+	// Getters
+	vk::Buffer GetBuffer() const { return m_buffer.GetBuffer(); };
+	uint32_t GetObjectCount() const { return m_objectCount; };
+
+	// Bools
+	bool IsCreated() const { return m_capacity > 0; };
+	bool IsDirty() const { return !m_dirtyRanges.IsEmpty(); };
+	bool IsCompactingDraws() const { return m_compactDraws; };
+
+	// Cleanup
+	void DestroyFrustumCuller(vk::Device device, DeviceMemoryAllocator* allocator);
+};
\ No newline at end of file
@@ -0,0 +1,186 @@
+#include "GeometryBuffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Modules/MeshProcessing/IndexNarrowing.hpp"
+
+// DirtyRangeList
+void DirtyRangeList::MarkDirty(vk::DeviceSize offset, vk::DeviceSize size)
+{
+	if (size == 0) { return; }
+
+	vk::DeviceSize start = offset;
+	vk::DeviceSize end = offset + size;
+
+	// Skip past every range that ends before this one starts (touching counts as overlapping)
+	std::vector<std::pair<vk::DeviceSize, vk::DeviceSize>>::iterator it = m_ranges.begin();
+	while (it != m_ranges.end() && it->first + it->second < start) { it++; }
+
+	// Swallow every range that overlaps or touches this one
+	std::vector<std::pair<vk::DeviceSize, vk::DeviceSize>>::iterator firstMerged = it;
+	while (it != m_ranges.end() && it->first <= end)
+	{
+		start = std::min(start, it->first);
+		end = std::max(end, it->first + it->second);
+		it++;
+	}
+
+	it = m_ranges.erase(firstMerged, it);
+	m_ranges.insert(it, { start, end - start });
+}
+
+vk::DeviceSize DirtyRangeList::ConsumeFront(vk::DeviceSize size)
+{
+	vk::DeviceSize offset = m_ranges.front().first;
+
+	m_ranges.front().first += size;
+	m_ranges.front().second -= size;
+
+	if (m_ranges.front().second == 0) { m_ranges.erase(m_ranges.begin()); }
+
+	return offset;
+}
+
+void DirtyRangeList::Truncate(vk::DeviceSize size)
+{
+	while (!m_ranges.empty() && m_ranges.back().first >= size) { m_ranges.pop_back(); }
+
+	if (!m_ranges.empty() && m_ranges.back().first + m_ranges.back().second > size)
+	{
+		m_ranges.back().second = size - m_ranges.back().first;
+	}
+}
+
+void DirtyRangeList::WriteChanged(char* trackedData, vk::DeviceSize offset, const void* data, vk::DeviceSize size, vk::DeviceSize elementSize)
+{
+	const char* newData = (const char*)data;
+
+	for (vk::DeviceSize elementOffset = 0; elementOffset < size; elementOffset += elementSize)
+	{
+		if (std::memcmp(trackedData + offset + elementOffset, newData + elementOffset, elementSize) != 0)
+		{
+			std::memcpy(trackedData + offset + elementOffset, newData + elementOffset, elementSize);
+			MarkDirty(offset + elementOffset, elementSize);
+		}
+	}
+}
+
+vk::DeviceSize DirtyRangeList::StageRanges(StagingRing* stagingRing, const char* sourceData, std::vector<vk::BufferCopy>& copyRegions)
+{
+	vk::DeviceSize bytesStaged = 0;
+
+	while (!IsEmpty())
+	{
+		vk::DeviceSize spaceRemaining = stagingRing->GetBytesRemaining();
+		if (spaceRemaining == 0) { break; }
+
+		// Ranges that are too big for what's left of the region get split, and the remainder stays dirty for next frame
+		vk::DeviceSize size = std::min(GetFront().second, spaceRemaining);
+		vk::DeviceSize offset = ConsumeFront(size);
+
+		StagingAllocation staging = stagingRing->Allocate(size);
+		std::memcpy(staging.data, sourceData + offset, size);
+
+		vk::BufferCopy copyRegion(
+			staging.offset,	//srcOffset
+			offset,			//dstOffset
+			size			//size
+		);
+		copyRegions.push_back(copyRegion);
+
+		bytesStaged += size;
+	}
+
+	return bytesStaged;
+}
+
+// GeometryBuffer
+// Public
+void GeometryBuffer::CreateGeometryBuffer(vk::Device device, DeviceMemoryAllocator* allocator, std::vector<uint32_t> queueFamilyIndices,
+										  const void* vertexData, uint32_t sizeOfVertex, uint32_t vertexCount, std::vector<uint32_t> indices)
+{
+	if (sizeOfVertex == 0 || vertexCount == 0 || indices.empty())
+	{
+		throw std::runtime_error("Geometry needs at least one vertex and one index");
+	}
+
+	MeshProcessing::ValidateIndices(indices.data(), indices.size(), vertexCount);
+
+	m_sizeOfVertex = sizeOfVertex;
+	m_vertexData.assign((const char*)vertexData, (const char*)vertexData + sizeOfVertex * vertexCount);
+	m_indexCount = indices.size();
+	m_indexType = MeshProcessing::GetIndexType(vertexCount);
+
+	m_indexData.resize((size_t)MeshProcessing::GetIndexSize(m_indexType) * m_indexCount);
+	MeshProcessing::WriteIndices(indices.data(), m_indexData.data(), m_indexCount, m_indexType);
+
+	m_vertexBuffer.CreateBuffer(device, allocator, m_vertexData.size(), vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer, queueFamilyIndices,
+		vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+	m_indexBuffer.CreateBuffer(device, allocator, m_indexData.size(), vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer, queueFamilyIndices,
+		vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+	// Nothing is on the GPU yet, so everything starts dirty
+	m_dirtyVertexRanges.MarkDirty(0, m_vertexData.size());
+	m_dirtyIndexRanges.MarkDirty(0, m_indexData.size());
+	m_version++;
+}
+
+void GeometryBuffer::UpdateVertices(uint32_t firstVertex, const void* vertexData, uint32_t vertexCount)
+{
+	vk::DeviceSize offset = (vk::DeviceSize)firstVertex * m_sizeOfVertex;
+	vk::DeviceSize size = (vk::DeviceSize)vertexCount * m_sizeOfVertex;
+
+	if (offset + size > m_vertexData.size())
+	{
+		throw std::runtime_error("Attempted to update vertices outside of the geometry's vertex buffer");
+	}
+
+	std::memcpy(m_vertexData.data() + offset, vertexData, size);
+
+	m_dirtyVertexRanges.MarkDirty(offset, size);
+	m_version++;
+}
+
+void GeometryBuffer::UpdateIndices(uint32_t firstIndex, std::vector<uint32_t> indices)
+{
+	if (firstIndex + indices.size() > m_indexCount)
+	{
+		throw std::runtime_error("Attempted to update indices outside of the geometry's index buffer");
+	}
+
+	MeshProcessing::ValidateIndices(indices.data(), indices.size(), m_vertexData.size() / m_sizeOfVertex);
+
+	vk::DeviceSize indexSize = MeshProcessing::GetIndexSize(m_indexType);
+	MeshProcessing::WriteIndices(indices.data(), m_indexData.data() + indexSize * firstIndex, indices.size(), m_indexType);
+
+	m_dirtyIndexRanges.MarkDirty(indexSize * firstIndex, indexSize * indices.size());
+	m_version++;
+}
+
+vk::DeviceSize GeometryBuffer::StageDirtyRanges(StagingRing* stagingRing, std::vector<vk::BufferCopy>& vertexCopies,
+												std::vector<vk::BufferCopy>& indexCopies)
+{
+	vk::DeviceSize bytesStaged = 0;
+
+	bytesStaged += m_dirtyVertexRanges.StageRanges(stagingRing, m_vertexData.data(), vertexCopies);
+	bytesStaged += m_dirtyIndexRanges.StageRanges(stagingRing, m_indexData.data(), indexCopies);
+
+	return bytesStaged;
+}
+
+bool GeometryBuffer::UpdateResidency(vk::Device device, const TransferQueueWrapper* transferQueue)
+{
+	if (m_isResident || IsDirty() || !m_uploadTicket.has_value()) { return false; }
+
+	m_isResident = transferQueue->IsComplete(device, m_uploadTicket.value());
+
+	return m_isResident;
+}
+
+void GeometryBuffer::DestroyGeometryBuffer(vk::Device device, DeviceMemoryAllocator* allocator)
+{
+	m_indexBuffer.DestroyBuffer(device, allocator);
+	m_vertexBuffer.DestroyBuffer(device, allocator);
+}
\ No newline at end of file
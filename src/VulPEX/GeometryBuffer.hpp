@@ -0,0 +1,106 @@
+#pragma once
+
+#include <vector>
+#include <optional>
+
+#include "Utility/VulkanDynamicInclude.hpp"
+
+#include "BufferWrapper.hpp"
+#include "StagingRing.hpp"
+#include "DeviceMemoryAllocator.hpp"
+#include "TransferQueueWrapper.hpp"
+
+// A sorted list of byte ranges that have changed since they were last uploaded
+// Overlapping and touching ranges are merged, so each byte is only ever uploaded once
+class DirtyRangeList
+{
+	// offset, size
+	std::vector<std::pair<vk::DeviceSize, vk::DeviceSize>> m_ranges;
+
+public:
+	void MarkDirty(vk::DeviceSize offset, vk::DeviceSize size);
+
+	// Removes the first size bytes of the first range, and returns the offset they started at
+	vk::DeviceSize ConsumeFront(vk::DeviceSize size);
+
+	// Drops everything from size onwards, for when the data being tracked gets shorter
+	void Truncate(vk::DeviceSize size);
+
+	// Copies size bytes of data into trackedData at offset, one elementSize element at a time, and only marks the elements that
+	// actually changed as dirty. trackedData is the CPU copy of the buffer these ranges belong to
+	void WriteChanged(char* trackedData, vk::DeviceSize offset, const void* data, vk::DeviceSize size, vk::DeviceSize elementSize);
+
+	// Copies as many dirty bytes of sourceData as will fit into the staging ring, and fills out the copies needed to get them to the device buffer
+	// Whatever didn't fit stays dirty. Returns the number of bytes staged
+	vk::DeviceSize StageRanges(StagingRing* stagingRing, const char* sourceData, std::vector<vk::BufferCopy>& copyRegions);
+
+	// Getters
+	std::pair<vk::DeviceSize, vk::DeviceSize> GetFront() const { return m_ranges.front(); };
+
+	// Bools
+	bool IsEmpty() const { return m_ranges.empty(); };
+};
+
+// One mesh's vertex and index buffers, along with a CPU-side copy of their contents
+// Edits only mark the bytes they touch as dirty, so unchanged geometry costs nothing to keep on the GPU
+class GeometryBuffer
+{
+	// Vulkan resources
+	BufferWrapper m_vertexBuffer;
+	BufferWrapper m_indexBuffer;
+
+	// Misc resources
+	std::vector<char> m_vertexData;
+	// Already in m_indexType, exactly as the device buffer holds it
+	std::vector<char> m_indexData;
+
+	uint32_t m_sizeOfVertex = 0;
+	uint32_t m_indexCount = 0;
+	vk::IndexType m_indexType = vk::IndexType::eUint32;
+
+	DirtyRangeList m_dirtyVertexRanges;
+	DirtyRangeList m_dirtyIndexRanges;
+
+	// Incremented on every edit, so that callers can cheaply tell whether anything has changed
+	uint64_t m_version = 0;
+
+	// A staging ring that overflows leaves the rest of the first upload for later frames, so geometry isn't drawn until
+	// the transfer carrying its last initial bytes has completed
+	std::optional<TransferTicket> m_uploadTicket;
+	bool m_isResident = false;
+
+public:
+	// Indices are stored as 16-bit whenever there are few enough vertices for them to fit
+	// Empty geometry is rejected, since Vulkan doesn't allow zero-sized buffers, and so are indices past the last vertex
+	void CreateGeometryBuffer(vk::Device device, DeviceMemoryAllocator* allocator, std::vector<uint32_t> queueFamilyIndices,
+							  const void* vertexData, uint32_t sizeOfVertex, uint32_t vertexCount, std::vector<uint32_t> indices);
+
+	void UpdateVertices(uint32_t firstVertex, const void* vertexData, uint32_t vertexCount);
+	// Throws if any of the indices are past the last vertex
+	void UpdateIndices(uint32_t firstIndex, std::vector<uint32_t> indices);
+
+	// Copies every dirty range into the staging ring and fills out the copies needed to get them to the device buffers
+	// If the ring runs out of space, whatever didn't fit stays dirty and is picked up next frame. Returns the number of bytes staged
+	vk::DeviceSize StageDirtyRanges(StagingRing* stagingRing, std::vector<vk::BufferCopy>& vertexCopies, std::vector<vk::BufferCopy>& indexCopies);
+
+	// Called with the ticket of the transfer that staged the last dirty bytes, for as long as the geometry isn't resident yet
+	void SetUploadTicket(TransferTicket ticket) { m_uploadTicket = ticket; };
+	// Returns true the first time the geometry becomes resident, so that the caller knows its draws need recording
+	bool UpdateResidency(vk::Device device, const TransferQueueWrapper* transferQueue);
+
+	// Getters
+	vk::Buffer GetVertexBuffer() const { return m_vertexBuffer.GetBuffer(); };
+	vk::Buffer GetIndexBuffer() const { return m_indexBuffer.GetBuffer(); };
+
+	uint32_t GetIndexCount() const { return m_indexCount; };
+	vk::IndexType GetIndexType() const { return m_indexType; };
+	uint64_t GetVersion() const { return m_version; };
+
+	// Bools
+	bool IsDirty() const { return !m_dirtyVertexRanges.IsEmpty() || !m_dirtyIndexRanges.IsEmpty(); };
+	// Whether the first upload has fully landed on the device. Later edits don't affect this
+	bool IsResident() const { return m_isResident; };
+
+	// Cleanup
+	void DestroyGeometryBuffer(vk::Device device, DeviceMemoryAllocator* allocator);
+};
\ No newline at end of file
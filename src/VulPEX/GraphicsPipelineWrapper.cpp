@@ -1,5 +1,47 @@
 #include "GraphicsPipelineWrapper.hpp"
 
+#include <chrono>
+#include <algorithm>
+
+#include <Logger.hpp>
+
+// Regular blending method
+// Additive blending keeps the source alpha factor, so that faded-out things still add less
+static vk::ColorBlendEquationEXT GetColourBlendEquation(BlendMode blendMode)
+{
+	return vk::ColorBlendEquationEXT(
+		vk::BlendFactor::eSrcAlpha,											//srcColorBlendFactor
+		blendMode == BlendMode::eAdditive ?
+			vk::BlendFactor::eOne : vk::BlendFactor::eOneMinusSrcAlpha,		//dstColorBlendFactor
+		vk::BlendOp::eAdd,													//colorBlendOp
+		vk::BlendFactor::eOne,												//srcAlphaBlendFactor
+		vk::BlendFactor::eZero,												//dstAlphaBlendFactor
+		vk::BlendOp::eAdd													//alphaBlendOp
+	);
+}
+
+// Without unrestricted dynamic topology, the pipeline's topology only has to be in the same class as whatever's set while recording
+static vk::PrimitiveTopology GetTopologyClass(vk::PrimitiveTopology topology)
+{
+	switch (topology)
+	{
+		case vk::PrimitiveTopology::ePointList:
+			return vk::PrimitiveTopology::ePointList;
+
+		case vk::PrimitiveTopology::eLineList:
+		case vk::PrimitiveTopology::eLineStrip:
+		case vk::PrimitiveTopology::eLineListWithAdjacency:
+		case vk::PrimitiveTopology::eLineStripWithAdjacency:
+			return vk::PrimitiveTopology::eLineList;
+
+		case vk::PrimitiveTopology::ePatchList:
+			return vk::PrimitiveTopology::ePatchList;
+
+		default:
+			return vk::PrimitiveTopology::eTriangleList;
+	}
+}
+
 // Private
 vk::ShaderModule GraphicsPipelineWrapper::CreateShaderModule(vk::Device device, std::vector<char> bytecode)
 {
@@ -62,80 +104,308 @@ void GraphicsPipelineWrapper::CreateRenderPass(vk::Device device, vk::Format ima
 	m_renderPass = device.createRenderPass(renderPassInfo);
 }
 
-// Public
-void GraphicsPipelineWrapper::CreateGraphicsPipeline(vk::Device device, ShaderInfo shaderInfo, vk::Extent2D scExtent, vk::Format imageFormat, uint32_t sizeOfVertex,
-													 std::pair<vk::Format, uint32_t>* vertexVarsInfo, size_t vertexVarsInfoCount)
+vk::DescriptorSetLayout GraphicsPipelineWrapper::GetOrCreateSetLayout(vk::Device device, const std::vector<Reflection::DescriptorBinding>& bindings)
+{
+	std::vector<uint32_t> key;
+	for (const Reflection::DescriptorBinding& binding : bindings)
+	{
+		key.insert(key.end(), { binding.binding, (uint32_t)binding.type, binding.count, (uint32_t)binding.stages });
+	}
+
+	std::map<std::vector<uint32_t>, vk::DescriptorSetLayout>::iterator it = m_setLayouts.find(key);
+	if (it != m_setLayouts.end()) { return it->second; }
+
+	std::vector<vk::DescriptorSetLayoutBinding> layoutBindings;
+	for (const Reflection::DescriptorBinding& binding : bindings)
+	{
+		vk::DescriptorSetLayoutBinding layoutBinding(
+			binding.binding,	//binding
+			binding.type,		//descriptorType
+			binding.count,		//descriptorCount
+			binding.stages,		//stageFlags
+			nullptr				//pImmutableSamplers
+		);
+
+		layoutBindings.push_back(layoutBinding);
+	}
+
+	vk::DescriptorSetLayoutCreateInfo setLayoutInfo(
+		{},									//flags
+		(uint32_t)layoutBindings.size(),	//bindingCount
+		layoutBindings.data()				//pBindings
+	);
+
+	vk::DescriptorSetLayout setLayout = device.createDescriptorSetLayout(setLayoutInfo);
+	m_setLayouts.emplace(key, setLayout);
+
+	return setLayout;
+}
+
+vk::PipelineLayout GraphicsPipelineWrapper::GetOrCreatePipelineLayout(vk::Device device, const Reflection::ShaderReflection& vertReflection,
+																	  const Reflection::ShaderReflection& fragReflection)
+{
+	// Both stages can use the same binding, in which case it only goes in the set layout once
+	std::map<std::pair<uint32_t, uint32_t>, Reflection::DescriptorBinding> mergedBindings;
+	for (const Reflection::ShaderReflection* reflection : { &vertReflection, &fragReflection })
+	{
+		for (const Reflection::DescriptorBinding& binding : reflection->descriptorBindings)
+		{
+			std::pair<std::map<std::pair<uint32_t, uint32_t>, Reflection::DescriptorBinding>::iterator, bool> inserted =
+				mergedBindings.emplace(std::make_pair(binding.set, binding.binding), binding);
+			if (inserted.second) { continue; }
+
+			Reflection::DescriptorBinding& existing = inserted.first->second;
+			if (existing.type != binding.type || existing.count != binding.count)
+			{
+				throw std::runtime_error("Shader stages disagree about what's in set " + std::to_string(binding.set) +
+										 ", binding " + std::to_string(binding.binding));
+			}
+
+			existing.stages |= binding.stages;
+		}
+	}
+
+	// Sets have to be contiguous, so any gaps are filled with empty ones
+	uint32_t setCount = mergedBindings.empty() ? 0 : mergedBindings.rbegin()->first.first + 1;
+	std::vector<std::vector<Reflection::DescriptorBinding>> sets(setCount);
+	for (const std::pair<const std::pair<uint32_t, uint32_t>, Reflection::DescriptorBinding>& binding : mergedBindings)
+	{
+		sets[binding.first.first].push_back(binding.second);
+	}
+
+	std::vector<vk::PushConstantRange> pushConstantRanges;
+	for (const Reflection::ShaderReflection* reflection : { &vertReflection, &fragReflection })
+	{
+		if (reflection->pushConstantRange.size > 0) { pushConstantRanges.push_back(reflection->pushConstantRange); }
+	}
+
+	std::vector<uint32_t> key;
+	for (const std::vector<Reflection::DescriptorBinding>& set : sets)
+	{
+		key.push_back((uint32_t)set.size());
+		for (const Reflection::DescriptorBinding& binding : set)
+		{
+			key.insert(key.end(), { binding.binding, (uint32_t)binding.type, binding.count, (uint32_t)binding.stages });
+		}
+	}
+	for (const vk::PushConstantRange& range : pushConstantRanges)
+	{
+		key.insert(key.end(), { (uint32_t)range.stageFlags, range.offset, range.size });
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::map<std::vector<uint32_t>, vk::PipelineLayout>::iterator it = m_pipelineLayouts.find(key);
+	if (it != m_pipelineLayouts.end()) { return it->second; }
+
+	std::vector<vk::DescriptorSetLayout> setLayouts;
+	for (const std::vector<Reflection::DescriptorBinding>& set : sets)
+	{
+		setLayouts.push_back(GetOrCreateSetLayout(device, set));
+	}
+
+	vk::PipelineLayoutCreateInfo pipelineLayoutInfo(
+		{},										//flags
+		(uint32_t)setLayouts.size(),			//setLayoutCount
+		setLayouts.data(),						//pSetLayouts
+		(uint32_t)pushConstantRanges.size(),	//pushConstantRangeCount
+		pushConstantRanges.data()				//pPushConstantRanges
+	);
+
+	vk::PipelineLayout pipelineLayout = device.createPipelineLayout(pipelineLayoutInfo);
+	m_pipelineLayouts.emplace(key, pipelineLayout);
+	m_stats.pipelineLayoutCount = m_pipelineLayouts.size();
+
+	return pipelineLayout;
+}
+
+PipelineStateDescription GraphicsPipelineWrapper::GetPipelineKey(const PipelineStateDescription& state) const
 {
-	CreateRenderPass(device, imageFormat);
+	PipelineStateDescription key = state;
+	if (!m_dynamicStateSupport.enabled) { return key; }
+
+	DynamicRenderState defaults;
+
+	key.topology = m_dynamicStateSupport.unrestrictedTopology ? defaults.topology : GetTopologyClass(state.topology);
+	key.primitiveRestartEnable = defaults.primitiveRestartEnable;
+	key.cullMode = defaults.cullMode;
+	key.frontFace = defaults.frontFace;
+
+	if (m_dynamicStateSupport.polygonMode) { key.polygonMode = defaults.polygonMode; }
+	if (m_dynamicStateSupport.colourBlend) { key.blendMode = defaults.blendMode; }
+
+	return key;
+}
+
+PipelineSlot GraphicsPipelineWrapper::BuildPipeline(vk::Device device, const PipelineStateDescription& state, vk::PipelineCreateFlags flags)
+{
+	// Only one subpass, which isn't multisampled
+	if (state.rasterisationSamples != vk::SampleCountFlagBits::e1)
+	{
+		throw std::runtime_error("Multisampled pipelines need a multisampled render pass, which isn't supported yet");
+	}
+
+	const ShaderInfo& shaderInfo = state.shaderInfo;
+
+	Reflection::ShaderReflection vertReflection = m_reflectionCache.GetReflection(shaderInfo.vertBytecode, shaderInfo.vertEntryPoint);
+	Reflection::ShaderReflection fragReflection = m_reflectionCache.GetReflection(shaderInfo.fragBytecode, shaderInfo.fragEntryPoint);
+
+	vk::PipelineLayout pipelineLayout = GetOrCreatePipelineLayout(device, vertReflection, fragReflection);
 
 	vk::ShaderModule vertShaderModule = CreateShaderModule(device, shaderInfo.vertBytecode);
 	vk::ShaderModule fragShaderModule = CreateShaderModule(device, shaderInfo.fragBytecode);
 
+	std::vector<vk::SpecializationMapEntry> vertMapEntries, fragMapEntries;
+	std::vector<uint32_t> vertSpecialisationData, fragSpecialisationData;
+	vk::SpecializationInfo vertSpecialisationInfo = GetSpecialisationInfo(shaderInfo.vertSpecialisationConstants, vertMapEntries, vertSpecialisationData);
+	vk::SpecializationInfo fragSpecialisationInfo = GetSpecialisationInfo(shaderInfo.fragSpecialisationConstants, fragMapEntries, fragSpecialisationData);
+
 	vk::PipelineShaderStageCreateInfo vertShaderStageInfo(
-		{},									//flags
-		vk::ShaderStageFlagBits::eVertex,	//stage
-		vertShaderModule,					//module
-		"main"								//pName
+		{},															//flags
+		vk::ShaderStageFlagBits::eVertex,							//stage
+		vertShaderModule,											//module
+		shaderInfo.vertEntryPoint.c_str(),							//pName
+		vertMapEntries.empty() ? nullptr : &vertSpecialisationInfo	//pSpecializationInfo
 	);
 
 	vk::PipelineShaderStageCreateInfo fragShaderStageInfo(
-		{},									//flags
-		vk::ShaderStageFlagBits::eFragment,	//stage
-		fragShaderModule,					//module
-		"main"								//pName
+		{},															//flags
+		vk::ShaderStageFlagBits::eFragment,							//stage
+		fragShaderModule,											//module
+		shaderInfo.fragEntryPoint.c_str(),							//pName
+		fragMapEntries.empty() ? nullptr : &fragSpecialisationInfo	//pSpecializationInfo
 	);
 
 	vk::PipelineShaderStageCreateInfo shaderStageInfos[] = { vertShaderStageInfo, fragShaderStageInfo };
 
-	vk::VertexInputBindingDescription inputBindingDescription(
-		0,								//binding
-		sizeOfVertex,					//stride
-		vk::VertexInputRate::eVertex	//inputRate
-	);
-
+	// Per-instance attributes come after the per-vertex ones, and are read from binding 1
 	std::vector<vk::VertexInputAttributeDescription> inputAttributeDescriptions;
-	for (int i = 0; i < vertexVarsInfoCount; i++)
+	std::vector<uint32_t> instanceLocations;
+	uint32_t stride = state.sizeOfVertex;
+	if (state.vertexVarsInfo.empty())
+	{
+		if (state.instanceVarsInfo.size() > vertReflection.inputs.size())
+		{
+			throw std::runtime_error("More instance attributes were given than the vertex shader has inputs");
+		}
+
+		// Nothing given, so pack whatever the shader reads tightly in location order
+		// The last few locations are the instance attributes, which are always given
+		size_t vertexInputCount = vertReflection.inputs.size() - state.instanceVarsInfo.size();
+
+		uint32_t offset = 0;
+		for (size_t i = 0; i < vertexInputCount; i++)
+		{
+			const Reflection::ShaderInputVariable& input = vertReflection.inputs[i];
+
+			vk::VertexInputAttributeDescription vertInputAttribDesc(
+				input.location,	//location
+				0,				//binding
+				input.format,	//format
+				offset			//offset
+			);
+
+			inputAttributeDescriptions.push_back(vertInputAttribDesc);
+			offset += input.size;
+		}
+
+		if (stride == 0) { stride = offset; }
+
+		for (size_t i = vertexInputCount; i < vertReflection.inputs.size(); i++)
+		{
+			instanceLocations.push_back(vertReflection.inputs[i].location);
+		}
+	}
+	else
+	{
+		for (int i = 0; i < state.vertexVarsInfo.size(); i++)
+		{
+			vk::VertexInputAttributeDescription vertInputAttribDesc(
+				i,								//location
+				0,								//binding
+				state.vertexVarsInfo[i].first,	//format
+				state.vertexVarsInfo[i].second	//offset
+			);
+
+			inputAttributeDescriptions.push_back(vertInputAttribDesc);
+		}
+
+		for (size_t i = 0; i < state.instanceVarsInfo.size(); i++)
+		{
+			instanceLocations.push_back(state.vertexVarsInfo.size() + i);
+		}
+
+		// Extra attributes are fine, but every input the shader reads has to be fed by one
+		size_t attributeCount = state.vertexVarsInfo.size() + state.instanceVarsInfo.size();
+		for (const Reflection::ShaderInputVariable& input : vertReflection.inputs)
+		{
+			if (input.location >= attributeCount)
+			{
+				throw std::runtime_error("Vertex shader reads location " + std::to_string(input.location) + ", but only " +
+										 std::to_string(attributeCount) + " vertex and instance attributes were given");
+			}
+		}
+	}
+
+	for (size_t i = 0; i < state.instanceVarsInfo.size(); i++)
 	{
-		vk::VertexInputAttributeDescription vertInputAttribDesc(
-			i,							//location
-			0,							//binding
-			vertexVarsInfo[i].first,	//format
-			vertexVarsInfo[i].second	//offset
+		vk::VertexInputAttributeDescription instanceInputAttribDesc(
+			instanceLocations[i],				//location
+			1,									//binding
+			state.instanceVarsInfo[i].first,	//format
+			state.instanceVarsInfo[i].second	//offset
 		);
 
-		inputAttributeDescriptions.push_back(vertInputAttribDesc);
+		inputAttributeDescriptions.push_back(instanceInputAttribDesc);
+	}
+
+	if (!state.instanceVarsInfo.empty() && state.sizeOfInstance == 0)
+	{
+		throw std::runtime_error("Instance attributes were given without the size of an instance");
+	}
+
+	std::vector<vk::VertexInputBindingDescription> inputBindingDescriptions;
+	inputBindingDescriptions.push_back(vk::VertexInputBindingDescription(
+		0,								//binding
+		stride,							//stride
+		vk::VertexInputRate::eVertex	//inputRate
+	));
+
+	if (!state.instanceVarsInfo.empty())
+	{
+		inputBindingDescriptions.push_back(vk::VertexInputBindingDescription(
+			1,								//binding
+			state.sizeOfInstance,			//stride
+			vk::VertexInputRate::eInstance	//inputRate
+		));
 	}
 
 	vk::PipelineVertexInputStateCreateInfo vertInputStateInfo(
 		{},										//flags
-		1,										//vertexBindingDescriptionCount
-		&inputBindingDescription,				//pVertexBindingDescriptions
+		inputBindingDescriptions.size(),		//vertexBindingDescriptionCount
+		inputBindingDescriptions.data(),		//pVertexBindingDescriptions
 		inputAttributeDescriptions.size(),		//vertexAttributeDescriptionCount
 		inputAttributeDescriptions.data()		//pVertexAttributeDescriptions
 	);
 
-	// TODO: Make this customisable - tells the renderer what geometry to render, and whether we're reusing vertices or not
+	// Tells the renderer what geometry to render, and whether we're reusing vertices or not
 	vk::PipelineInputAssemblyStateCreateInfo inputAssemblyStateInfo(
 		{},										//flags
-		vk::PrimitiveTopology::eTriangleList,	//topology
-		vk::False								//primitiveRestartEnable
-	);
-
-	vk::Viewport viewport(
-		0,					//x
-		0,					//y
-		scExtent.width,		//width
-		scExtent.height,	//height
-		0,					//minDepth
-		1					//maxDepth
-	);
-
-	vk::Rect2D scissorRect(
-		{0, 0},		//offset
-		scExtent	//extent
+		state.topology,							//topology
+		state.primitiveRestartEnable			//primitiveRestartEnable
 	);
 
 	std::vector<vk::DynamicState> dynamicStates = { vk::DynamicState::eViewport, vk::DynamicState::eScissor };
+	if (m_dynamicStateSupport.enabled)
+	{
+		dynamicStates.insert(dynamicStates.end(), { vk::DynamicState::ePrimitiveTopology, vk::DynamicState::ePrimitiveRestartEnable,
+													vk::DynamicState::eCullMode, vk::DynamicState::eFrontFace });
+	}
+	if (m_dynamicStateSupport.polygonMode) { dynamicStates.push_back(vk::DynamicState::ePolygonModeEXT); }
+	if (m_dynamicStateSupport.colourBlend)
+	{
+		dynamicStates.insert(dynamicStates.end(), { vk::DynamicState::eColorBlendEnableEXT, vk::DynamicState::eColorBlendEquationEXT });
+	}
 	vk::PipelineDynamicStateCreateInfo dynamicStateInfo(
 		{},								//flags
 		(uint32_t)dynamicStates.size(),	//dynamicStateCount
@@ -150,26 +420,24 @@ void GraphicsPipelineWrapper::CreateGraphicsPipeline(vk::Device device, ShaderIn
 		nullptr		//pScissors | As with pViewports, but for scissor rects instead
 	);
 
-	// TODO: Another reminder that pretty much everything in here should be customisable at some point
-	// Almost all of these require certain GPU features to be enabled
+	// Non-fill polygon modes and wide lines need their GPU features enabled
 	vk::PipelineRasterizationStateCreateInfo rasterisationStateInfo(
 		{},								//flags
         vk::False,						//depthClampEnable
         vk::False,						//rasterizerDiscardEnable
-		vk::PolygonMode::eFill,			//polygonMode
-		vk::CullModeFlagBits::eBack,	//cullMode
-		vk::FrontFace::eClockwise,		//frontFace
+		state.polygonMode,				//polygonMode
+		state.cullMode,					//cullMode
+		state.frontFace,				//frontFace
 		vk::False,						//depthBiasEnable
 		0,								//depthBiasConstantFactor
 		0,								//depthBiasClamp
 		0,								//depthBiasSlopeFactor
-		1								//lineWidth
+		state.lineWidth					//lineWidth
 	);
 
-	// TODO: Look into this at a later date
 	vk::PipelineMultisampleStateCreateInfo multisampleStateInfo(
 		{},								//flags
-		vk::SampleCountFlagBits::e1,	//rasterizationSamples
+		state.rasterisationSamples,		//rasterizationSamples
 		vk::False,						//sampleShadingEnable
 		1,								//minSampleShading
 		nullptr,						//pSampleMask
@@ -177,16 +445,15 @@ void GraphicsPipelineWrapper::CreateGraphicsPipeline(vk::Device device, ShaderIn
 		vk::False						//alphaToOneEnable
 	);
 
-	// TODO: Proper blending stuff, more config
-	// Regular blending method
+	vk::ColorBlendEquationEXT blendEquation = GetColourBlendEquation(state.blendMode);
 	vk::PipelineColorBlendAttachmentState colourBlendAttachmentState(
-		vk::True,															//blendEnable
-		vk::BlendFactor::eSrcAlpha,											//srcColorBlendFactor
-		vk::BlendFactor::eOneMinusSrcAlpha,									//dstColorBlendFactor
-		vk::BlendOp::eAdd,													//colorBlendOp
-		vk::BlendFactor::eOne,												//srcAlphaBlendFactor
-		vk::BlendFactor::eZero,												//dstAlphaBlendFactor
-		vk::BlendOp::eAdd,													//alphaBlendOp
+		state.blendMode != BlendMode::eOpaque,								//blendEnable
+		blendEquation.srcColorBlendFactor,									//srcColorBlendFactor
+		blendEquation.dstColorBlendFactor,									//dstColorBlendFactor
+		blendEquation.colorBlendOp,											//colorBlendOp
+		blendEquation.srcAlphaBlendFactor,									//srcAlphaBlendFactor
+		blendEquation.dstAlphaBlendFactor,									//dstAlphaBlendFactor
+		blendEquation.alphaBlendOp,											//alphaBlendOp
 		vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
 		vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA		//colorWriteMask
 	);
@@ -201,19 +468,17 @@ void GraphicsPipelineWrapper::CreateGraphicsPipeline(vk::Device device, ShaderIn
 		{0, 0, 0, 0}					//blendConstants
 	);
 
-	// TODO: Empty for now, make this properly later
-	vk::PipelineLayoutCreateInfo pipelineLayoutInfo(
-		{},			//flags
-		0,			//setLayoutCount
-		nullptr,	//pSetLayouts
-		0,			//pushConstantRangeCount
-		nullptr		//pPushConstantRanges
+	// Only read when there's no render pass
+	vk::PipelineRenderingCreateInfo renderingInfo(
+		0,						//viewMask
+		1,						//colorAttachmentCount
+		&m_colourFormat,		//pColorAttachmentFormats
+		vk::Format::eUndefined,	//depthAttachmentFormat
+		vk::Format::eUndefined	//stencilAttachmentFormat
 	);
 
-	m_pipelineLayout = device.createPipelineLayout(pipelineLayoutInfo);
-
 	vk::GraphicsPipelineCreateInfo pipelineInfo(
-		{},							//flags
+		flags,						//flags
 		2,							//stageCount
 		shaderStageInfos,			//pStages
 		&vertInputStateInfo,		//pVertexInputState
@@ -225,27 +490,279 @@ void GraphicsPipelineWrapper::CreateGraphicsPipeline(vk::Device device, ShaderIn
 		nullptr,					//pDepthStencilState
 		&colourBlendStateInfo,		//pColorBlendState
 		&dynamicStateInfo,			//pDynamicState
-		m_pipelineLayout,			//layout
+		pipelineLayout,				//layout
 		m_renderPass,				//renderPass
 		0,							//subpass
 		nullptr,					//basePipelineHandle
 		-1							//basePipelineIndex
 	);
 
+	if (m_useDynamicRendering) { pipelineInfo.pNext = &renderingInfo; }
+
+	std::chrono::steady_clock::time_point creationStart = std::chrono::steady_clock::now();
+
 	vk::Result result;
-	std::tie(result, m_graphicsPipeline) = device.createGraphicsPipeline(nullptr, pipelineInfo);
+	vk::Pipeline pipeline;
+	std::tie(result, pipeline) = device.createGraphicsPipeline(m_pipelineCache, pipelineInfo);
+
+	double creationTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - creationStart).count();
+
+	device.destroyShaderModule(vertShaderModule);
+	device.destroyShaderModule(fragShaderModule);
+
 	if (result == vk::Result::ePipelineCompileRequired)
 	{
+		// Only a failure if we didn't ask for it
+		if (flags & vk::PipelineCreateFlagBits::eFailOnPipelineCompileRequired) { return { nullptr, pipelineLayout, PipelineStatus::ePending }; }
+
 		throw std::runtime_error("Creation of graphics pipeline failed with error code: " + std::to_string((int)result));
 	}
 
-	device.destroyShaderModule(vertShaderModule);
-	device.destroyShaderModule(fragShaderModule);
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_stats.totalCreationTimeMs += creationTimeMs;
+	m_stats.slowestCreationTimeMs = std::max(m_stats.slowestCreationTimeMs, creationTimeMs);
+
+	return { pipeline, pipelineLayout, PipelineStatus::eReady };
+}
+
+void GraphicsPipelineWrapper::FinishBuild(PipelineHandle handle, PipelineSlot slot)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_pipelines[handle] = slot;
+
+	if (slot.status == PipelineStatus::eFailed) { m_stats.failedBuilds++; }
+}
+
+// Public
+void GraphicsPipelineWrapper::CreateGraphicsPipeline(vk::Device device, vk::PipelineCache pipelineCache, Threading::JobSystem* jobSystem,
+													 ShaderInfo shaderInfo, vk::Format imageFormat, uint32_t sizeOfVertex,
+													 std::pair<vk::Format, uint32_t>* vertexVarsInfo, size_t vertexVarsInfoCount)
+{
+	m_pipelineCache = pipelineCache;
+	m_jobSystem = jobSystem;
+	m_colourFormat = imageFormat;
+
+	if (!m_useDynamicRendering) { CreateRenderPass(device, imageFormat); }
+
+	m_defaultState.shaderInfo = shaderInfo;
+	m_defaultState.sizeOfVertex = sizeOfVertex;
+	m_defaultState.vertexVarsInfo.assign(vertexVarsInfo, vertexVarsInfo + vertexVarsInfoCount);
+
+	double previousCreationTimeMs = GetStats().totalCreationTimeMs;
+	m_graphicsPipeline = GetOrCreatePipeline(device, m_defaultState);
+	m_creationTimeMs = GetStats().totalCreationTimeMs - previousCreationTimeMs;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_graphicsPipelineLayout = m_pipelines[m_handles.at(GetPipelineKey(m_defaultState))].layout;
+}
+
+vk::Pipeline GraphicsPipelineWrapper::GetOrCreatePipeline(vk::Device device, const PipelineStateDescription& requestedState)
+{
+	PipelineStateDescription state = GetPipelineKey(requestedState);
+
+	PipelineHandle handle;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		std::unordered_map<PipelineStateDescription, PipelineHandle, PipelineStateHasher>::iterator it = m_handles.find(state);
+		if (it != m_handles.end())
+		{
+			m_stats.hits++;
+			handle = it->second;
+		}
+		else
+		{
+			m_stats.misses++;
+
+			handle = m_pipelines.size();
+			m_handles.emplace(state, handle);
+			m_pipelines.push_back({});
+			m_stats.pipelineCount = m_pipelines.size();
+
+			lock.unlock();
+
+			PipelineSlot slot;
+			try
+			{
+				slot = BuildPipeline(device, state, {});
+			}
+			catch (...)
+			{
+				FinishBuild(handle, { nullptr, nullptr, PipelineStatus::eFailed });
+				throw;
+			}
+
+			FinishBuild(handle, slot);
+			return slot.pipeline;
+		}
+	}
+
+	// It's being built in the background, so help out with the builds until it's done rather than compiling it twice
+	if (GetPipelineStatus(handle) == PipelineStatus::ePending)
+	{
+		m_jobSystem->Wait(&m_buildCounter);
+	}
+
+	if (GetPipelineStatus(handle) == PipelineStatus::eFailed)
+	{
+		throw std::runtime_error("Graphics pipeline was requested again after failing to build");
+	}
+
+	return GetPipeline(handle);
+}
+
+PipelineHandle GraphicsPipelineWrapper::RequestPipeline(vk::Device device, const PipelineStateDescription& requestedState)
+{
+	PipelineStateDescription state = GetPipelineKey(requestedState);
+
+	PipelineHandle handle;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		std::unordered_map<PipelineStateDescription, PipelineHandle, PipelineStateHasher>::iterator it = m_handles.find(state);
+		if (it != m_handles.end())
+		{
+			m_stats.hits++;
+			return it->second;
+		}
+
+		m_stats.misses++;
+
+		handle = m_pipelines.size();
+		m_handles.emplace(state, handle);
+		m_pipelines.push_back({});
+		m_stats.pipelineCount = m_pipelines.size();
+	}
+
+	// If the driver already has this one cached, it comes back straight away without compiling anything
+	PipelineSlot slot;
+	try
+	{
+		slot = BuildPipeline(device, state, vk::PipelineCreateFlagBits::eFailOnPipelineCompileRequired);
+	}
+	catch (...)
+	{
+		FinishBuild(handle, { nullptr, nullptr, PipelineStatus::eFailed });
+		throw;
+	}
+
+	if (slot.pipeline != nullptr)
+	{
+		FinishBuild(handle, slot);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stats.fastPathBuilds++;
+
+		return handle;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stats.backgroundBuilds++;
+	}
+
+	std::function<void()> buildJob = [this, device, state, handle]()
+	{
+		// Failures are kept in the slot rather than thrown, since nobody is waiting on this job in particular
+		try
+		{
+			FinishBuild(handle, BuildPipeline(device, state, {}));
+		}
+		catch (const std::exception& ex)
+		{
+			Logger::Log({ "Background pipeline build failed: ", ex.what() }, LogType::Error);
+			FinishBuild(handle, { nullptr, nullptr, PipelineStatus::eFailed });
+		}
+	};
+
+	if (m_jobSystem == nullptr)
+	{
+		buildJob();
+	}
+	else
+	{
+		// In the background queue, so that a frame waiting on its recording jobs never ends up compiling a pipeline instead
+		m_jobSystem->RunBackground(buildJob, &m_buildCounter);
+	}
+
+	return handle;
+}
+
+vk::Pipeline GraphicsPipelineWrapper::GetPipeline(PipelineHandle handle) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_pipelines.at(handle).pipeline;
+}
+
+PipelineStatus GraphicsPipelineWrapper::GetPipelineStatus(PipelineHandle handle) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_pipelines.at(handle).status;
+}
+
+vk::PipelineLayout GraphicsPipelineWrapper::GetPipelineLayout(PipelineHandle handle) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_pipelines.at(handle).layout;
+}
+
+void GraphicsPipelineWrapper::RecordDynamicState(vk::CommandBuffer commandBuffer, const DynamicRenderState& renderState) const
+{
+	if (!m_dynamicStateSupport.enabled) { return; }
+
+	commandBuffer.setPrimitiveTopology(renderState.topology);
+	commandBuffer.setPrimitiveRestartEnable(renderState.primitiveRestartEnable);
+	commandBuffer.setCullMode(renderState.cullMode);
+	commandBuffer.setFrontFace(renderState.frontFace);
+
+	if (m_dynamicStateSupport.polygonMode) { commandBuffer.setPolygonModeEXT(renderState.polygonMode); }
+
+	if (m_dynamicStateSupport.colourBlend)
+	{
+		vk::Bool32 blendEnable = renderState.blendMode != BlendMode::eOpaque;
+		commandBuffer.setColorBlendEnableEXT(0, blendEnable);
+		commandBuffer.setColorBlendEquationEXT(0, GetColourBlendEquation(renderState.blendMode));
+	}
+}
+
+PipelineCacheStats GraphicsPipelineWrapper::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	PipelineCacheStats stats = m_stats;
+	stats.pendingBuilds = std::count_if(m_pipelines.begin(), m_pipelines.end(),
+		[](const PipelineSlot& slot) { return slot.status == PipelineStatus::ePending; });
+
+	return stats;
 }
 
 void GraphicsPipelineWrapper::DestroyPipeline(vk::Device device)
 {
-	if (m_graphicsPipeline != nullptr) { device.destroyPipeline(m_graphicsPipeline); }
-	if (m_pipelineLayout != nullptr) { device.destroyPipelineLayout(m_pipelineLayout); }
+	// Build jobs never throw, since they catch their own failures
+	if (m_jobSystem != nullptr) { m_jobSystem->Wait(&m_buildCounter); }
+
+	for (PipelineSlot& slot : m_pipelines)
+	{
+		if (slot.pipeline != nullptr) { device.destroyPipeline(slot.pipeline); }
+	}
+	m_pipelines.clear();
+	m_handles.clear();
+
+	// Layouts are shared, so they're only destroyed once every pipeline using them is gone
+	for (std::pair<const std::vector<uint32_t>, vk::PipelineLayout>& pipelineLayout : m_pipelineLayouts)
+	{
+		device.destroyPipelineLayout(pipelineLayout.second);
+	}
+	m_pipelineLayouts.clear();
+
+	for (std::pair<const std::vector<uint32_t>, vk::DescriptorSetLayout>& setLayout : m_setLayouts)
+	{
+		device.destroyDescriptorSetLayout(setLayout.second);
+	}
+	m_setLayouts.clear();
+
+	m_reflectionCache.Clear();
+	m_graphicsPipelineLayout = nullptr;
+
 	if (m_renderPass != nullptr) { device.destroyRenderPass(m_renderPass); }
-}
+}
\ No newline at end of file
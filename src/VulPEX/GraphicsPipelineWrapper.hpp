@@ -2,33 +2,176 @@
 
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include <map>
+#include <mutex>
 
 #include "Utility/VulkanDynamicInclude.hpp"
 
-struct ShaderInfo
+#include "PipelineStateDescription.hpp"
+#include "Modules/Threading/JobSystem.hpp"
+#include "Modules/Reflection/ShaderReflection.hpp"
+
+typedef uint32_t PipelineHandle;
+
+enum class PipelineStatus
+{
+	ePending,
+	eReady,
+	eFailed
+};
+
+struct PipelineSlot
 {
-	std::vector<char> vertBytecode;
-	std::vector<char> fragBytecode;
+	vk::Pipeline pipeline = nullptr;
+	vk::PipelineLayout layout = nullptr;
+	PipelineStatus status = PipelineStatus::ePending;
 };
 
+struct PipelineCacheStats
+{
+	// A hit means the pipeline had already been built, a miss means it was built on the spot
+	uint32_t hits = 0;
+	uint32_t misses = 0;
+
+	uint32_t pipelineCount = 0;
+
+	// Pipelines with matching shader interfaces share a layout, so there are usually far fewer of these
+	uint32_t pipelineLayoutCount = 0;
+
+	// Requests that were already in the vk::PipelineCache, so didn't need compiling
+	uint32_t fastPathBuilds = 0;
+	uint32_t backgroundBuilds = 0;
+	uint32_t pendingBuilds = 0;
+	uint32_t failedBuilds = 0;
+
+	// Only counts the createGraphicsPipeline calls, which is where shaders are compiled
+	double totalCreationTimeMs = 0;
+	double slowestCreationTimeMs = 0;
+};
+
+// Which parts of the render state are set while recording rather than baked into pipelines
+struct ExtendedDynamicStateSupport
+{
+	// Topology, primitive restart, cull mode and front face, which are all core in Vulkan 1.3
+	bool enabled = false;
+
+	// VK_EXT_extended_dynamic_state3. Blend mode needs both colour blend features
+	bool polygonMode = false;
+	bool colourBlend = false;
+
+	// Without this, topology can only change within its class (e.g. from triangle lists to triangle strips, but not to lines)
+	bool unrestrictedTopology = false;
+};
+
+// Owns the render pass that every pipeline shares, every pipeline permutation built so far, and the layouts they use
 class GraphicsPipelineWrapper
 {
+	// With dynamic rendering there's no render pass, and pipelines are built against the attachment formats instead
+	bool m_useDynamicRendering = false;
 	vk::RenderPass m_renderPass = nullptr;
-	vk::PipelineLayout m_pipelineLayout = nullptr;
+	vk::Format m_colourFormat = vk::Format::eUndefined;
+
+	ExtendedDynamicStateSupport m_dynamicStateSupport;
+
+	// The vk::PipelineCache that everything is compiled through, not to be confused with m_pipelines
+	vk::PipelineCache m_pipelineCache = nullptr;
+
+	// Pipelines that miss the vk::PipelineCache are compiled on here
+	Threading::JobSystem* m_jobSystem = nullptr;
+	Threading::JobCounter m_buildCounter;
+
+	// Background builds finish on worker threads, so everything below is guarded by this
+	mutable std::mutex m_mutex;
+
+	std::unordered_map<PipelineStateDescription, PipelineHandle, PipelineStateHasher> m_handles;
+	std::vector<PipelineSlot> m_pipelines;
+
+	// Layouts are built from the reflected shaders, and keyed by a flattened copy of what they contain,
+	// so that pipelines with the same interface end up with the same layout and descriptor sets stay bound between them
+	Reflection::ShaderReflectionCache m_reflectionCache;
+	std::map<std::vector<uint32_t>, vk::DescriptorSetLayout> m_setLayouts;
+	std::map<std::vector<uint32_t>, vk::PipelineLayout> m_pipelineLayouts;
+
+	// Whatever GraphicsPipelineSetup was given, which every other permutation starts from
+	PipelineStateDescription m_defaultState;
 	vk::Pipeline m_graphicsPipeline = nullptr;
+	vk::PipelineLayout m_graphicsPipelineLayout = nullptr;
+
+	double m_creationTimeMs = 0;
+
+	PipelineCacheStats m_stats;
 
 	vk::ShaderModule CreateShaderModule(vk::Device device, std::vector<char> bytecode);
 
 	void CreateRenderPass(vk::Device device, vk::Format imageFormat);
+	// Expects m_mutex to already be held
+	vk::DescriptorSetLayout GetOrCreateSetLayout(vk::Device device, const std::vector<Reflection::DescriptorBinding>& bindings);
+	// Safe to call from any thread
+	vk::PipelineLayout GetOrCreatePipelineLayout(vk::Device device, const Reflection::ShaderReflection& vertReflection,
+												 const Reflection::ShaderReflection& fragReflection);
+
+	// Resets everything that's set while recording, so that states which only differ by those share a pipeline
+	PipelineStateDescription GetPipelineKey(const PipelineStateDescription& state) const;
+
+	// Safe to call from any thread
+	// With eFailOnPipelineCompileRequired, the returned slot's pipeline is nullptr instead of compiling anything that isn't in the vk::PipelineCache
+	PipelineSlot BuildPipeline(vk::Device device, const PipelineStateDescription& state, vk::PipelineCreateFlags flags);
+
+	void FinishBuild(PipelineHandle handle, PipelineSlot slot);
 
 public:
-	void CreateGraphicsPipeline(vk::Device device, ShaderInfo shaderInfo, vk::Extent2D scExtent, vk::Format imageFormat, uint32_t sizeOfVertex,
-								std::pair<vk::Format, uint32_t>* vertexVarsInfo, size_t vertexVarsInfoCount);
+	// Must be called before CreateGraphicsPipeline
+	// Needs the dynamicRendering feature, which is core in Vulkan 1.3
+	void ConfigureDynamicRendering(bool useDynamicRendering) { m_useDynamicRendering = useDynamicRendering; };
+
+	// Must be called before CreateGraphicsPipeline
+	// Whatever's supported is left out of the pipelines, and has to be set with RecordDynamicState before drawing
+	void ConfigureExtendedDynamicState(ExtendedDynamicStateSupport dynamicStateSupport) { m_dynamicStateSupport = dynamicStateSupport; };
+
+	// pipelineCache can be nullptr, but then every pipeline gets compiled from scratch every time
+	// If jobSystem is nullptr, RequestPipeline compiles on the calling thread instead
+	// If vertexVarsInfoCount is 0, the vertex inputs are read from the vertex shader and packed tightly in location order,
+	// and if sizeOfVertex is 0 as well, the stride is worked out from them too
+	void CreateGraphicsPipeline(vk::Device device, vk::PipelineCache pipelineCache, Threading::JobSystem* jobSystem, ShaderInfo shaderInfo,
+								vk::Format imageFormat, uint32_t sizeOfVertex, std::pair<vk::Format, uint32_t>* vertexVarsInfo,
+								size_t vertexVarsInfoCount);
+
+	// Returns the already-built pipeline if this state has been asked for before, otherwise builds it first
+	// Blocks until the pipeline exists, so keep this out of the render loop
+	vk::Pipeline GetOrCreatePipeline(vk::Device device, const PipelineStateDescription& requestedState);
+
+	// Never compiles on the calling thread. Pipelines that are already in the vk::PipelineCache are ready straight away,
+	// anything else is compiled on the job system, and GetPipeline returns nullptr until it's done
+	PipelineHandle RequestPipeline(vk::Device device, const PipelineStateDescription& requestedState);
+	vk::Pipeline GetPipeline(PipelineHandle handle) const;
+	PipelineStatus GetPipelineStatus(PipelineHandle handle) const;
+	// nullptr until the pipeline is ready
+	vk::PipelineLayout GetPipelineLayout(PipelineHandle handle) const;
+
+	// Sets whatever isn't baked into the pipelines. Does nothing unless extended dynamic state is configured
+	// Secondary command buffers don't inherit dynamic state, so every command buffer has to call this before its first draw
+	void RecordDynamicState(vk::CommandBuffer commandBuffer, const DynamicRenderState& renderState) const;
 
 	// Getters
 	vk::Pipeline GetPipeline() const { return m_graphicsPipeline; };
+	vk::PipelineLayout GetPipelineLayout() const { return m_graphicsPipelineLayout; };
+	// nullptr when using dynamic rendering
 	vk::RenderPass GetRenderPass() const { return m_renderPass; };
+	vk::Format GetColourFormat() const { return m_colourFormat; };
+
+	PipelineStateDescription GetDefaultState() const { return m_defaultState; };
+
+	// How long the default pipeline took to build
+	double GetCreationTimeMs() const { return m_creationTimeMs; };
+
+	PipelineCacheStats GetStats() const;
+
+	// Bools
+	bool IsUsingDynamicRendering() const { return m_useDynamicRendering; };
+	bool IsUsingExtendedDynamicState() const { return m_dynamicStateSupport.enabled; };
 
 	// Cleanup
+	// Waits for any background builds to finish first
 	void DestroyPipeline(vk::Device device);
 };
\ No newline at end of file
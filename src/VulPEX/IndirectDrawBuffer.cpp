@@ -0,0 +1,44 @@
+#include "IndirectDrawBuffer.hpp"
+
+// Public
+void IndirectDrawBuffer::CreateIndirectDrawBuffer(vk::Device device, DeviceMemoryAllocator* allocator, std::vector<uint32_t> queueFamilyIndices,
+												  uint32_t capacity)
+{
+	if (capacity == 0)
+	{
+		throw std::runtime_error("Indirect draw buffers need a non-zero capacity");
+	}
+
+	m_capacity = capacity;
+	m_data.assign(GetDrawCountOffset(capacity), 0);
+
+	// Storage as well, so that compute shaders can write the draws (e.g. when culling on the GPU)
+	vk::BufferUsageFlags usage = vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eStorageBuffer;
+	m_buffer.CreateBuffer(device, allocator, m_data.size(), usage, queueFamilyIndices, vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+	// Nothing is on the GPU yet, and WriteChanged only compares against what it thinks is there
+	m_dirtyRanges.MarkDirty(0, m_data.size());
+}
+
+void IndirectDrawBuffer::SetDraws(const std::vector<vk::DrawIndexedIndirectCommand>& commands, const std::vector<uint32_t>& drawCounts)
+{
+	if (commands.size() > m_capacity || drawCounts.size() > m_capacity)
+	{
+		throw std::runtime_error("Attempted to write more indirect draws than the indirect draw buffer has room for");
+	}
+
+	// Anything past the end isn't read, so it doesn't matter that it's left over from before
+	m_dirtyRanges.WriteChanged(m_data.data(), GetCommandOffset(0), commands.data(), sizeof(vk::DrawIndexedIndirectCommand) * commands.size(),
+							   sizeof(vk::DrawIndexedIndirectCommand));
+	m_dirtyRanges.WriteChanged(m_data.data(), GetDrawCountOffset(0), drawCounts.data(), sizeof(uint32_t) * drawCounts.size(), sizeof(uint32_t));
+}
+
+vk::DeviceSize IndirectDrawBuffer::StageDirtyRanges(StagingRing* stagingRing, std::vector<vk::BufferCopy>& copyRegions)
+{
+	return m_dirtyRanges.StageRanges(stagingRing, m_data.data(), copyRegions);
+}
+
+void IndirectDrawBuffer::DestroyIndirectDrawBuffer(vk::Device device, DeviceMemoryAllocator* allocator)
+{
+	if (IsCreated()) { m_buffer.DestroyBuffer(device, allocator); }
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+
+#include "Utility/VulkanDynamicInclude.hpp"
+
+#include "BufferWrapper.hpp"
+#include "GeometryBuffer.hpp"
+#include "StagingRing.hpp"
+#include "DeviceMemoryAllocator.hpp"
+
+// Indirect draw commands, followed by a draw count for each batch of them, all in one device-local buffer
+// Batches are contiguous runs of commands that can go out in a single drawIndexedIndirect or drawIndexedIndirectCount
+class IndirectDrawBuffer
+{
+	// Vulkan resources
+	BufferWrapper m_buffer;
+
+	// Misc resources
+	// Laid out exactly like the device buffer, so that dirty ranges can be staged straight out of it
+	std::vector<char> m_data;
+
+	// In commands. There can never be more batches than commands, so the counts get the same number of slots
+	uint32_t m_capacity = 0;
+
+	DirtyRangeList m_dirtyRanges;
+
+public:
+	void CreateIndirectDrawBuffer(vk::Device device, DeviceMemoryAllocator* allocator, std::vector<uint32_t> queueFamilyIndices, uint32_t capacity);
+
+	// Rewrites every command and draw count. Throws if there are more commands than the capacity
+	void SetDraws(const std::vector<vk::DrawIndexedIndirectCommand>& commands, const std::vector<uint32_t>& drawCounts);
+
+	// Copies every dirty range into the staging ring and fills out the copies needed to get them to the device buffer
+	// If the ring runs out of space, whatever didn't fit stays dirty and is picked up next frame. Returns the number of bytes staged
+	vk::DeviceSize StageDirtyRanges(StagingRing* stagingRing, std::vector<vk::BufferCopy>& copyRegions);
+
+	// Getters
+	vk::Buffer GetBuffer() const { return m_buffer.GetBuffer(); };
+	uint32_t GetCapacity() const { return m_capacity; };
+
+	vk::DeviceSize GetCommandOffset(uint32_t commandIndex) const { return sizeof(vk::DrawIndexedIndirectCommand) * (vk::DeviceSize)commandIndex; };
+	vk::DeviceSize GetDrawCountOffset(uint32_t batchIndex) const { return GetCommandOffset(m_capacity) + sizeof(uint32_t) * (vk::DeviceSize)batchIndex; };
+
+	// Bools
+	bool IsCreated() const { return m_capacity > 0; };
+	bool IsDirty() const { return !m_dirtyRanges.IsEmpty(); };
+
+	// Cleanup
+	void DestroyIndirectDrawBuffer(vk::Device device, DeviceMemoryAllocator* allocator);
+};
\ No newline at end of file
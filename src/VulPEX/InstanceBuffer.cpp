@@ -0,0 +1,86 @@
+#include "InstanceBuffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+// Public
+void InstanceBuffer::CreateInstanceBuffer(vk::Device device, DeviceMemoryAllocator* allocator, std::vector<uint32_t> queueFamilyIndices,
+										  uint32_t sizeOfInstance, uint32_t capacity)
+{
+	if (sizeOfInstance == 0 || capacity == 0)
+	{
+		throw std::runtime_error("Instance buffers need a non-zero instance size and capacity");
+	}
+
+	m_sizeOfInstance = sizeOfInstance;
+	m_capacity = capacity;
+
+	m_buffer.CreateBuffer(device, allocator, (vk::DeviceSize)sizeOfInstance * capacity, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer, queueFamilyIndices,
+		vk::MemoryPropertyFlagBits::eDeviceLocal);
+}
+
+void InstanceBuffer::SetInstances(const void* instanceData, uint32_t instanceCount)
+{
+	if (instanceCount > m_capacity)
+	{
+		throw std::runtime_error("Attempted to set more instances than the instance buffer has room for");
+	}
+
+	const char* newData = (const char*)instanceData;
+	vk::DeviceSize newSize = (vk::DeviceSize)instanceCount * m_sizeOfInstance;
+
+	// Anything that was dirty past the new end no longer exists to be uploaded
+	m_dirtyRanges.Truncate(newSize);
+
+	// Anything past the end of what was there before is new, so it's dirty whatever it contains
+	vk::DeviceSize comparedSize = std::min<vk::DeviceSize>(newSize, m_instanceData.size());
+	for (vk::DeviceSize offset = 0; offset < comparedSize; offset += m_sizeOfInstance)
+	{
+		if (std::memcmp(m_instanceData.data() + offset, newData + offset, m_sizeOfInstance) != 0)
+		{
+			m_dirtyRanges.MarkDirty(offset, m_sizeOfInstance);
+		}
+	}
+	m_dirtyRanges.MarkDirty(comparedSize, newSize - comparedSize);
+
+	m_instanceData.assign(newData, newData + newSize);
+	m_instanceCount = instanceCount;
+}
+
+void InstanceBuffer::SetInstance(uint32_t index, const void* instanceData)
+{
+	if (index >= m_capacity)
+	{
+		throw std::runtime_error("Attempted to set an instance past the end of the instance buffer");
+	}
+
+	vk::DeviceSize offset = (vk::DeviceSize)index * m_sizeOfInstance;
+
+	if (offset + m_sizeOfInstance > m_instanceData.size())
+	{
+		// Instances skipped over on the way are zeroed, and uploaded along with this one
+		m_dirtyRanges.MarkDirty(m_instanceData.size(), offset + m_sizeOfInstance - m_instanceData.size());
+		m_instanceData.resize(offset + m_sizeOfInstance, 0);
+		m_instanceCount = index + 1;
+	}
+	else if (std::memcmp(m_instanceData.data() + offset, instanceData, m_sizeOfInstance) != 0)
+	{
+		m_dirtyRanges.MarkDirty(offset, m_sizeOfInstance);
+	}
+	else
+	{
+		return;
+	}
+
+	std::memcpy(m_instanceData.data() + offset, instanceData, m_sizeOfInstance);
+}
+
+vk::DeviceSize InstanceBuffer::StageDirtyRanges(StagingRing* stagingRing, std::vector<vk::BufferCopy>& copyRegions)
+{
+	return m_dirtyRanges.StageRanges(stagingRing, m_instanceData.data(), copyRegions);
+}
+
+void InstanceBuffer::DestroyInstanceBuffer(vk::Device device, DeviceMemoryAllocator* allocator)
+{
+	if (IsCreated()) { m_buffer.DestroyBuffer(device, allocator); }
+}
\ No newline at end of file
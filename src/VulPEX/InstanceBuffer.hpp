@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+
+#include "Utility/VulkanDynamicInclude.hpp"
+
+#include "BufferWrapper.hpp"
+#include "GeometryBuffer.hpp"
+#include "StagingRing.hpp"
+#include "DeviceMemoryAllocator.hpp"
+
+// Per-instance vertex data for one geometry, read through a second vertex binding with vk::VertexInputRate::eInstance
+// Kept up to date the same way as GeometryBuffer, so instances that don't change are never uploaded again
+class InstanceBuffer
+{
+	// Vulkan resources
+	BufferWrapper m_buffer;
+
+	// Misc resources
+	std::vector<char> m_instanceData;
+
+	uint32_t m_sizeOfInstance = 0;
+	uint32_t m_instanceCount = 0;
+
+	// In instances. The buffer never shrinks, and has to be replaced to grow
+	uint32_t m_capacity = 0;
+
+	DirtyRangeList m_dirtyRanges;
+
+public:
+	void CreateInstanceBuffer(vk::Device device, DeviceMemoryAllocator* allocator, std::vector<uint32_t> queueFamilyIndices,
+							  uint32_t sizeOfInstance, uint32_t capacity);
+
+	// Replaces every instance. instanceCount can't be more than the capacity
+	// Only the instances that are actually different are marked dirty, so resubmitting the same instances every frame costs a compare
+	void SetInstances(const void* instanceData, uint32_t instanceCount);
+	// Replaces a single instance, growing the instance count to cover it if need be. Marked dirty only if it's actually different
+	void SetInstance(uint32_t index, const void* instanceData);
+
+	// Copies every dirty range into the staging ring and fills out the copies needed to get them to the device buffer
+	// If the ring runs out of space, whatever didn't fit stays dirty and is picked up next frame. Returns the number of bytes staged
+	vk::DeviceSize StageDirtyRanges(StagingRing* stagingRing, std::vector<vk::BufferCopy>& copyRegions);
+
+	// Getters
+	vk::Buffer GetBuffer() const { return m_buffer.GetBuffer(); };
+
+	uint32_t GetSizeOfInstance() const { return m_sizeOfInstance; };
+	uint32_t GetInstanceCount() const { return m_instanceCount; };
+	uint32_t GetCapacity() const { return m_capacity; };
+
+	// Bools
+	bool IsCreated() const { return m_capacity > 0; };
+	bool IsDirty() const { return !m_dirtyRanges.IsEmpty(); };
+
+	// Cleanup
+	void DestroyInstanceBuffer(vk::Device device, DeviceMemoryAllocator* allocator);
+};
\ No newline at end of file
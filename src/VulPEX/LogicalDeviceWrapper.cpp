@@ -35,12 +35,29 @@ QueueFamilyIndices LogicalDeviceWrapper::GetAvailableQueueFamilies(vk::PhysicalD
 		if (indices.IsFilled()) { break; }
 	}
 
+	if (!indices.FamilyExists("transferQueueFamily") && indices.FamilyExists("graphicsQueueFamily"))
+	{
+		indices.queueFamilies.insert_or_assign("transferQueueFamily", indices.queueFamilies.at("graphicsQueueFamily"));
+	}
+
 	return indices;
 }
 
 LogicalDeviceWrapper::LogicalDeviceWrapper()
 {
 	m_queues = {{"graphicsQueue", nullptr}, {"surfaceQueue", nullptr}, {"transferQueue", nullptr}};
+
+	// Always enabled, so PhysicalDeviceWrapper turns down any device that doesn't support every one of these
+
+	// Timeline semaphores let the transfer queue signal the graphics queue without the CPU having to wait in between
+	m_vulkan12Features.timelineSemaphore = vk::True;
+
+	// Lets pipeline creation bail out instead of compiling, so we can tell whether a pipeline is already cached without stalling
+	m_vulkan13Features.pipelineCreationCacheControl = vk::True;
+
+	// Both are core in 1.3, and let us render straight into swapchain images without render pass or framebuffer objects
+	m_vulkan13Features.dynamicRendering = vk::True;
+	m_vulkan13Features.synchronization2 = vk::True;
 }
 
 void LogicalDeviceWrapper::ConfigureLogicalDevice(std::vector<std::string> requestedQueueFamilies)
@@ -52,6 +69,26 @@ void LogicalDeviceWrapper::ConfigureLogicalDevice(std::vector<std::string> reque
 	
 }
 
+void LogicalDeviceWrapper::ConfigureIndirectDrawing(bool multiDrawIndirect, bool drawIndirectCount, bool drawIndirectFirstInstance)
+{
+	// Lets a single indirect draw call issue more than one draw
+	m_deviceFeatures.multiDrawIndirect = multiDrawIndirect;
+
+	// Lets indirect draws start somewhere other than instance 0, which is how each object finds its own per-instance data
+	m_deviceFeatures.drawIndirectFirstInstance = drawIndirectFirstInstance;
+
+	// Lets the number of draws come from a buffer too, rather than being recorded into the command buffer
+	m_vulkan12Features.drawIndirectCount = drawIndirectCount;
+}
+
+void LogicalDeviceWrapper::ConfigureExtendedDynamicState3(vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT features)
+{
+	m_extendedDynamicState3Features = features;
+	m_extendedDynamicState3Features.pNext = nullptr;
+
+	m_enableExtendedDynamicState3 = true;
+}
+
 // Public
 #ifdef _DEBUG
 	void LogicalDeviceWrapper::CreateLogicalDevice(vk::PhysicalDevice device, vk::SurfaceKHR surface, std::vector<const char*> deviceExtensions, std::vector<const char*> validationLayers)
@@ -81,8 +118,6 @@ void LogicalDeviceWrapper::ConfigureLogicalDevice(std::vector<std::string> reque
 			queueInfoList.push_back(queueInfo);
 		}
 
-		vk::PhysicalDeviceFeatures featuresInfo{};
-
 		// Validation layers
 		// Vulkan no longer makes a distinction between instance-level and device-level validation layers
 		// However, since the user could be using an older version of Vulkan, we still define them so as to be compatible
@@ -92,6 +127,10 @@ void LogicalDeviceWrapper::ConfigureLogicalDevice(std::vector<std::string> reque
 		enabledLayerCount = validationLayers.size();
 		enabledLayerNames = validationLayers.data();
 		
+		// Chained here rather than in the constructor, so that it can't point at a copy of this wrapper
+		m_vulkan12Features.pNext = &m_vulkan13Features;
+		m_vulkan13Features.pNext = m_enableExtendedDynamicState3 ? &m_extendedDynamicState3Features : nullptr;
+
 		vk::DeviceCreateInfo logicalDeviceInfo(
 			{},									//flags
 			(uint32_t)queueInfoList.size(),		//queueCreateInfoCount
@@ -100,7 +139,8 @@ void LogicalDeviceWrapper::ConfigureLogicalDevice(std::vector<std::string> reque
 			enabledLayerNames,					//ppEnabledLayerNames
 			(uint32_t)deviceExtensions.size(),	//enabledExtensionCount
 			deviceExtensions.data(),			//ppEnabledExtensionNames
-			&featuresInfo						//pEnabledFeatures
+			&m_deviceFeatures,					//pEnabledFeatures
+			&m_vulkan12Features					//pNext
 		);
 
 		m_logicalDevice = device.createDevice(logicalDeviceInfo);
@@ -113,7 +153,7 @@ void LogicalDeviceWrapper::ConfigureLogicalDevice(std::vector<std::string> reque
 #else
 	void LogicalDeviceWrapper::CreateLogicalDevice(vk::PhysicalDevice device, vk::SurfaceKHR surface, std::vector<const char*> deviceExtensions)
 	{
-		QueueFamilyIndices m_qfIndices = GetAvailableQueueFamilies(device, surface);
+		m_qfIndices = GetAvailableQueueFamilies(device, surface);
 		if (!m_qfIndices.NecessaryFamiliesFilled())
 		{
 			throw std::runtime_error("Could not create logical device, required queue families not available");
@@ -138,7 +178,9 @@ void LogicalDeviceWrapper::ConfigureLogicalDevice(std::vector<std::string> reque
 			queueInfoList.push_back(queueInfo);
 		}
 
-		vk::PhysicalDeviceFeatures featuresInfo{};
+		// Chained here rather than in the constructor, so that it can't point at a copy of this wrapper
+		m_vulkan12Features.pNext = &m_vulkan13Features;
+		m_vulkan13Features.pNext = m_enableExtendedDynamicState3 ? &m_extendedDynamicState3Features : nullptr;
 
 		vk::DeviceCreateInfo logicalDeviceInfo(
 			{},												//flags
@@ -148,7 +190,8 @@ void LogicalDeviceWrapper::ConfigureLogicalDevice(std::vector<std::string> reque
 			nullptr,										//ppEnabledLayerNames
 			(uint32_t)deviceExtensions.size(),				//enabledExtensionCount
 			deviceExtensions.data(),						//ppEnabledExtensionNames
-			&featuresInfo									//pEnabledFeatures
+			&m_deviceFeatures,								//pEnabledFeatures
+			&m_vulkan12Features								//pNext
 		);
 
 		m_logicalDevice = device.createDevice(logicalDeviceInfo);
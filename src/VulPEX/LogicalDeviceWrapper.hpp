@@ -6,7 +6,6 @@
 
 struct QueueFamilyIndices
 {
-	// TODO: later, optimise queue use by using specialised queues (i.e async transfer queues)
 	/**
 	 * Queue families aren't concrete things, so there's no real concrete names I can give them in an Enum.
 	 * Because of this, I've left the key as a string that the user can define.
@@ -14,7 +13,7 @@ struct QueueFamilyIndices
 	 * They are as follows:
 	 *  - graphicsQueueFamily
 	 *  - surfaceQueueFamily
-	 *  - transferQueueFamily
+	 *  - transferQueueFamily (falls back on the graphics family if there's no dedicated transfer family)
 	*/
 	std::unordered_map<std::string, uint32_t> queueFamilies;
 
@@ -46,6 +45,16 @@ class LogicalDeviceWrapper
 
 	QueueFamilyIndices m_qfIndices;
 
+	vk::PhysicalDeviceFeatures m_deviceFeatures;
+
+	// Core features from newer Vulkan versions have to be chained onto the device info, rather than set in pEnabledFeatures
+	vk::PhysicalDeviceVulkan12Features m_vulkan12Features;
+	vk::PhysicalDeviceVulkan13Features m_vulkan13Features;
+
+	// Optional, so only chained on if ConfigureExtendedDynamicState3 was called
+	vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT m_extendedDynamicState3Features;
+	bool m_enableExtendedDynamicState3 = false;
+
 	// Functions
 	QueueFamilyIndices GetAvailableQueueFamilies(vk::PhysicalDevice device, vk::SurfaceKHR surface);
 
@@ -53,6 +62,12 @@ public:
 	LogicalDeviceWrapper();
 
 	void ConfigureLogicalDevice(std::vector<std::string> requestedQueueFamilies);
+
+	// Must be called before CreateLogicalDevice. Only enable what the physical device supports
+	void ConfigureIndirectDrawing(bool multiDrawIndirect, bool drawIndirectCount, bool drawIndirectFirstInstance);
+
+	// Must be called before CreateLogicalDevice, and VK_EXT_extended_dynamic_state3 has to be in the device extensions
+	void ConfigureExtendedDynamicState3(vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT features);
 	
 	#ifdef _DEBUG
 		void CreateLogicalDevice(vk::PhysicalDevice device, vk::SurfaceKHR surface, std::vector<const char*> deviceExtensions, std::vector<const char*> validationLayers);
@@ -0,0 +1,410 @@
+#include "MeshRegistry.hpp"
+
+#include <string>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include "Modules/MeshProcessing/IndexNarrowing.hpp"
+
+// FreeRangeList
+void FreeRangeList::Reset(uint32_t capacity)
+{
+	m_freeRanges.clear();
+	if (capacity > 0) { m_freeRanges.emplace(0, capacity); }
+
+	m_freeCount = capacity;
+}
+
+std::optional<uint32_t> FreeRangeList::Allocate(uint32_t size, uint32_t alignment)
+{
+	for (std::map<uint32_t, uint32_t>::iterator it = m_freeRanges.begin(); it != m_freeRanges.end(); it++)
+	{
+		uint32_t rangeOffset = it->first;
+		uint32_t rangeSize = it->second;
+
+		uint32_t padding = (alignment - rangeOffset % alignment) % alignment;
+		if (rangeSize < padding || rangeSize - padding < size) { continue; }
+
+		uint32_t offset = rangeOffset + padding;
+		uint32_t remaining = rangeSize - padding - size;
+
+		// Whatever's skipped over or left over stays free
+		m_freeRanges.erase(it);
+		if (padding > 0) { m_freeRanges.emplace(rangeOffset, padding); }
+		if (remaining > 0) { m_freeRanges.emplace(offset + size, remaining); }
+
+		m_freeCount -= size;
+		return offset;
+	}
+
+	return std::nullopt;
+}
+
+void FreeRangeList::Free(uint32_t offset, uint32_t size)
+{
+	if (size == 0) { return; }
+
+	std::map<uint32_t, uint32_t>::iterator next = m_freeRanges.lower_bound(offset);
+
+	// Merge into the range before, if it ends right where this one starts
+	if (next != m_freeRanges.begin())
+	{
+		std::map<uint32_t, uint32_t>::iterator previous = std::prev(next);
+		if (previous->first + previous->second == offset)
+		{
+			offset = previous->first;
+			size += previous->second;
+			m_freeRanges.erase(previous);
+		}
+	}
+
+	// And swallow the range after, if it starts right where this one ends
+	if (next != m_freeRanges.end() && offset + size == next->first)
+	{
+		size += next->second;
+		m_freeRanges.erase(next);
+	}
+
+	m_freeRanges.emplace(offset, size);
+	m_freeCount += size;
+}
+
+uint32_t FreeRangeList::GetLargestFreeRange() const
+{
+	uint32_t largest = 0;
+	for (const std::pair<const uint32_t, uint32_t>& freeRange : m_freeRanges)
+	{
+		largest = std::max(largest, freeRange.second);
+	}
+
+	return largest;
+}
+
+// MeshRegistry
+// Private
+MeshRange MeshRegistry::AllocateMesh(uint32_t vertexCount, vk::IndexType indexType, size_t indexCount)
+{
+	uint32_t slotsPerIndex = MeshProcessing::GetIndexSize(indexType) / sizeof(uint16_t);
+	uint32_t slotCount = slotsPerIndex * indexCount;
+
+	std::optional<uint32_t> firstVertex = m_freeVertices.Allocate(vertexCount);
+	std::optional<uint32_t> firstSlot = m_freeIndexSlots.Allocate(slotCount, slotsPerIndex);
+
+	if (!firstVertex.has_value() || !firstSlot.has_value())
+	{
+		// Don't leak whichever half did fit
+		if (firstVertex.has_value()) { m_freeVertices.Free(firstVertex.value(), vertexCount); }
+		if (firstSlot.has_value()) { m_freeIndexSlots.Free(firstSlot.value(), slotCount); }
+
+		throw std::runtime_error("Mesh registry has no room for a mesh with " + std::to_string(vertexCount) + " vertices and " +
+								 std::to_string(indexCount) + " " + vk::to_string(indexType) + " indices. The largest free ranges are " +
+								 std::to_string(m_freeVertices.GetLargestFreeRange()) + " vertices and " +
+								 std::to_string(m_freeIndexSlots.GetLargestFreeRange()) + " 16-bit index slots");
+	}
+
+	MeshRange range;
+	range.vertexOffset = firstVertex.value();
+	range.vertexCount = vertexCount;
+	range.indexType = indexType;
+	range.lods[0].firstIndex = firstSlot.value() / slotsPerIndex;
+
+	return range;
+}
+
+void* MeshRegistry::StageMesh(vk::Device device, DeviceMemoryAllocator* allocator, StagingRing* stagingRing, MeshHandle mesh, const void* vertexData)
+{
+	const MeshRange& range = GetMesh(mesh);
+
+	vk::DeviceSize indexSize = MeshProcessing::GetIndexSize(range.indexType);
+	vk::DeviceSize vertexByteSize = (vk::DeviceSize)range.vertexCount * m_sizeOfVertex;
+	vk::DeviceSize indexByteSize = indexSize * range.GetTotalIndexCount();
+
+	// The indices go right after the vertices, aligned for their own type
+	vk::DeviceSize indexStagingOffset = (vertexByteSize + indexSize - 1) & ~(indexSize - 1);
+	vk::DeviceSize stagingSize = indexStagingOffset + indexByteSize;
+
+	StagingAllocation staging;
+	if (stagingRing->GetBytesRemaining() >= stagingSize)
+	{
+		staging = stagingRing->Allocate(stagingSize);
+	}
+	else
+	{
+		MeshStagingBuffer& stagingBuffer = m_stagingBuffers.emplace_back();
+		stagingBuffer.buffer.CreateBuffer(device, allocator, stagingSize, vk::BufferUsageFlagBits::eTransferSrc, {},
+			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+		staging.data = stagingBuffer.buffer.GetAllocation().mappedData;
+		staging.buffer = stagingBuffer.buffer.GetBuffer();
+		staging.offset = 0;
+		staging.size = stagingSize;
+	}
+
+	std::memcpy(staging.data, vertexData, vertexByteSize);
+
+	PendingMeshUpload& upload = m_pendingUploads.emplace_back();
+	upload.mesh = mesh;
+	upload.source = staging.buffer;
+	upload.vertexCopy = vk::BufferCopy(
+		staging.offset,											//srcOffset
+		(vk::DeviceSize)range.vertexOffset * m_sizeOfVertex,	//dstOffset
+		vertexByteSize											//size
+	);
+	upload.indexCopy = vk::BufferCopy(
+		staging.offset + indexStagingOffset,				//srcOffset
+		indexSize * range.lods[0].firstIndex,				//dstOffset
+		indexByteSize										//size
+	);
+
+	return (char*)staging.data + indexStagingOffset;
+}
+
+MeshHandle MeshRegistry::InsertMesh(const MeshRange& range)
+{
+	MeshHandle handle;
+	if (!m_freeHandles.empty())
+	{
+		handle = m_freeHandles.back();
+		m_freeHandles.pop_back();
+		m_meshes[handle] = range;
+	}
+	else
+	{
+		handle = m_meshes.size();
+		m_meshes.push_back(range);
+	}
+
+	m_meshCount++;
+	return handle;
+}
+
+// Public
+void MeshRegistry::CreateMeshRegistry(vk::Device device, DeviceMemoryAllocator* allocator, std::vector<uint32_t> queueFamilyIndices,
+									  uint32_t sizeOfVertex, uint32_t vertexCapacity, uint32_t indexCapacity)
+{
+	if (sizeOfVertex == 0 || vertexCapacity == 0 || indexCapacity == 0)
+	{
+		throw std::runtime_error("Mesh registries need a non-zero vertex size and capacities");
+	}
+
+	m_sizeOfVertex = sizeOfVertex;
+
+	m_freeVertices.Reset(vertexCapacity);
+	m_freeIndexSlots.Reset(2 * indexCapacity);
+
+	m_vertexBuffer.CreateBuffer(device, allocator, (vk::DeviceSize)sizeOfVertex * vertexCapacity, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer, queueFamilyIndices,
+		vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+	m_indexBuffer.CreateBuffer(device, allocator, sizeof(uint32_t) * (vk::DeviceSize)indexCapacity, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
+		queueFamilyIndices, vk::MemoryPropertyFlagBits::eDeviceLocal);
+}
+
+MeshHandle MeshRegistry::AddMesh(vk::Device device, DeviceMemoryAllocator* allocator, StagingRing* stagingRing, const void* vertexData,
+								  uint32_t vertexCount, const std::vector<uint32_t>& indices)
+{
+	return AddMesh(device, allocator, stagingRing, vertexData, vertexCount, std::vector<MeshProcessing::LodLevel>{ { indices, 0 } });
+}
+
+MeshHandle MeshRegistry::AddMesh(vk::Device device, DeviceMemoryAllocator* allocator, StagingRing* stagingRing, const void* vertexData,
+								  uint32_t vertexCount, const std::vector<MeshProcessing::LodLevel>& lods)
+{
+	if (vertexCount == 0 || lods.empty() || lods[0].indices.empty())
+	{
+		throw std::runtime_error("Meshes need at least one vertex and one index");
+	}
+
+	if (lods.size() > c_maxMeshLods)
+	{
+		throw std::runtime_error("Meshes can't have more than " + std::to_string(c_maxMeshLods) + " LODs, not " + std::to_string(lods.size()));
+	}
+
+	size_t indexCount = 0;
+	for (const MeshProcessing::LodLevel& lod : lods)
+	{
+		MeshProcessing::ValidateIndices(lod.indices.data(), lod.indices.size(), vertexCount);
+		indexCount += lod.indices.size();
+	}
+
+	vk::IndexType indexType = MeshProcessing::GetIndexType(vertexCount);
+	uint32_t indexSize = MeshProcessing::GetIndexSize(indexType);
+
+	MeshRange range = AllocateMesh(vertexCount, indexType, indexCount);
+	range.lodCount = lods.size();
+
+	// LODs are packed one after the other
+	uint32_t firstIndex = range.lods[0].firstIndex;
+	for (uint32_t i = 0; i < lods.size(); i++)
+	{
+		range.lods[i].firstIndex = firstIndex;
+		range.lods[i].indexCount = lods[i].indices.size();
+		range.lods[i].error = lods[i].error;
+
+		firstIndex += lods[i].indices.size();
+	}
+
+	MeshHandle mesh = InsertMesh(range);
+	char* stagedIndices = (char*)StageMesh(device, allocator, stagingRing, mesh, vertexData);
+
+	// Narrowed on the way into staging memory, so the 32-bit indices are never copied anywhere else
+	for (uint32_t i = 0; i < lods.size(); i++)
+	{
+		MeshProcessing::WriteIndices(lods[i].indices.data(), stagedIndices + (size_t)(range.lods[i].firstIndex - range.lods[0].firstIndex) * indexSize,
+									 lods[i].indices.size(), indexType);
+	}
+
+	return mesh;
+}
+
+MeshHandle MeshRegistry::AddMesh(vk::Device device, DeviceMemoryAllocator* allocator, StagingRing* stagingRing, const void* vertexData,
+								  uint32_t vertexCount, const void* indexData, vk::IndexType indexType, std::span<const MeshLod> lods)
+{
+	MeshHandle mesh = ReserveMesh(vertexCount, indexType, lods);
+
+	void* stagedIndices = StageMesh(device, allocator, stagingRing, mesh, vertexData);
+	std::memcpy(stagedIndices, indexData, (size_t)GetMesh(mesh).GetTotalIndexCount() * MeshProcessing::GetIndexSize(indexType));
+
+	return mesh;
+}
+
+MeshHandle MeshRegistry::ReserveMesh(uint32_t vertexCount, vk::IndexType indexType, std::span<const MeshLod> lods)
+{
+	if (vertexCount == 0 || lods.empty() || lods[0].indexCount == 0)
+	{
+		throw std::runtime_error("Meshes need at least one vertex and one index");
+	}
+
+	if (lods.size() > c_maxMeshLods)
+	{
+		throw std::runtime_error("Meshes can't have more than " + std::to_string(c_maxMeshLods) + " LODs, not " + std::to_string(lods.size()));
+	}
+
+	if (indexType != vk::IndexType::eUint32 && (indexType != vk::IndexType::eUint16 || vertexCount > MeshProcessing::c_max16BitVertexCount))
+	{
+		throw std::runtime_error("Meshes with " + std::to_string(vertexCount) + " vertices can't use " + vk::to_string(indexType) + " indices");
+	}
+
+	size_t indexCount = 0;
+	for (const MeshLod& lod : lods)
+	{
+		if (lod.firstIndex != indexCount)
+		{
+			throw std::runtime_error("Mesh LODs have to be packed one after the other, from the start of the index data");
+		}
+
+		indexCount += lod.indexCount;
+	}
+
+	MeshRange range = AllocateMesh(vertexCount, indexType, indexCount);
+	range.lodCount = lods.size();
+
+	for (uint32_t i = 0; i < lods.size(); i++)
+	{
+		range.lods[i].firstIndex = range.lods[0].firstIndex + lods[i].firstIndex;
+		range.lods[i].indexCount = lods[i].indexCount;
+		range.lods[i].error = lods[i].error;
+	}
+
+	return InsertMesh(range);
+}
+
+void MeshRegistry::RemoveMesh(MeshHandle mesh)
+{
+	const MeshRange& range = GetMesh(mesh);
+
+	// The data is left where it is, since nothing reads it until it's overwritten by the next mesh to get the range
+	uint32_t slotsPerIndex = MeshProcessing::GetIndexSize(range.indexType) / sizeof(uint16_t);
+	m_freeVertices.Free(range.vertexOffset, range.vertexCount);
+	m_freeIndexSlots.Free(range.lods[0].firstIndex * slotsPerIndex, range.GetTotalIndexCount() * slotsPerIndex);
+
+	// An upload that hasn't gone out yet would land on whichever mesh gets the ranges next, so it's dropped
+	// Nothing will ever read its staging buffer, if it has one, so it can go as soon as it's next released
+	std::erase_if(m_pendingUploads, [&](const PendingMeshUpload& upload)
+	{
+		if (upload.mesh != mesh) { return false; }
+
+		for (MeshStagingBuffer& stagingBuffer : m_stagingBuffers)
+		{
+			if (stagingBuffer.buffer.GetBuffer() == upload.source) { stagingBuffer.ticket = TransferTicket{}; }
+		}
+
+		return true;
+	});
+
+	m_meshes[mesh].reset();
+	m_freeHandles.push_back(mesh);
+	m_meshCount--;
+}
+
+vk::DeviceSize MeshRegistry::QueuePendingUploads(UploadBatcher* uploadBatcher)
+{
+	vk::DeviceSize bytesQueued = 0;
+
+	for (const PendingMeshUpload& upload : m_pendingUploads)
+	{
+		uploadBatcher->QueueCopy(upload.source, m_vertexBuffer.GetBuffer(), upload.vertexCopy);
+		uploadBatcher->QueueCopy(upload.source, m_indexBuffer.GetBuffer(), upload.indexCopy);
+
+		bytesQueued += upload.vertexCopy.size + upload.indexCopy.size;
+	}
+
+	m_pendingUploads.clear();
+
+	return bytesQueued;
+}
+
+void MeshRegistry::SetUploadTicket(TransferTicket ticket)
+{
+	for (MeshStagingBuffer& stagingBuffer : m_stagingBuffers)
+	{
+		if (!stagingBuffer.ticket.has_value()) { stagingBuffer.ticket = ticket; }
+	}
+}
+
+void MeshRegistry::ReleaseStagingBuffers(vk::Device device, DeviceMemoryAllocator* allocator, const TransferQueueWrapper* transferQueue)
+{
+	std::erase_if(m_stagingBuffers, [&](MeshStagingBuffer& stagingBuffer)
+	{
+		if (!stagingBuffer.ticket.has_value() || !transferQueue->IsComplete(device, stagingBuffer.ticket.value())) { return false; }
+
+		stagingBuffer.buffer.DestroyBuffer(device, allocator);
+		return true;
+	});
+}
+
+void MeshRegistry::RecordBindVertexBuffer(vk::CommandBuffer commandBuffer) const
+{
+	vk::Buffer vertexBuffer = m_vertexBuffer.GetBuffer();
+	vk::DeviceSize offset = 0;
+	commandBuffer.bindVertexBuffers(0, 1, &vertexBuffer, &offset);
+}
+
+void MeshRegistry::RecordBindIndexBuffer(vk::CommandBuffer commandBuffer, vk::IndexType indexType) const
+{
+	commandBuffer.bindIndexBuffer(m_indexBuffer.GetBuffer(), 0, indexType);
+}
+
+const MeshRange& MeshRegistry::GetMesh(MeshHandle mesh) const
+{
+	if (!MeshExists(mesh))
+	{
+		throw std::runtime_error("Mesh handle " + std::to_string(mesh) + " does not exist");
+	}
+
+	return m_meshes[mesh].value();
+}
+
+void MeshRegistry::DestroyMeshRegistry(vk::Device device, DeviceMemoryAllocator* allocator)
+{
+	if (!IsCreated()) { return; }
+
+	// Only called once the device is idle, so every copy out of these has finished
+	for (MeshStagingBuffer& stagingBuffer : m_stagingBuffers)
+	{
+		stagingBuffer.buffer.DestroyBuffer(device, allocator);
+	}
+	m_stagingBuffers.clear();
+
+	m_indexBuffer.DestroyBuffer(device, allocator);
+	m_vertexBuffer.DestroyBuffer(device, allocator);
+}
\ No newline at end of file
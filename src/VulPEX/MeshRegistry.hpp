@@ -0,0 +1,185 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <map>
+#include <optional>
+#include <span>
+
+#include "Utility/VulkanDynamicInclude.hpp"
+
+#include "BufferWrapper.hpp"
+#include "GeometryBuffer.hpp"
+#include "StagingRing.hpp"
+#include "UploadBatcher.hpp"
+#include "DeviceMemoryAllocator.hpp"
+
+#include "Modules/MeshProcessing/MeshSimplifier.hpp"
+
+typedef uint32_t MeshHandle;
+
+constexpr uint32_t c_maxMeshLods = 8;
+
+// One level of detail's indices. firstIndex is counted in indices of the mesh's own index type, which is what draws expect
+// with the index buffer bound at offset 0
+struct MeshLod
+{
+	uint32_t firstIndex = 0;
+	uint32_t indexCount = 0;
+
+	// How far the LOD strays from the full mesh, in the same units as its positions
+	float error = 0;
+};
+
+// Where a mesh lives inside the shared buffers, in the form that draw commands want it
+// Every LOD indexes the same vertices, and their indices are allocated together, starting at lods[0].firstIndex
+struct MeshRange
+{
+	int32_t vertexOffset = 0;
+	uint32_t vertexCount = 0;
+
+	vk::IndexType indexType = vk::IndexType::eUint32;
+
+	// LOD 0 is the full mesh, and each one after it is coarser
+	std::array<MeshLod, c_maxMeshLods> lods;
+	uint32_t lodCount = 0;
+
+	uint32_t GetTotalIndexCount() const { return lods[lodCount - 1].firstIndex + lods[lodCount - 1].indexCount - lods[0].firstIndex; };
+};
+
+// Hands out ranges of a fixed-size space, and merges freed ranges back into their neighbours so that it doesn't fragment
+class FreeRangeList
+{
+	// offset, size. Sorted by offset, and no two ranges ever touch, since they'd have been merged
+	std::map<uint32_t, uint32_t> m_freeRanges;
+
+	uint32_t m_freeCount = 0;
+
+public:
+	void Reset(uint32_t capacity);
+
+	// First fit. The offset returned is a multiple of alignment, and any gap skipped to get there stays free
+	// Returns std::nullopt if there's no single free range big enough
+	std::optional<uint32_t> Allocate(uint32_t size, uint32_t alignment = 1);
+	void Free(uint32_t offset, uint32_t size);
+
+	// Getters
+	uint32_t GetFreeCount() const { return m_freeCount; };
+	uint32_t GetFreeRangeCount() const { return m_freeRanges.size(); };
+	uint32_t GetLargestFreeRange() const;
+};
+
+// A mesh that's been staged, but not yet copied into the shared buffers. Its vertices and indices sit next to each other in source
+struct PendingMeshUpload
+{
+	MeshHandle mesh = 0;
+
+	vk::Buffer source = nullptr;
+	vk::BufferCopy vertexCopy;
+	vk::BufferCopy indexCopy;
+};
+
+// Meshes too big for what's left of the staging ring get a staging buffer of their own, which lives until its copy is done
+struct MeshStagingBuffer
+{
+	BufferWrapper buffer;
+
+	// Empty until the copy out of it has been submitted
+	std::optional<TransferTicket> ticket;
+};
+
+// Every mesh's vertices and indices sub-allocated out of one vertex buffer and one index buffer, so that they can all be drawn
+// after binding them once. Every mesh has to use the same vertex layout
+// Meshes with few enough vertices store 16-bit indices, so the index buffer holds a mix of both types
+class MeshRegistry
+{
+	// Vulkan resources
+	BufferWrapper m_vertexBuffer;
+	BufferWrapper m_indexBuffer;
+
+	std::vector<MeshStagingBuffer> m_stagingBuffers;
+
+	// Misc resources
+	uint32_t m_sizeOfVertex = 0;
+
+	// In vertices and 16-bit index slots respectively. A 32-bit index takes up two aligned slots
+	FreeRangeList m_freeVertices;
+	FreeRangeList m_freeIndexSlots;
+
+	// Removed meshes leave an empty slot, which the next mesh to be added reuses
+	std::vector<std::optional<MeshRange>> m_meshes;
+	std::vector<MeshHandle> m_freeHandles;
+	uint32_t m_meshCount = 0;
+
+	// Meshes are written into staging memory as they're added, so nothing is kept on the CPU but where they're going
+	std::vector<PendingMeshUpload> m_pendingUploads;
+
+	// Helpers
+	// Finds room for the mesh. Only lods[0].firstIndex is filled out
+	// Throws if there's no free range big enough for either the vertices or the indices
+	MeshRange AllocateMesh(uint32_t vertexCount, vk::IndexType indexType, size_t indexCount);
+	MeshHandle InsertMesh(const MeshRange& range);
+	// Copies the vertices into staging memory and queues the mesh's upload. Returns where the caller writes the indices
+	void* StageMesh(vk::Device device, DeviceMemoryAllocator* allocator, StagingRing* stagingRing, MeshHandle mesh, const void* vertexData);
+
+public:
+	// indexCapacity is in 32-bit indices, so twice as many 16-bit indices fit
+	void CreateMeshRegistry(vk::Device device, DeviceMemoryAllocator* allocator, std::vector<uint32_t> queueFamilyIndices,
+							uint32_t sizeOfVertex, uint32_t vertexCapacity, uint32_t indexCapacity);
+
+	// The mesh is staged straight away, so vertexData only has to live until this returns
+	// Indices are relative to the mesh's own vertices, and vertexOffset takes care of the rest
+	// They're narrowed to 16 bits if the mesh has few enough vertices for them to fit
+	// Throws if any index is past the last vertex, or there's no free range big enough for either the vertices or the indices
+	MeshHandle AddMesh(vk::Device device, DeviceMemoryAllocator* allocator, StagingRing* stagingRing, const void* vertexData, uint32_t vertexCount,
+					   const std::vector<uint32_t>& indices);
+	// The same, with every LOD's indices going in alongside the first. Throws if there are more than c_maxMeshLods
+	MeshHandle AddMesh(vk::Device device, DeviceMemoryAllocator* allocator, StagingRing* stagingRing, const void* vertexData, uint32_t vertexCount,
+					   const std::vector<MeshProcessing::LodLevel>& lods);
+	// For indices that are already in their final form, e.g. straight out of a mesh file. indexData holds every LOD's indices,
+	// and each LOD's firstIndex is relative to it. They're staged as they are, so nothing is allocated or narrowed
+	// Throws if the indices are 16-bit but there are too many vertices for that, or the LODs aren't packed one after the other
+	MeshHandle AddMesh(vk::Device device, DeviceMemoryAllocator* allocator, StagingRing* stagingRing, const void* vertexData, uint32_t vertexCount,
+					   const void* indexData, vk::IndexType indexType, std::span<const MeshLod> lods);
+	// Finds room for a mesh whose data the caller copies into the shared buffers itself, at the offsets in GetMesh
+	// Throws in the same cases as the AddMesh above
+	MeshHandle ReserveMesh(uint32_t vertexCount, vk::IndexType indexType, std::span<const MeshLod> lods);
+
+	// The mesh's ranges can be handed straight back out. That's safe even with frames in flight, since uploads wait for every frame
+	// submitted before them, but nothing that's still going to be drawn should refer to the mesh
+	// If the mesh hasn't been uploaded yet, it never will be
+	void RemoveMesh(MeshHandle mesh);
+
+	// Hands every staged mesh's copies to the batcher. Returns the number of bytes queued
+	vk::DeviceSize QueuePendingUploads(UploadBatcher* uploadBatcher);
+	// Tells the staging buffers queued since the last call which transfer copies out of them
+	void SetUploadTicket(TransferTicket ticket);
+	// Destroys the staging buffers whose copies have finished
+	void ReleaseStagingBuffers(vk::Device device, DeviceMemoryAllocator* allocator, const TransferQueueWrapper* transferQueue);
+
+	// Binds the vertex buffer to binding 0, which every mesh shares
+	void RecordBindVertexBuffer(vk::CommandBuffer commandBuffer) const;
+	// The index buffer has to be bound again whenever the next mesh drawn has a different index type
+	void RecordBindIndexBuffer(vk::CommandBuffer commandBuffer, vk::IndexType indexType) const;
+
+	// Getters
+	// Throws if the mesh doesn't exist
+	const MeshRange& GetMesh(MeshHandle mesh) const;
+
+	vk::Buffer GetVertexBuffer() const { return m_vertexBuffer.GetBuffer(); };
+	vk::Buffer GetIndexBuffer() const { return m_indexBuffer.GetBuffer(); };
+
+	uint32_t GetSizeOfVertex() const { return m_sizeOfVertex; };
+	uint32_t GetMeshCount() const { return m_meshCount; };
+
+	const FreeRangeList& GetFreeVertices() const { return m_freeVertices; };
+	const FreeRangeList& GetFreeIndexSlots() const { return m_freeIndexSlots; };
+
+	// Bools
+	bool IsCreated() const { return m_sizeOfVertex > 0; };
+	bool IsDirty() const { return !m_pendingUploads.empty(); };
+	bool MeshExists(MeshHandle mesh) const { return mesh < m_meshes.size() && m_meshes[mesh].has_value(); };
+
+	// Cleanup
+	void DestroyMeshRegistry(vk::Device device, DeviceMemoryAllocator* allocator);
+};
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "MappedFile.hpp"
+
+#include <utility>
+#include <stdexcept>
+
+#if defined(_WIN32) || defined(_WIN64)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+namespace Assets
+{
+	// Public
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this == &other) { return *this; }
+
+		UnmapFile();
+
+		m_data = std::exchange(other.m_data, nullptr);
+		m_size = std::exchange(other.m_size, 0);
+
+		#if defined(_WIN32) || defined(_WIN64)
+			m_fileHandle = std::exchange(other.m_fileHandle, nullptr);
+			m_mappingHandle = std::exchange(other.m_mappingHandle, nullptr);
+		#endif
+
+		return *this;
+	}
+
+	void MappedFile::MapFile(const std::string& path)
+	{
+		UnmapFile();
+
+		#if defined(_WIN32) || defined(_WIN64)
+			HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (file == INVALID_HANDLE_VALUE)
+			{
+				throw std::runtime_error("Failed to open " + path + ", error " + std::to_string(GetLastError()));
+			}
+
+			LARGE_INTEGER fileSize;
+			if (!GetFileSizeEx(file, &fileSize))
+			{
+				DWORD error = GetLastError();
+				CloseHandle(file);
+				throw std::runtime_error("Failed to get the size of " + path + ", error " + std::to_string(error));
+			}
+
+			m_fileHandle = file;
+			m_size = (size_t)fileSize.QuadPart;
+			if (m_size == 0) { return; }
+
+			m_mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (m_mappingHandle != nullptr) { m_data = (const char*)MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0); }
+
+			if (m_data == nullptr)
+			{
+				DWORD error = GetLastError();
+				UnmapFile();
+				throw std::runtime_error("Failed to map " + path + ", error " + std::to_string(error));
+			}
+		#else
+			int file = open(path.c_str(), O_RDONLY);
+			if (file < 0)
+			{
+				throw std::runtime_error("Failed to open " + path);
+			}
+
+			struct stat fileInfo;
+			if (fstat(file, &fileInfo) != 0)
+			{
+				close(file);
+				throw std::runtime_error("Failed to get the size of " + path);
+			}
+
+			m_size = (size_t)fileInfo.st_size;
+			if (m_size == 0)
+			{
+				close(file);
+				return;
+			}
+
+			// The mapping keeps its own reference to the file, so the descriptor isn't needed once it exists
+			void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+			close(file);
+
+			if (data == MAP_FAILED)
+			{
+				m_size = 0;
+				throw std::runtime_error("Failed to map " + path);
+			}
+
+			madvise(data, m_size, MADV_SEQUENTIAL);
+			madvise(data, m_size, MADV_WILLNEED);
+
+			m_data = (const char*)data;
+		#endif
+	}
+
+	void MappedFile::UnmapFile()
+	{
+		#if defined(_WIN32) || defined(_WIN64)
+			if (m_data != nullptr) { UnmapViewOfFile(m_data); }
+			if (m_mappingHandle != nullptr) { CloseHandle(m_mappingHandle); }
+			if (m_fileHandle != nullptr) { CloseHandle(m_fileHandle); }
+
+			m_fileHandle = nullptr;
+			m_mappingHandle = nullptr;
+		#else
+			if (m_data != nullptr) { munmap((void*)m_data, m_size); }
+		#endif
+
+		m_data = nullptr;
+		m_size = 0;
+	}
+}
\ No newline at end of file
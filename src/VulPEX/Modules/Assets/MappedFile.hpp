@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace Assets
+{
+	// A whole file mapped read-only into memory, so that its bytes can be copied straight out of the page cache without being
+	// read into a buffer first. Unmapped when it's destroyed, so it can't be copied, only moved
+	class MappedFile
+	{
+		// Misc resources
+		const char* m_data = nullptr;
+		size_t m_size = 0;
+
+		#if defined(_WIN32) || defined(_WIN64)
+			void* m_fileHandle = nullptr;
+			void* m_mappingHandle = nullptr;
+		#endif
+
+	public:
+		MappedFile() = default;
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		// Throws if the file can't be opened or mapped. Empty files are opened but not mapped, since there's nothing to map
+		// The whole file is going to be read once from start to finish, so the OS is told to start reading ahead straight away
+		void MapFile(const std::string& path);
+
+		// Getters
+		const char* GetData() const { return m_data; };
+		size_t GetSize() const { return m_size; };
+
+		// Bools
+		bool IsMapped() const { return m_data != nullptr; };
+
+		// Cleanup
+		// Anything read out of GetData is invalid afterwards
+		void UnmapFile();
+
+		~MappedFile() { UnmapFile(); };
+	};
+}
\ No newline at end of file
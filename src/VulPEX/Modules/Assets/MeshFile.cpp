@@ -0,0 +1,197 @@
+#include "MeshFile.hpp"
+
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+
+#include "../MeshProcessing/IndexNarrowing.hpp"
+
+namespace Assets
+{
+	// Private
+	static uint64_t AlignOffset(uint64_t offset)
+	{
+		return (offset + c_meshFileAlignment - 1) / c_meshFileAlignment * c_meshFileAlignment;
+	}
+
+	#ifdef _DEBUG
+		template<typename IndexType>
+		static bool IndicesInRange(const void* indexData, uint32_t indexCount, uint32_t vertexCount)
+		{
+			const IndexType* indices = (const IndexType*)indexData;
+			return std::all_of(indices, indices + indexCount, [vertexCount](IndexType index) { return index < vertexCount; });
+		}
+	#endif
+
+	// Public
+	void MeshFile::OpenMeshFile(const std::string& path)
+	{
+		CloseMeshFile();
+		m_file.MapFile(path);
+
+		if (m_file.GetSize() < sizeof(MeshFileHeader))
+		{
+			m_file.UnmapFile();
+			throw std::runtime_error(path + " is too small to be a mesh file");
+		}
+
+		// Mappings start on a page boundary, so the header is as aligned as it says it is
+		const MeshFileHeader* header = (const MeshFileHeader*)m_file.GetData();
+		std::string error;
+
+		if (header->magic != c_meshFileMagic)
+		{
+			error = "isn't a mesh file";
+		}
+		else if (header->version != c_meshFileVersion)
+		{
+			error = "is mesh file version " + std::to_string(header->version) + ", not " + std::to_string(c_meshFileVersion);
+		}
+		else if (header->indexType != (uint32_t)vk::IndexType::eUint16 && header->indexType != (uint32_t)vk::IndexType::eUint32)
+		{
+			error = "has an unknown index type " + std::to_string(header->indexType);
+		}
+		else if (header->sizeOfVertex == 0 || header->vertexCount == 0 || header->indexCount == 0 || header->lodCount == 0)
+		{
+			error = "has no vertices or no indices";
+		}
+		else if (header->attributeCount > c_maxMeshFileAttributes || header->lodCount > c_maxMeshFileLods)
+		{
+			error = "has " + std::to_string(header->attributeCount) + " attributes and " + std::to_string(header->lodCount) +
+					" LODs, which is more than a mesh file has room for";
+		}
+		else if (header->vertexDataOffset % c_meshFileAlignment != 0 || header->indexDataOffset % c_meshFileAlignment != 0)
+		{
+			error = "has a section that isn't aligned to " + std::to_string(c_meshFileAlignment) + " bytes";
+		}
+
+		// Sizes are worked out in 64 bits, so that a corrupt count can't wrap around and pass
+		// Only once the index type is known to be valid, since GetIndexSize throws for anything else
+		if (error.empty())
+		{
+			uint64_t vertexDataSize = (uint64_t)header->vertexCount * header->sizeOfVertex;
+			uint64_t indexDataSize = (uint64_t)header->indexCount * MeshProcessing::GetIndexSize((vk::IndexType)header->indexType);
+
+			if (header->vertexDataOffset > m_file.GetSize() || vertexDataSize > m_file.GetSize() - header->vertexDataOffset ||
+				header->indexDataOffset > m_file.GetSize() || indexDataSize > m_file.GetSize() - header->indexDataOffset)
+			{
+				error = "is " + std::to_string(m_file.GetSize()) + " bytes, which is too small for the sections its header describes";
+			}
+		}
+
+		for (uint32_t i = 0; error.empty() && i < header->lodCount; i++)
+		{
+			const MeshFileLod& lod = header->lods[i];
+			if (lod.indexCount == 0 || (uint64_t)lod.firstIndex + lod.indexCount > header->indexCount)
+			{
+				error = "has LOD " + std::to_string(i) + " outside of its index section";
+			}
+		}
+
+		for (uint32_t i = 0; error.empty() && i < header->attributeCount; i++)
+		{
+			if (header->attributes[i].offset >= header->sizeOfVertex)
+			{
+				error = "has attribute " + std::to_string(i) + " outside of its vertices";
+			}
+		}
+
+		#ifdef _DEBUG
+			if (error.empty())
+			{
+				const void* indexData = m_file.GetData() + header->indexDataOffset;
+				bool inRange = header->indexType == (uint32_t)vk::IndexType::eUint16 ? IndicesInRange<uint16_t>(indexData, header->indexCount, header->vertexCount)
+																					 : IndicesInRange<uint32_t>(indexData, header->indexCount, header->vertexCount);
+				if (!inRange) { error = "has indices past its last vertex"; }
+			}
+		#endif
+
+		if (!error.empty())
+		{
+			m_file.UnmapFile();
+			throw std::runtime_error(path + " " + error);
+		}
+
+		m_header = header;
+	}
+
+	size_t MeshFile::GetIndexDataSize() const
+	{
+		return (size_t)m_header->indexCount * MeshProcessing::GetIndexSize(GetIndexType());
+	}
+
+	void MeshFile::CloseMeshFile()
+	{
+		m_header = nullptr;
+		m_file.UnmapFile();
+	}
+
+	void WriteMeshFile(const std::string& path, const void* vertexData, uint32_t sizeOfVertex, uint32_t vertexCount,
+					   const std::vector<std::pair<vk::Format, uint32_t>>& vertexVarsInfo, const std::vector<MeshProcessing::LodLevel>& lods)
+	{
+		if (vertexVarsInfo.size() > c_maxMeshFileAttributes || lods.size() > c_maxMeshFileLods)
+		{
+			throw std::runtime_error("Mesh files can have at most " + std::to_string(c_maxMeshFileAttributes) + " attributes and " +
+									 std::to_string(c_maxMeshFileLods) + " LODs, not " + std::to_string(vertexVarsInfo.size()) + " and " +
+									 std::to_string(lods.size()));
+		}
+
+		if (sizeOfVertex == 0 || vertexCount == 0 || lods.empty() || lods[0].indices.empty())
+		{
+			throw std::runtime_error("Mesh files need at least one vertex and one index");
+		}
+
+		MeshFileHeader header;
+		header.sizeOfVertex = sizeOfVertex;
+		header.vertexCount = vertexCount;
+		header.indexType = (uint32_t)MeshProcessing::GetIndexType(vertexCount);
+		header.attributeCount = vertexVarsInfo.size();
+		header.lodCount = lods.size();
+
+		for (uint32_t i = 0; i < vertexVarsInfo.size(); i++)
+		{
+			header.attributes[i].format = (uint32_t)vertexVarsInfo[i].first;
+			header.attributes[i].offset = vertexVarsInfo[i].second;
+		}
+
+		for (uint32_t i = 0; i < lods.size(); i++)
+		{
+			header.lods[i].firstIndex = header.indexCount;
+			header.lods[i].indexCount = lods[i].indices.size();
+			header.lods[i].error = lods[i].error;
+
+			header.indexCount += lods[i].indices.size();
+		}
+
+		size_t vertexDataSize = (size_t)sizeOfVertex * vertexCount;
+		uint32_t indexSize = MeshProcessing::GetIndexSize((vk::IndexType)header.indexType);
+
+		header.vertexDataOffset = sizeof(MeshFileHeader);
+		header.indexDataOffset = AlignOffset(header.vertexDataOffset + vertexDataSize);
+
+		std::vector<char> indexData((size_t)header.indexCount * indexSize);
+		for (uint32_t i = 0; i < lods.size(); i++)
+		{
+			MeshProcessing::WriteIndices(lods[i].indices.data(), indexData.data() + (size_t)header.lods[i].firstIndex * indexSize, lods[i].indices.size(),
+										 (vk::IndexType)header.indexType);
+		}
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			throw std::runtime_error("Failed to open " + path + " for writing");
+		}
+
+		const char padding[c_meshFileAlignment] = {};
+
+		file.write((const char*)&header, sizeof(header));
+		file.write((const char*)vertexData, vertexDataSize);
+		file.write(padding, header.indexDataOffset - (header.vertexDataOffset + vertexDataSize));
+		file.write(indexData.data(), indexData.size());
+
+		if (!file.good())
+		{
+			throw std::runtime_error("Failed to write " + path);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <span>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+#include "../../Utility/VulkanDynamicInclude.hpp"
+#include "../MeshProcessing/MeshSimplifier.hpp"
+
+#include "MappedFile.hpp"
+
+namespace Assets
+{
+	// "VPXM", read as a little-endian uint32_t. Everything in the file is little-endian
+	constexpr uint32_t c_meshFileMagic = 0x4D585056;
+	constexpr uint32_t c_meshFileVersion = 1;
+
+	// The header and every section start on a multiple of this, so sections are as aligned in memory as the mapping is
+	constexpr uint32_t c_meshFileAlignment = 64;
+
+	constexpr uint32_t c_maxMeshFileAttributes = 16;
+	constexpr uint32_t c_maxMeshFileLods = 8;
+
+	// One vertex attribute, the same as a vertexVarsInfo entry. format is a vk::Format
+	struct MeshFileAttribute
+	{
+		uint32_t format = 0;
+		uint32_t offset = 0;
+	};
+
+	// firstIndex is counted from the start of the index section, in indices of the file's index type
+	struct MeshFileLod
+	{
+		uint32_t firstIndex = 0;
+		uint32_t indexCount = 0;
+		float error = 0;
+		uint32_t reserved = 0;
+	};
+
+	// Fixed size, with nothing in it that needs parsing, so it's used straight out of the mapped file
+	// The vertex section is vertexCount * sizeOfVertex bytes of vertices, exactly as they go into a vertex buffer
+	// The index section is indexCount indices of indexType, every LOD's one after the other, exactly as they go into an index buffer
+	struct alignas(c_meshFileAlignment) MeshFileHeader
+	{
+		uint32_t magic = c_meshFileMagic;
+		uint32_t version = c_meshFileVersion;
+
+		uint32_t sizeOfVertex = 0;
+		uint32_t vertexCount = 0;
+
+		// A vk::IndexType, either eUint16 or eUint32
+		uint32_t indexType = 0;
+		uint32_t indexCount = 0;
+
+		uint32_t attributeCount = 0;
+		uint32_t lodCount = 0;
+
+		// From the start of the file
+		uint64_t vertexDataOffset = 0;
+		uint64_t indexDataOffset = 0;
+
+		MeshFileAttribute attributes[c_maxMeshFileAttributes];
+		MeshFileLod lods[c_maxMeshFileLods];
+
+		// Pads the header out to a multiple of c_meshFileAlignment, without leaving any bytes uninitialised when it's written
+		uint32_t reserved[4] = {};
+	};
+
+	static_assert(std::is_trivially_copyable_v<MeshFileHeader>, "Mesh file headers are read straight out of memory");
+	static_assert(sizeof(MeshFileHeader) == 5 * c_meshFileAlignment, "Mesh file headers can't have any padding, and sections have to start aligned");
+
+	// A mesh file mapped into memory, whose vertices and indices can be copied straight into staging memory or a vertex buffer
+	// Opening one only reads the header, and nothing is allocated or converted
+	class MeshFile
+	{
+		// Misc resources
+		MappedFile m_file;
+		const MeshFileHeader* m_header = nullptr;
+
+	public:
+		// Throws if the file isn't a mesh file of this version, or its header describes sections that aren't all there
+		// Debug builds also check that every index is in range, which release builds leave to whoever wrote the file
+		void OpenMeshFile(const std::string& path);
+
+		// Getters
+		const MeshFileHeader& GetHeader() const { return *m_header; };
+
+		const void* GetVertexData() const { return m_file.GetData() + m_header->vertexDataOffset; };
+		size_t GetVertexDataSize() const { return (size_t)m_header->vertexCount * m_header->sizeOfVertex; };
+
+		const void* GetIndexData() const { return m_file.GetData() + m_header->indexDataOffset; };
+		size_t GetIndexDataSize() const;
+		vk::IndexType GetIndexType() const { return (vk::IndexType)m_header->indexType; };
+
+		std::span<const MeshFileAttribute> GetAttributes() const { return { m_header->attributes, m_header->attributeCount }; };
+		std::span<const MeshFileLod> GetLods() const { return { m_header->lods, m_header->lodCount }; };
+
+		// Bools
+		bool IsOpen() const { return m_header != nullptr; };
+
+		// Cleanup
+		// Every pointer the getters handed out is invalid afterwards
+		void CloseMeshFile();
+	};
+
+	// Indices are narrowed to 16 bits if there are few enough vertices, the same as the mesh registry would
+	// Throws if there are more attributes or LODs than a mesh file has room for, or the file can't be written
+	void WriteMeshFile(const std::string& path, const void* vertexData, uint32_t sizeOfVertex, uint32_t vertexCount,
+					   const std::vector<std::pair<vk::Format, uint32_t>>& vertexVarsInfo, const std::vector<MeshProcessing::LodLevel>& lods);
+}
\ No newline at end of file
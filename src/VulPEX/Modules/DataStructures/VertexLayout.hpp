@@ -0,0 +1,182 @@
+#pragma once
+
+#include <array>
+#include <utility>
+#include <cstdint>
+#include <type_traits>
+#include <algorithm>
+
+#include "../../Utility/VulkanDynamicInclude.hpp"
+
+#include "../../Utility/VulPEXMaths.hpp"
+#include "../MeshProcessing/VertexEncoding.hpp"
+
+namespace DataStructures
+{
+	// Packed vertex attributes, which take up a half to a quarter of the space of the float vectors they're made from
+	// Each is just its encoded components, laid out the way its VulkanFormat expects
+	struct Half2
+	{
+		uint16_t components[2] = {};
+
+		Half2() = default;
+		Half2(Vec2 value) { MeshProcessing::EncodeHalf(&value.x, components, 2); };
+	};
+
+	struct Half4
+	{
+		uint16_t components[4] = {};
+
+		Half4() = default;
+		Half4(Vec4 value) { MeshProcessing::EncodeHalf(&value.x, components, 4); };
+	};
+
+	struct Snorm8x4
+	{
+		int8_t components[4] = {};
+
+		Snorm8x4() = default;
+		Snorm8x4(Vec4 value) { MeshProcessing::EncodeSnorm8(&value.x, components, 4); };
+	};
+
+	struct Unorm8x4
+	{
+		uint8_t components[4] = {};
+
+		Unorm8x4() = default;
+		Unorm8x4(Vec4 value) { MeshProcessing::EncodeUnorm8(&value.x, components, 4); };
+	};
+
+	struct Snorm16x2
+	{
+		int16_t components[2] = {};
+
+		Snorm16x2() = default;
+		Snorm16x2(Vec2 value) { MeshProcessing::EncodeSnorm16(&value.x, components, 2); };
+	};
+
+	struct Snorm16x4
+	{
+		int16_t components[4] = {};
+
+		Snorm16x4() = default;
+		Snorm16x4(Vec4 value) { MeshProcessing::EncodeSnorm16(&value.x, components, 4); };
+	};
+
+	struct Unorm16x2
+	{
+		uint16_t components[2] = {};
+
+		Unorm16x2() = default;
+		Unorm16x2(Vec2 value) { MeshProcessing::EncodeUnorm16(&value.x, components, 2); };
+	};
+
+	struct Unorm16x4
+	{
+		uint16_t components[4] = {};
+
+		Unorm16x4() = default;
+		Unorm16x4(Vec4 value) { MeshProcessing::EncodeUnorm16(&value.x, components, 4); };
+	};
+
+	struct A2B10G10R10Unorm
+	{
+		uint32_t packed = 0;
+
+		A2B10G10R10Unorm() = default;
+		A2B10G10R10Unorm(Vec4 value) { MeshProcessing::EncodeA2B10G10R10Unorm(&value.x, &packed, 1); };
+	};
+
+	struct A2B10G10R10Snorm
+	{
+		uint32_t packed = 0;
+
+		A2B10G10R10Snorm() = default;
+		A2B10G10R10Snorm(Vec4 value) { MeshProcessing::EncodeA2B10G10R10Snorm(&value.x, &packed, 1); };
+	};
+
+	// The format each attribute type is read as. Anything not listed here can't be used with VertexLayout
+	template<typename T> struct VertexFormat;
+	template<> struct VertexFormat<Vec2> { static constexpr VulkanFormat value = VulkanFormat::eVec2; };
+	template<> struct VertexFormat<Vec3> { static constexpr VulkanFormat value = VulkanFormat::eVec3; };
+	template<> struct VertexFormat<Vec4> { static constexpr VulkanFormat value = VulkanFormat::eVec4; };
+	template<> struct VertexFormat<Half2> { static constexpr VulkanFormat value = VulkanFormat::eHalf2; };
+	template<> struct VertexFormat<Half4> { static constexpr VulkanFormat value = VulkanFormat::eHalf4; };
+	template<> struct VertexFormat<Snorm8x4> { static constexpr VulkanFormat value = VulkanFormat::eSnorm8x4; };
+	template<> struct VertexFormat<Unorm8x4> { static constexpr VulkanFormat value = VulkanFormat::eUnorm8x4; };
+	template<> struct VertexFormat<Snorm16x2> { static constexpr VulkanFormat value = VulkanFormat::eSnorm16x2; };
+	template<> struct VertexFormat<Snorm16x4> { static constexpr VulkanFormat value = VulkanFormat::eSnorm16x4; };
+	template<> struct VertexFormat<Unorm16x2> { static constexpr VulkanFormat value = VulkanFormat::eUnorm16x2; };
+	template<> struct VertexFormat<Unorm16x4> { static constexpr VulkanFormat value = VulkanFormat::eUnorm16x4; };
+	template<> struct VertexFormat<A2B10G10R10Unorm> { static constexpr VulkanFormat value = VulkanFormat::eA2B10G10R10Unorm; };
+	template<> struct VertexFormat<A2B10G10R10Snorm> { static constexpr VulkanFormat value = VulkanFormat::eA2B10G10R10Snorm; };
+
+	template<typename T> struct MemberPointerTraits;
+	template<typename ClassType_, typename MemberType_> struct MemberPointerTraits<MemberType_ ClassType_::*>
+	{
+		using ClassType = ClassType_;
+		using MemberType = MemberType_;
+	};
+
+	// Works out a vertex's GetVarInfo at compile time from pointers to its members, e.g. VertexLayout<&Vertex::pos, &Vertex::colour>
+	// Every member has to be listed, in the order they're declared, since the offsets come from the same rules the compiler lays them out with
+	template<auto FirstMember, auto... Members>
+	class VertexLayout
+	{
+		using VertexType = typename MemberPointerTraits<decltype(FirstMember)>::ClassType;
+
+		static constexpr size_t c_memberCount = 1 + sizeof...(Members);
+
+		static constexpr std::array<uint32_t, c_memberCount> c_sizes = {
+			sizeof(typename MemberPointerTraits<decltype(FirstMember)>::MemberType),
+			sizeof(typename MemberPointerTraits<decltype(Members)>::MemberType)...
+		};
+
+		static constexpr std::array<uint32_t, c_memberCount> c_alignments = {
+			alignof(typename MemberPointerTraits<decltype(FirstMember)>::MemberType),
+			alignof(typename MemberPointerTraits<decltype(Members)>::MemberType)...
+		};
+
+		static constexpr std::array<VulkanFormat, c_memberCount> c_formats = {
+			VertexFormat<typename MemberPointerTraits<decltype(FirstMember)>::MemberType>::value,
+			VertexFormat<typename MemberPointerTraits<decltype(Members)>::MemberType>::value...
+		};
+
+		static constexpr uint32_t AlignUp(uint32_t offset, uint32_t alignment) { return (offset + alignment - 1) / alignment * alignment; };
+
+		// Where the last member ends, padded out to the struct's alignment. If this isn't sizeof(VertexType), a member is missing
+		static constexpr uint32_t GetLaidOutSize()
+		{
+			uint32_t offset = 0;
+			uint32_t maxAlignment = 1;
+			for (size_t i = 0; i < c_memberCount; i++)
+			{
+				offset = AlignUp(offset, c_alignments[i]) + c_sizes[i];
+				maxAlignment = std::max(maxAlignment, c_alignments[i]);
+			}
+
+			return AlignUp(offset, maxAlignment);
+		}
+
+	public:
+		static constexpr std::array<std::pair<vk::Format, uint32_t>, c_memberCount> GetVarInfo()
+		{
+			static_assert((std::is_same_v<VertexType, typename MemberPointerTraits<decltype(Members)>::ClassType> && ...),
+						  "Every member has to belong to the same vertex struct");
+			static_assert(std::is_standard_layout_v<VertexType>, "Vertex structs have to be standard layout for their offsets to be worked out");
+			static_assert(GetLaidOutSize() == sizeof(VertexType), "Every member of the vertex struct has to be listed");
+
+			std::array<std::pair<vk::Format, uint32_t>, c_memberCount> varInfo;
+
+			uint32_t offset = 0;
+			for (size_t i = 0; i < c_memberCount; i++)
+			{
+				offset = AlignUp(offset, c_alignments[i]);
+				varInfo[i] = { (vk::Format)c_formats[i], offset };
+				offset += c_sizes[i];
+			}
+
+			return varInfo;
+		}
+	};
+}
\ No newline at end of file
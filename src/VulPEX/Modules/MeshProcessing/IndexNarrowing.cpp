@@ -0,0 +1,83 @@
+#include "IndexNarrowing.hpp"
+
+#include <cstring>
+#include <string>
+#include <stdexcept>
+
+#include "../../Utility/VulPEXSimd.hpp"
+
+namespace MeshProcessing
+{
+	vk::IndexType GetIndexType(uint32_t vertexCount)
+	{
+		return vertexCount <= c_max16BitVertexCount ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+	}
+
+	uint32_t GetIndexSize(vk::IndexType indexType)
+	{
+		switch (indexType)
+		{
+			case vk::IndexType::eUint16: return sizeof(uint16_t);
+			case vk::IndexType::eUint32: return sizeof(uint32_t);
+			default: break;
+		}
+
+		throw std::runtime_error("Index type " + vk::to_string(indexType) + " isn't supported");
+	}
+
+	void NarrowIndices(const uint32_t* source, uint16_t* destination, size_t indexCount)
+	{
+		size_t i = 0;
+
+		#if defined(VULPEX_SIMD_SSE2)
+			for (; i + 8 <= indexCount; i += 8)
+			{
+				__m128i low = _mm_loadu_si128((const __m128i*)(source + i));
+				__m128i high = _mm_loadu_si128((const __m128i*)(source + i + 4));
+
+				// SSE2 can only pack with signed saturation, so sign-extend the low 16 bits first to make the pack exact
+				low = _mm_srai_epi32(_mm_slli_epi32(low, 16), 16);
+				high = _mm_srai_epi32(_mm_slli_epi32(high, 16), 16);
+
+				_mm_storeu_si128((__m128i*)(destination + i), _mm_packs_epi32(low, high));
+			}
+		#elif defined(VULPEX_SIMD_NEON)
+			for (; i + 8 <= indexCount; i += 8)
+			{
+				uint16x4_t low = vmovn_u32(vld1q_u32(source + i));
+				uint16x4_t high = vmovn_u32(vld1q_u32(source + i + 4));
+
+				vst1q_u16(destination + i, vcombine_u16(low, high));
+			}
+		#endif
+
+		// Whatever's left over, or everything if there's no SIMD
+		for (; i < indexCount; i++)
+		{
+			destination[i] = (uint16_t)source[i];
+		}
+	}
+
+	void WriteIndices(const uint32_t* source, void* destination, size_t indexCount, vk::IndexType indexType)
+	{
+		if (indexType == vk::IndexType::eUint16)
+		{
+			NarrowIndices(source, (uint16_t*)destination, indexCount);
+		}
+		else
+		{
+			std::memcpy(destination, source, sizeof(uint32_t) * indexCount);
+		}
+	}
+
+	void ValidateIndices(const uint32_t* indices, size_t indexCount, uint32_t vertexCount)
+	{
+		for (size_t i = 0; i < indexCount; i++)
+		{
+			if (indices[i] >= vertexCount && indices[i] != 0xFFFFFFFF)
+			{
+				throw std::runtime_error("Index " + std::to_string(indices[i]) + " is out of range for a mesh with " + std::to_string(vertexCount) + " vertices");
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "../../Utility/VulkanDynamicInclude.hpp"
+
+namespace MeshProcessing
+{
+	// Below this many vertices, every valid index fits in 16 bits with 0xFFFF left over for primitive restart
+	constexpr uint32_t c_max16BitVertexCount = 0xFFFF;
+
+	// eUint16 whenever the mesh is small enough, so that its indices take half the memory and bandwidth
+	vk::IndexType GetIndexType(uint32_t vertexCount);
+	uint32_t GetIndexSize(vk::IndexType indexType);
+
+	// Keeps the low 16 bits of every index, 8 at a time where SIMD is available
+	// The primitive restart index 0xFFFFFFFF becomes 0xFFFF, which is the 16-bit restart index
+	void NarrowIndices(const uint32_t* source, uint16_t* destination, size_t indexCount);
+
+	// Writes indices into destination as indexType, which has to have room for indexCount of them
+	void WriteIndices(const uint32_t* source, void* destination, size_t indexCount, vk::IndexType indexType);
+
+	// Throws if any index is past the last vertex, which narrowing would otherwise quietly turn into a different, valid one
+	// The primitive restart index 0xFFFFFFFF is let through
+	void ValidateIndices(const uint32_t* indices, size_t indexCount, uint32_t vertexCount);
+}
\ No newline at end of file
@@ -0,0 +1,490 @@
+#include "MeshOptimiser.hpp"
+
+#include <cmath>
+#include <array>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <algorithm>
+#include <stdexcept>
+
+#include "../../Utility/VulPEXMaths.hpp"
+
+namespace MeshProcessing
+{
+	// Private
+	// Forsyth's tuning. The cache is bigger than the one being optimised for, since being too big costs far less than being too small
+	const uint32_t c_forsythCacheSize = 32;
+	const float c_forsythCacheDecayPower = 1.5f;
+	const float c_forsythLastTriangleScore = 0.75f;
+	const float c_forsythValenceBoostScale = 2.0f;
+	const float c_forsythValenceBoostPower = 0.5f;
+
+	static void ValidateTriangles(const std::vector<uint32_t>& indices, uint32_t vertexCount)
+	{
+		if (indices.size() % 3 != 0)
+		{
+			throw std::runtime_error(std::to_string(indices.size()) + " indices aren't a whole number of triangles");
+		}
+
+		for (uint32_t index : indices)
+		{
+			if (index >= vertexCount)
+			{
+				throw std::runtime_error("Index " + std::to_string(index) + " is out of range for a mesh with " + std::to_string(vertexCount) + " vertices");
+			}
+		}
+	}
+
+	// A FIFO cache that's emptied just by moving the clock past every entry, rather than by touching each one
+	class FifoCacheSimulator
+	{
+		std::vector<uint32_t> m_timestamps;
+		uint32_t m_cacheSize;
+		uint32_t m_timestamp;
+
+	public:
+		FifoCacheSimulator(uint32_t vertexCount, uint32_t cacheSize) : m_timestamps(vertexCount, 0), m_cacheSize(cacheSize), m_timestamp(cacheSize + 1) {};
+
+		void Clear() { m_timestamp += m_cacheSize + 1; };
+
+		// Returns how many of the triangle's vertices had to be transformed
+		uint32_t AddTriangle(const uint32_t* triangle)
+		{
+			uint32_t misses = 0;
+			for (uint32_t i = 0; i < 3; i++)
+			{
+				if (m_timestamp - m_timestamps[triangle[i]] > m_cacheSize)
+				{
+					m_timestamps[triangle[i]] = m_timestamp++;
+					misses++;
+				}
+			}
+
+			return misses;
+		}
+	};
+
+	// Scores are looked up so often that working them out each time dominates everything else
+	const uint32_t c_forsythValenceTableSize = 64;
+
+	struct ForsythScoreTables
+	{
+		std::array<float, c_forsythCacheSize> cachePositionScores;
+		std::array<float, c_forsythValenceTableSize> valenceScores;
+
+		ForsythScoreTables()
+		{
+			for (uint32_t position = 0; position < c_forsythCacheSize; position++)
+			{
+				// The last triangle's vertices get a fixed score, so that strips of triangles don't just keep turning back on themselves
+				if (position < 3) { cachePositionScores[position] = c_forsythLastTriangleScore; }
+				else { cachePositionScores[position] = std::pow(1.0f - (float)(position - 3) / (c_forsythCacheSize - 3), c_forsythCacheDecayPower); }
+			}
+
+			for (uint32_t remainingTriangles = 0; remainingTriangles < c_forsythValenceTableSize; remainingTriangles++)
+			{
+				valenceScores[remainingTriangles] = GetValenceScore(remainingTriangles);
+			}
+		}
+
+		// Vertices with few triangles left are finished off first, so they don't get left behind as stragglers
+		static float GetValenceScore(uint32_t remainingTriangles)
+		{
+			return c_forsythValenceBoostScale * std::pow((float)remainingTriangles, -c_forsythValenceBoostPower);
+		}
+	};
+
+	static float GetForsythVertexScore(int32_t cachePosition, uint32_t remainingTriangles)
+	{
+		static const ForsythScoreTables s_tables;
+
+		// Nothing left to draw with it, so it doesn't matter where it is
+		if (remainingTriangles == 0) { return -1; }
+
+		float score = cachePosition >= 0 ? s_tables.cachePositionScores[cachePosition] : 0;
+		score += remainingTriangles < c_forsythValenceTableSize ? s_tables.valenceScores[remainingTriangles] : ForsythScoreTables::GetValenceScore(remainingTriangles);
+
+		return score;
+	}
+
+	// Public
+	VertexCacheStats AnalyseVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize)
+	{
+		ValidateTriangles(indices, vertexCount);
+
+		VertexCacheStats stats;
+		FifoCacheSimulator cache(vertexCount, cacheSize);
+
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			stats.vertexTransforms += cache.AddTriangle(&indices[i]);
+		}
+
+		if (!indices.empty()) { stats.acmr = (float)stats.vertexTransforms / (indices.size() / 3); }
+		if (vertexCount > 0) { stats.atvr = (float)stats.vertexTransforms / vertexCount; }
+
+		return stats;
+	}
+
+	uint32_t GenerateDeduplicationRemap(const void* vertexData, uint32_t sizeOfVertex, uint32_t vertexCount, std::vector<uint32_t>& remap)
+	{
+		const char* vertices = (const char*)vertexData;
+
+		// Keyed on the vertex's bytes themselves, which stay put for as long as this needs them
+		std::unordered_map<std::string_view, uint32_t> uniqueVertices;
+		uniqueVertices.reserve(vertexCount);
+
+		remap.resize(vertexCount);
+		for (uint32_t i = 0; i < vertexCount; i++)
+		{
+			std::string_view vertex(vertices + (size_t)i * sizeOfVertex, sizeOfVertex);
+			remap[i] = uniqueVertices.emplace(vertex, (uint32_t)uniqueVertices.size()).first->second;
+		}
+
+		return uniqueVertices.size();
+	}
+
+	uint32_t GenerateVertexFetchRemap(const std::vector<uint32_t>& indices, uint32_t vertexCount, std::vector<uint32_t>& remap)
+	{
+		ValidateTriangles(indices, vertexCount);
+
+		remap.assign(vertexCount, UINT32_MAX);
+
+		uint32_t nextVertex = 0;
+		for (uint32_t index : indices)
+		{
+			if (remap[index] == UINT32_MAX) { remap[index] = nextVertex++; }
+		}
+
+		return nextVertex;
+	}
+
+	void RemapIndices(std::vector<uint32_t>& indices, const std::vector<uint32_t>& remap)
+	{
+		for (uint32_t& index : indices)
+		{
+			index = remap[index];
+		}
+	}
+
+	std::vector<char> RemapVertices(const void* vertexData, uint32_t sizeOfVertex, uint32_t vertexCount, const std::vector<uint32_t>& remap,
+									uint32_t newVertexCount)
+	{
+		const char* vertices = (const char*)vertexData;
+		std::vector<char> remappedVertices((size_t)newVertexCount * sizeOfVertex);
+
+		for (uint32_t i = 0; i < vertexCount; i++)
+		{
+			if (remap[i] == UINT32_MAX) { continue; }
+
+			std::memcpy(remappedVertices.data() + (size_t)remap[i] * sizeOfVertex, vertices + (size_t)i * sizeOfVertex, sizeOfVertex);
+		}
+
+		return remappedVertices;
+	}
+
+	void OptimiseVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount)
+	{
+		ValidateTriangles(indices, vertexCount);
+
+		size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0) { return; }
+
+		// Every vertex's triangles that haven't been drawn yet, packed into one array. Drawn triangles are swapped to the end and forgotten
+		std::vector<uint32_t> remainingTriangles(vertexCount, 0);
+		for (uint32_t index : indices) { remainingTriangles[index]++; }
+
+		std::vector<uint32_t> adjacencyOffsets(vertexCount, 0);
+		for (uint32_t vertex = 1; vertex < vertexCount; vertex++)
+		{
+			adjacencyOffsets[vertex] = adjacencyOffsets[vertex - 1] + remainingTriangles[vertex - 1];
+		}
+
+		std::vector<uint32_t> adjacency(indices.size());
+		std::vector<uint32_t> adjacencyFilled(vertexCount, 0);
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			uint32_t vertex = indices[i];
+			adjacency[adjacencyOffsets[vertex] + adjacencyFilled[vertex]++] = i / 3;
+		}
+
+		std::vector<int32_t> cachePositions(vertexCount, -1);
+		std::vector<float> vertexScores(vertexCount);
+		for (uint32_t vertex = 0; vertex < vertexCount; vertex++)
+		{
+			vertexScores[vertex] = GetForsythVertexScore(-1, remainingTriangles[vertex]);
+		}
+
+		std::vector<float> triangleScores(triangleCount);
+		for (size_t triangle = 0; triangle < triangleCount; triangle++)
+		{
+			const uint32_t* vertices = &indices[triangle * 3];
+			triangleScores[triangle] = vertexScores[vertices[0]] + vertexScores[vertices[1]] + vertexScores[vertices[2]];
+		}
+
+		std::vector<bool> triangleDrawn(triangleCount, false);
+		std::vector<size_t> vertexStamps(vertexCount, 0);
+
+		std::vector<uint32_t> cache;
+		std::vector<uint32_t> newCache;
+		cache.reserve(c_forsythCacheSize + 3);
+		newCache.reserve(c_forsythCacheSize + 3);
+
+		std::vector<uint32_t> optimisedIndices;
+		optimisedIndices.reserve(indices.size());
+
+		int64_t bestTriangle = std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin();
+		size_t nextUndrawnTriangle = 0;
+
+		for (size_t drawn = 0; drawn < triangleCount; drawn++)
+		{
+			// Nothing in the cache has any triangles left, so carry on from the first one that hasn't been drawn
+			// Forsyth scans every triangle for the best score here instead, which gets quadratic on meshes made of lots of small pieces
+			if (bestTriangle < 0)
+			{
+				while (triangleDrawn[nextUndrawnTriangle]) { nextUndrawnTriangle++; }
+				bestTriangle = nextUndrawnTriangle;
+			}
+
+			const uint32_t* vertices = &indices[bestTriangle * 3];
+			triangleDrawn[bestTriangle] = true;
+			optimisedIndices.insert(optimisedIndices.end(), vertices, vertices + 3);
+
+			for (uint32_t i = 0; i < 3; i++)
+			{
+				uint32_t vertex = vertices[i];
+				uint32_t* begin = adjacency.data() + adjacencyOffsets[vertex];
+				uint32_t* end = begin + remainingTriangles[vertex];
+
+				std::iter_swap(std::find(begin, end, (uint32_t)bestTriangle), end - 1);
+				remainingTriangles[vertex]--;
+			}
+
+			// The triangle's vertices go to the front, and everything else shuffles back
+			// Stamping them with the triangle's number avoids searching the cache for duplicates
+			newCache.clear();
+			for (uint32_t i = 0; i < 3; i++)
+			{
+				if (vertexStamps[vertices[i]] != drawn + 1)
+				{
+					vertexStamps[vertices[i]] = drawn + 1;
+					newCache.push_back(vertices[i]);
+				}
+			}
+
+			for (uint32_t vertex : cache)
+			{
+				if (vertexStamps[vertex] != drawn + 1) { newCache.push_back(vertex); }
+			}
+
+			for (uint32_t i = 0; i < newCache.size(); i++)
+			{
+				cachePositions[newCache[i]] = i < c_forsythCacheSize ? (int32_t)i : -1;
+			}
+
+			// Every vertex that moved, including the ones that just fell out, changes the score of all its remaining triangles
+			for (uint32_t vertex : newCache)
+			{
+				float score = GetForsythVertexScore(cachePositions[vertex], remainingTriangles[vertex]);
+				float scoreChange = score - vertexScores[vertex];
+				vertexScores[vertex] = score;
+
+				for (uint32_t i = 0; i < remainingTriangles[vertex]; i++)
+				{
+					triangleScores[adjacency[adjacencyOffsets[vertex] + i]] += scoreChange;
+				}
+			}
+
+			newCache.resize(std::min<size_t>(newCache.size(), c_forsythCacheSize));
+			std::swap(cache, newCache);
+
+			// Only triangles that use something in the cache are worth considering
+			bestTriangle = -1;
+			float bestScore = -1;
+			for (uint32_t vertex : cache)
+			{
+				for (uint32_t i = 0; i < remainingTriangles[vertex]; i++)
+				{
+					uint32_t triangle = adjacency[adjacencyOffsets[vertex] + i];
+					if (triangleScores[triangle] > bestScore)
+					{
+						bestScore = triangleScores[triangle];
+						bestTriangle = triangle;
+					}
+				}
+			}
+		}
+
+		indices = std::move(optimisedIndices);
+	}
+
+	void OptimiseOverdraw(std::vector<uint32_t>& indices, const void* positionData, uint32_t positionStride, uint32_t positionComponents,
+						  uint32_t vertexCount, float threshold)
+	{
+		ValidateTriangles(indices, vertexCount);
+
+		if (positionComponents != 2 && positionComponents != 3)
+		{
+			throw std::runtime_error("Positions need 2 or 3 components, not " + std::to_string(positionComponents));
+		}
+
+		size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0) { return; }
+
+		// A triangle that misses on every vertex doesn't care what came before it, so the order can be broken there for free
+		FifoCacheSimulator cache(vertexCount, c_defaultCacheSize);
+
+		std::vector<size_t> hardBoundaries;
+		for (size_t triangle = 0; triangle < triangleCount; triangle++)
+		{
+			if (cache.AddTriangle(&indices[triangle * 3]) == 3) { hardBoundaries.push_back(triangle); }
+		}
+
+		hardBoundaries.push_back(triangleCount);
+
+		// Hard clusters tend to be huge, so they're split further wherever the ACMR so far is within threshold of the whole cluster's
+		std::vector<size_t> clusterStarts;
+		for (size_t hardCluster = 0; hardCluster + 1 < hardBoundaries.size(); hardCluster++)
+		{
+			size_t start = hardBoundaries[hardCluster];
+			size_t end = hardBoundaries[hardCluster + 1];
+
+			cache.Clear();
+			uint32_t clusterMisses = 0;
+			for (size_t triangle = start; triangle < end; triangle++) { clusterMisses += cache.AddTriangle(&indices[triangle * 3]); }
+
+			float missThreshold = threshold * clusterMisses / (end - start);
+
+			cache.Clear();
+			clusterStarts.push_back(start);
+
+			uint32_t runningMisses = 0;
+			size_t runningStart = start;
+			for (size_t triangle = start; triangle < end; triangle++)
+			{
+				runningMisses += cache.AddTriangle(&indices[triangle * 3]);
+
+				if (triangle + 1 < end && runningMisses <= missThreshold * (triangle + 1 - runningStart))
+				{
+					clusterStarts.push_back(triangle + 1);
+
+					cache.Clear();
+					runningMisses = 0;
+					runningStart = triangle + 1;
+				}
+			}
+		}
+
+		clusterStarts.push_back(triangleCount);
+
+		const char* positions = (const char*)positionData;
+		auto getPosition = [&](uint32_t vertex)
+		{
+			const float* position = (const float*)(positions + (size_t)vertex * positionStride);
+			return Vec3(position[0], position[1], positionComponents == 3 ? position[2] : 0.0f);
+		};
+
+		Vec3 meshCentroid(0);
+		for (uint32_t index : indices) { meshCentroid += getPosition(index); }
+		meshCentroid /= (float)indices.size();
+
+		// Clusters facing away from the centre are the ones most likely to be in front of everything else
+		size_t clusterCount = clusterStarts.size() - 1;
+		std::vector<float> clusterSortKeys(clusterCount);
+
+		for (size_t cluster = 0; cluster < clusterCount; cluster++)
+		{
+			Vec3 centroid(0);
+			Vec3 normal(0);
+			float totalArea = 0;
+
+			for (size_t triangle = clusterStarts[cluster]; triangle < clusterStarts[cluster + 1]; triangle++)
+			{
+				Vec3 a = getPosition(indices[triangle * 3]);
+				Vec3 b = getPosition(indices[triangle * 3 + 1]);
+				Vec3 c = getPosition(indices[triangle * 3 + 2]);
+
+				// Twice the triangle's area, pointing along its normal
+				Vec3 areaNormal = glm::cross(b - a, c - a);
+				float area = glm::length(areaNormal);
+
+				centroid += (a + b + c) * (area / 3);
+				normal += areaNormal;
+				totalArea += area;
+			}
+
+			float normalLength = glm::length(normal);
+			if (totalArea <= 0 || normalLength <= 0) { continue; }
+
+			clusterSortKeys[cluster] = glm::dot(centroid / totalArea - meshCentroid, normal / normalLength);
+		}
+
+		std::vector<size_t> clusterOrder(clusterCount);
+		for (size_t cluster = 0; cluster < clusterCount; cluster++) { clusterOrder[cluster] = cluster; }
+
+		std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&](size_t a, size_t b) { return clusterSortKeys[a] > clusterSortKeys[b]; });
+
+		std::vector<uint32_t> sortedIndices;
+		sortedIndices.reserve(indices.size());
+
+		for (size_t cluster : clusterOrder)
+		{
+			sortedIndices.insert(sortedIndices.end(), indices.begin() + clusterStarts[cluster] * 3, indices.begin() + clusterStarts[cluster + 1] * 3);
+		}
+
+		indices = std::move(sortedIndices);
+	}
+
+	MeshOptimisationStats OptimiseMesh(std::vector<char>& vertexData, uint32_t sizeOfVertex, std::vector<uint32_t>& indices,
+									   std::optional<std::pair<vk::Format, uint32_t>> position)
+	{
+		if (sizeOfVertex == 0 || vertexData.size() % sizeOfVertex != 0)
+		{
+			throw std::runtime_error("Vertex data isn't a whole number of " + std::to_string(sizeOfVertex) + " byte vertices");
+		}
+
+		uint32_t positionComponents = 0;
+		if (position.has_value())
+		{
+			if (position->first == vk::Format::eR32G32Sfloat) { positionComponents = 2; }
+			else if (position->first == vk::Format::eR32G32B32Sfloat) { positionComponents = 3; }
+			else { throw std::runtime_error("Positions can't be read from " + vk::to_string(position->first) + " for overdraw optimisation"); }
+		}
+
+		uint32_t vertexCount = vertexData.size() / sizeOfVertex;
+
+		MeshOptimisationStats stats;
+		stats.vertexCountBefore = vertexCount;
+		stats.before = AnalyseVertexCache(indices, vertexCount);
+
+		std::vector<uint32_t> remap;
+
+		uint32_t uniqueVertexCount = GenerateDeduplicationRemap(vertexData.data(), sizeOfVertex, vertexCount, remap);
+		if (uniqueVertexCount < vertexCount)
+		{
+			vertexData = RemapVertices(vertexData.data(), sizeOfVertex, vertexCount, remap, uniqueVertexCount);
+			RemapIndices(indices, remap);
+			vertexCount = uniqueVertexCount;
+		}
+
+		OptimiseVertexCache(indices, vertexCount);
+
+		if (position.has_value())
+		{
+			OptimiseOverdraw(indices, vertexData.data() + position->second, sizeOfVertex, positionComponents, vertexCount);
+		}
+
+		// Last, since it only renames vertices and leaves the triangle order alone
+		uint32_t usedVertexCount = GenerateVertexFetchRemap(indices, vertexCount, remap);
+		vertexData = RemapVertices(vertexData.data(), sizeOfVertex, vertexCount, remap, usedVertexCount);
+		RemapIndices(indices, remap);
+		vertexCount = usedVertexCount;
+
+		stats.vertexCountAfter = vertexCount;
+		stats.after = AnalyseVertexCache(indices, vertexCount);
+
+		return stats;
+	}
+}
\ No newline at end of file
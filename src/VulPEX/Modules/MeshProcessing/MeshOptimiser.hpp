@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+#include <optional>
+#include <utility>
+#include <cstdint>
+
+#include "../../Utility/VulkanDynamicInclude.hpp"
+
+namespace MeshProcessing
+{
+	// Roughly what desktop GPUs behave like. The real caches aren't FIFOs of a fixed size, so this is a guide rather than a measurement
+	constexpr uint32_t c_defaultCacheSize = 16;
+
+	// How well a triangle list's order reuses a FIFO post-transform vertex cache
+	struct VertexCacheStats
+	{
+		uint32_t vertexTransforms = 0;
+
+		// Average cache miss ratio, or transforms per triangle. 3 means no reuse at all, and about 0.5 is the best a regular grid can do
+		float acmr = 0;
+		// Average transform to vertex ratio, or transforms per vertex. 1 means every vertex is only transformed once
+		float atvr = 0;
+	};
+
+	struct MeshOptimisationStats
+	{
+		uint32_t vertexCountBefore = 0;
+		uint32_t vertexCountAfter = 0;
+
+		VertexCacheStats before;
+		VertexCacheStats after;
+	};
+
+	// Everything here works on triangle lists, and throws if the indices aren't a whole number of triangles or refer to vertices that don't exist
+	VertexCacheStats AnalyseVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = c_defaultCacheSize);
+
+	// Fills remap with the new index of every vertex, where vertices with identical bytes share an index. Returns the number of unique vertices
+	// Padding is compared too, so vertices need to have had it zeroed for their duplicates to be found
+	uint32_t GenerateDeduplicationRemap(const void* vertexData, uint32_t sizeOfVertex, uint32_t vertexCount, std::vector<uint32_t>& remap);
+
+	// Fills remap with the order the indices first use each vertex in, so that vertices are fetched from memory roughly in order
+	// Vertices that are never used are remapped to UINT32_MAX and dropped. Returns the number of vertices that are used
+	uint32_t GenerateVertexFetchRemap(const std::vector<uint32_t>& indices, uint32_t vertexCount, std::vector<uint32_t>& remap);
+
+	void RemapIndices(std::vector<uint32_t>& indices, const std::vector<uint32_t>& remap);
+	// Vertices remapped to UINT32_MAX are left out. newVertexCount is whatever generated the remap returned
+	std::vector<char> RemapVertices(const void* vertexData, uint32_t sizeOfVertex, uint32_t vertexCount, const std::vector<uint32_t>& remap,
+									uint32_t newVertexCount);
+
+	// Reorders triangles so that each one reuses as many recently transformed vertices as possible, using Tom Forsyth's linear-speed algorithm
+	void OptimiseVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount);
+
+	// Splits an already cache-optimised triangle order into clusters and draws the most outward-facing ones first, so that they hide
+	// the rest from the fragment shader. threshold is how much worse the ACMR is allowed to get, e.g. 1.05 for 5%
+	// Positions are read as positionComponents floats, 2 or 3, every positionStride bytes
+	void OptimiseOverdraw(std::vector<uint32_t>& indices, const void* positionData, uint32_t positionStride, uint32_t positionComponents,
+						  uint32_t vertexCount, float threshold = 1.05f);
+
+	// Deduplicates, optimises for the vertex cache, then for overdraw if position is given, then for vertex fetch
+	// position is the format and offset of the position attribute, which has to be eVec2 or eVec3
+	MeshOptimisationStats OptimiseMesh(std::vector<char>& vertexData, uint32_t sizeOfVertex, std::vector<uint32_t>& indices,
+									   std::optional<std::pair<vk::Format, uint32_t>> position = std::nullopt);
+}
\ No newline at end of file
@@ -0,0 +1,365 @@
+#include "MeshSimplifier.hpp"
+
+#include <cmath>
+#include <string>
+#include <algorithm>
+#include <unordered_map>
+#include <optional>
+#include <stdexcept>
+
+#include "../../Utility/VulkanDynamicInclude.hpp"
+#include "../../Utility/VulPEXMaths.hpp"
+
+namespace MeshProcessing
+{
+	// Private
+	// A level has to lose at least this fraction of the previous level's indices to be worth keeping
+	const float c_minLodReduction = 0.1f;
+
+	// The sum of squared distances to a set of planes, as a symmetric 4x4 matrix. Doubles, since the terms cancel out badly in floats
+	// Planes are weighted by their triangle's area, and dividing by the total weight turns the sum into a mean
+	struct Quadric
+	{
+		double a2 = 0, ab = 0, ac = 0, ad = 0;
+		double b2 = 0, bc = 0, bd = 0;
+		double c2 = 0, cd = 0;
+		double d2 = 0;
+
+		double weight = 0;
+
+		Quadric() = default;
+
+		Quadric(Vec3 normal, double d, double weight_)
+		{
+			double a = normal.x, b = normal.y, c = normal.z;
+
+			a2 = a * a * weight_; ab = a * b * weight_; ac = a * c * weight_; ad = a * d * weight_;
+			b2 = b * b * weight_; bc = b * c * weight_; bd = b * d * weight_;
+			c2 = c * c * weight_; cd = c * d * weight_;
+			d2 = d * d * weight_;
+
+			weight = weight_;
+		}
+
+		Quadric& operator+=(const Quadric& other)
+		{
+			a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+			b2 += other.b2; bc += other.bc; bd += other.bd;
+			c2 += other.c2; cd += other.cd;
+			d2 += other.d2;
+
+			weight += other.weight;
+			return *this;
+		}
+
+		// Mean squared distance from the point to the planes
+		double GetError(Vec3 point) const
+		{
+			double x = point.x, y = point.y, z = point.z;
+
+			double error = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x +
+						   b2 * y * y + 2 * bc * y * z + 2 * bd * y +
+						   c2 * z * z + 2 * cd * z +
+						   d2;
+
+			// Rounding can take it just below zero
+			return weight > 0 ? std::max(error, 0.0) / weight : 0;
+		}
+	};
+
+	struct Collapse
+	{
+		uint32_t from = 0;
+		uint32_t to = 0;
+		double error = 0;
+	};
+
+	// Everything that carries over from one collapse pass to the next, so that an LOD chain can keep going where the last level stopped
+	struct SimplifierState
+	{
+		std::vector<Vec3> positions;
+		std::vector<bool> locked;
+		std::vector<Quadric> quadrics;
+
+		std::vector<uint32_t> indices;
+		double worstCollapseError = 0;
+	};
+
+	static Vec3 GetPosition(const char* positions, uint32_t positionStride, uint32_t positionComponents, uint32_t vertex)
+	{
+		const float* position = (const float*)(positions + (size_t)vertex * positionStride);
+		return Vec3(position[0], position[1], positionComponents == 3 ? position[2] : 0.0f);
+	}
+
+	// Whether moving from onto to would turn any of from's other triangles over
+	static bool CollapseFlipsTriangle(const std::vector<uint32_t>& indices, const std::vector<Vec3>& positions, const std::vector<uint32_t>& triangleOffsets,
+									  const std::vector<uint32_t>& triangles, uint32_t from, uint32_t to)
+	{
+		for (uint32_t i = triangleOffsets[from]; i < triangleOffsets[from + 1]; i++)
+		{
+			const uint32_t* triangle = &indices[triangles[i] * 3];
+
+			// Triangles using both vertices are the ones the collapse removes
+			if (triangle[0] == to || triangle[1] == to || triangle[2] == to) { continue; }
+
+			Vec3 before[3];
+			Vec3 after[3];
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				before[corner] = positions[triangle[corner]];
+				after[corner] = triangle[corner] == from ? positions[to] : before[corner];
+			}
+
+			Vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+			Vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+
+			if (glm::dot(normalBefore, normalAfter) <= 0) { return true; }
+		}
+
+		return false;
+	}
+
+	static SimplifierState CreateSimplifierState(const std::vector<uint32_t>& indices, const void* positionData, uint32_t positionStride,
+												 uint32_t positionComponents, uint32_t vertexCount)
+	{
+		if (indices.size() % 3 != 0)
+		{
+			throw std::runtime_error(std::to_string(indices.size()) + " indices aren't a whole number of triangles");
+		}
+
+		if (positionComponents != 2 && positionComponents != 3)
+		{
+			throw std::runtime_error("Positions need 2 or 3 components, not " + std::to_string(positionComponents));
+		}
+
+		for (uint32_t index : indices)
+		{
+			if (index >= vertexCount)
+			{
+				throw std::runtime_error("Index " + std::to_string(index) + " is out of range for a mesh with " + std::to_string(vertexCount) + " vertices");
+			}
+		}
+
+		SimplifierState state;
+
+		std::vector<Vec3>& positions = state.positions;
+		positions.resize(vertexCount);
+		for (uint32_t vertex = 0; vertex < vertexCount; vertex++)
+		{
+			positions[vertex] = GetPosition((const char*)positionData, positionStride, positionComponents, vertex);
+		}
+
+		std::vector<bool>& locked = state.locked;
+		locked.assign(vertexCount, false);
+
+		// Seams. Keyed on the position's bytes, so -0 and 0 count as different, which only means the odd vertex isn't locked when it could be
+		std::unordered_map<std::string, uint32_t> positionUses;
+		for (uint32_t vertex = 0; vertex < vertexCount; vertex++)
+		{
+			positionUses[std::string((const char*)&positions[vertex], sizeof(Vec3))]++;
+		}
+
+		for (uint32_t vertex = 0; vertex < vertexCount; vertex++)
+		{
+			if (positionUses[std::string((const char*)&positions[vertex], sizeof(Vec3))] > 1) { locked[vertex] = true; }
+		}
+
+		// Borders, where an edge only has one triangle on it
+		std::unordered_map<uint64_t, uint32_t> edgeUses;
+		auto getEdgeKey = [](uint32_t a, uint32_t b) { return ((uint64_t)std::min(a, b) << 32) | std::max(a, b); };
+
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				edgeUses[getEdgeKey(indices[i + corner], indices[i + (corner + 1) % 3])]++;
+			}
+		}
+
+		for (const std::pair<const uint64_t, uint32_t>& edge : edgeUses)
+		{
+			if (edge.second == 1)
+			{
+				locked[edge.first >> 32] = true;
+				locked[edge.first & 0xFFFFFFFF] = true;
+			}
+		}
+
+		std::vector<Quadric>& quadrics = state.quadrics;
+		quadrics.resize(vertexCount);
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			Vec3 a = positions[indices[i]];
+			Vec3 b = positions[indices[i + 1]];
+			Vec3 c = positions[indices[i + 2]];
+
+			Vec3 areaNormal = glm::cross(b - a, c - a);
+			float doubleArea = glm::length(areaNormal);
+			if (doubleArea <= 0) { continue; }
+
+			Vec3 normal = areaNormal / doubleArea;
+			Quadric quadric(normal, -glm::dot(normal, a), doubleArea * 0.5);
+
+			quadrics[indices[i]] += quadric;
+			quadrics[indices[i + 1]] += quadric;
+			quadrics[indices[i + 2]] += quadric;
+		}
+
+		state.indices = indices;
+
+		return state;
+	}
+
+	static void Simplify(SimplifierState& state, size_t targetIndexCount, float maxError)
+	{
+		const std::vector<Vec3>& positions = state.positions;
+		const std::vector<bool>& locked = state.locked;
+		std::vector<Quadric>& quadrics = state.quadrics;
+		std::vector<uint32_t>& result = state.indices;
+
+		uint32_t vertexCount = positions.size();
+		double maxErrorSquared = (double)maxError * maxError;
+
+		std::vector<uint32_t> triangleOffsets(vertexCount + 1);
+		std::vector<uint32_t> triangles;
+		std::vector<std::pair<uint32_t, uint32_t>> edges;
+		std::vector<Collapse> collapses;
+		std::vector<bool> touched(vertexCount);
+		std::vector<uint32_t> remap(vertexCount);
+
+		// Each pass collapses a set of edges that don't share any triangles, so they can't interfere with each other
+		while (result.size() > targetIndexCount)
+		{
+			// Every vertex's triangles, packed into one array
+			std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0);
+			for (uint32_t index : result) { triangleOffsets[index + 1]++; }
+			for (uint32_t vertex = 0; vertex < vertexCount; vertex++) { triangleOffsets[vertex + 1] += triangleOffsets[vertex]; }
+
+			triangles.resize(result.size());
+			std::vector<uint32_t> filled(triangleOffsets.begin(), triangleOffsets.end() - 1);
+			for (size_t i = 0; i < result.size(); i++) { triangles[filled[result[i]]++] = i / 3; }
+
+			edges.clear();
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					uint32_t a = result[i + corner];
+					uint32_t b = result[i + (corner + 1) % 3];
+					edges.push_back({ std::min(a, b), std::max(a, b) });
+				}
+			}
+
+			std::sort(edges.begin(), edges.end());
+			edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+			// Each edge can collapse either way. Whichever way is cheaper and allowed is the one considered
+			collapses.clear();
+			for (const std::pair<uint32_t, uint32_t>& edge : edges)
+			{
+				Quadric combined = quadrics[edge.first];
+				combined += quadrics[edge.second];
+
+				std::optional<Collapse> best;
+				if (!locked[edge.first]) { best = Collapse{ edge.first, edge.second, combined.GetError(positions[edge.second]) }; }
+
+				if (!locked[edge.second])
+				{
+					double error = combined.GetError(positions[edge.first]);
+					if (!best.has_value() || error < best->error) { best = Collapse{ edge.second, edge.first, error }; }
+				}
+
+				if (best.has_value() && best->error <= maxErrorSquared) { collapses.push_back(best.value()); }
+			}
+
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.error < b.error; });
+
+			// Each collapse takes about two triangles with it
+			size_t trianglesToRemove = (result.size() - targetIndexCount + 2) / 3;
+			size_t collapseBudget = (trianglesToRemove + 1) / 2;
+
+			std::fill(touched.begin(), touched.end(), false);
+			for (uint32_t vertex = 0; vertex < vertexCount; vertex++) { remap[vertex] = vertex; }
+
+			size_t collapseCount = 0;
+			for (const Collapse& collapse : collapses)
+			{
+				if (collapseCount >= collapseBudget) { break; }
+				if (touched[collapse.from] || touched[collapse.to]) { continue; }
+				if (CollapseFlipsTriangle(result, positions, triangleOffsets, triangles, collapse.from, collapse.to)) { continue; }
+
+				remap[collapse.from] = collapse.to;
+				quadrics[collapse.to] += quadrics[collapse.from];
+				state.worstCollapseError = std::max(state.worstCollapseError, collapse.error);
+				collapseCount++;
+
+				// Nothing else this pass can use the triangles around from, since their shape has already changed
+				for (uint32_t i = triangleOffsets[collapse.from]; i < triangleOffsets[collapse.from + 1]; i++)
+				{
+					const uint32_t* triangle = &result[triangles[i] * 3];
+					touched[triangle[0]] = true;
+					touched[triangle[1]] = true;
+					touched[triangle[2]] = true;
+				}
+			}
+
+			if (collapseCount == 0) { break; }
+
+			// Triangles that lost an edge are now degenerate, and go
+			size_t written = 0;
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				uint32_t a = remap[result[i]];
+				uint32_t b = remap[result[i + 1]];
+				uint32_t c = remap[result[i + 2]];
+
+				if (a == b || b == c || c == a) { continue; }
+
+				result[written++] = a;
+				result[written++] = b;
+				result[written++] = c;
+			}
+
+			result.resize(written);
+		}
+	}
+
+	// Public
+	std::vector<uint32_t> SimplifyMesh(const std::vector<uint32_t>& indices, const void* positionData, uint32_t positionStride,
+									   uint32_t positionComponents, uint32_t vertexCount, size_t targetIndexCount, float maxError,
+									   float* resultError)
+	{
+		SimplifierState state = CreateSimplifierState(indices, positionData, positionStride, positionComponents, vertexCount);
+		Simplify(state, targetIndexCount, maxError);
+
+		if (resultError != nullptr) { *resultError = (float)std::sqrt(state.worstCollapseError); }
+
+		return std::move(state.indices);
+	}
+
+	std::vector<LodLevel> GenerateLodChain(const std::vector<uint32_t>& indices, const void* positionData, uint32_t positionStride,
+										   uint32_t positionComponents, uint32_t vertexCount, uint32_t maxLodCount, float reduction,
+										   float maxError)
+	{
+		std::vector<LodLevel> lods;
+		lods.push_back({ indices, 0 });
+
+		// The quadrics still measure distance to the original mesh's planes, so carrying on from one level to the next is the same as
+		// simplifying the original further, just without starting over each time
+		SimplifierState state = CreateSimplifierState(indices, positionData, positionStride, positionComponents, vertexCount);
+
+		size_t targetIndexCount = indices.size();
+		while (lods.size() < maxLodCount)
+		{
+			targetIndexCount = (size_t)(targetIndexCount * reduction) / 3 * 3;
+			if (targetIndexCount == 0) { break; }
+
+			Simplify(state, targetIndexCount, maxError);
+			if (state.indices.empty() || state.indices.size() > lods.back().indices.size() * (1 - c_minLodReduction)) { break; }
+
+			lods.push_back({ state.indices, (float)std::sqrt(state.worstCollapseError) });
+		}
+
+		return lods;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cfloat>
+
+namespace MeshProcessing
+{
+	struct LodLevel
+	{
+		std::vector<uint32_t> indices;
+
+		// Roughly how far, in the same units as the positions, the simplified surface strays from the original
+		float error = 0;
+	};
+
+	// Collapses edges, cheapest quadric error first, until there are at most targetIndexCount indices left or the next collapse
+	// would stray further than maxError. Vertices are only ever merged into each other, so the result indexes the same vertices
+	// Vertices on open borders, and ones that share their position with another vertex (usually a UV or normal seam), never move,
+	// so holes and seams don't open up. Throws if the indices aren't a whole number of triangles
+	// Positions are read as positionComponents floats, 2 or 3, every positionStride bytes
+	std::vector<uint32_t> SimplifyMesh(const std::vector<uint32_t>& indices, const void* positionData, uint32_t positionStride,
+									   uint32_t positionComponents, uint32_t vertexCount, size_t targetIndexCount, float maxError = FLT_MAX,
+									   float* resultError = nullptr);
+
+	// LOD 0 is the mesh as given, and each level after it aims for reduction times as many triangles as the one before
+	// Each level carries on simplifying from the one before, with errors still measured against the original mesh, so they only
+	// ever grow from one level to the next. Stops early once a level can't be made meaningfully smaller than the one before
+	std::vector<LodLevel> GenerateLodChain(const std::vector<uint32_t>& indices, const void* positionData, uint32_t positionStride,
+										   uint32_t positionComponents, uint32_t vertexCount, uint32_t maxLodCount, float reduction = 0.5f,
+										   float maxError = FLT_MAX);
+}
\ No newline at end of file
@@ -0,0 +1,480 @@
+#include "VertexEncoding.hpp"
+
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+#include <bit>
+#include <string>
+#include <stdexcept>
+
+#include "../../Utility/VulPEXSimd.hpp"
+
+namespace MeshProcessing
+{
+	// Private
+	// Unlike std::clamp, NaNs become low. This is what the SIMD paths do too, so every path gives the same result
+	static float Clamp(float value, float low, float high)
+	{
+		value = value > low ? value : low;
+		return value < high ? value : high;
+	}
+
+	// Rounds with the current rounding mode, which is to nearest even unless someone's changed it, the same as the SIMD conversions
+	static int32_t Quantise(float value, float low, float high, float scale)
+	{
+		return (int32_t)std::nearbyint(Clamp(value, low, high) * scale);
+	}
+
+	// Rounds to nearest even, and turns anything too big into infinity and every NaN into the same quiet NaN
+	static uint16_t FloatToHalf(float value)
+	{
+		const uint32_t f32Infinity = 255u << 23;
+		const uint32_t f16Max = (127u + 16) << 23;
+		const uint32_t minNormal = (127u - 14) << 23;
+		const uint32_t subnormalMagic = ((127u - 15) + (23 - 10) + 1) << 23;
+
+		uint32_t bits = std::bit_cast<uint32_t>(value);
+		uint32_t sign = bits & 0x80000000u;
+		bits ^= sign;
+
+		uint32_t half;
+		if (bits >= f16Max)
+		{
+			half = bits > f32Infinity ? 0x7E00 : 0x7C00;
+		}
+		else if (bits < minNormal)
+		{
+			// Adding the magic number lines the mantissa up so that the float adder does the rounding for us
+			half = std::bit_cast<uint32_t>(std::bit_cast<float>(bits) + std::bit_cast<float>(subnormalMagic)) - subnormalMagic;
+		}
+		else
+		{
+			uint32_t mantissaOdd = (bits >> 13) & 1;
+			bits += ((15u - 127) << 23) + 0xFFF + mantissaOdd;
+			half = bits >> 13;
+		}
+
+		return half | (sign >> 16);
+	}
+
+	static uint32_t PackA2B10G10R10(const float* rgba, bool isSigned)
+	{
+		uint32_t r, g, b, a;
+		if (isSigned)
+		{
+			r = Quantise(rgba[0], -1, 1, 511) & 0x3FF;
+			g = Quantise(rgba[1], -1, 1, 511) & 0x3FF;
+			b = Quantise(rgba[2], -1, 1, 511) & 0x3FF;
+			a = Quantise(rgba[3], -1, 1, 1) & 0x3;
+		}
+		else
+		{
+			r = Quantise(rgba[0], 0, 1, 1023);
+			g = Quantise(rgba[1], 0, 1, 1023);
+			b = Quantise(rgba[2], 0, 1, 1023);
+			a = Quantise(rgba[3], 0, 1, 3);
+		}
+
+		return r | (g << 10) | (b << 20) | (a << 30);
+	}
+
+	#if defined(VULPEX_SIMD_SSE2)
+		static __m128i QuantiseSSE2(const float* source, __m128 low, __m128 high, __m128 scale)
+		{
+			// max returns its second operand for NaNs, so they become low
+			__m128 value = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(source), low), high);
+			return _mm_cvtps_epi32(_mm_mul_ps(value, scale));
+		}
+
+		// The same as FloatToHalf, 4 at a time, using only integer tricks since F16C isn't guaranteed. Results are sign-extended to 32 bits
+		static __m128i FloatToHalfSSE2(__m128 value)
+		{
+			const __m128i f16Max = _mm_set1_epi32((127 + 16) << 23);
+			const __m128i minNormal = _mm_set1_epi32((127 - 14) << 23);
+			const __m128i subnormalMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+			const __m128i normalBias = _mm_set1_epi32(0xFFF - ((127 - 15) << 23));
+
+			__m128 sign = _mm_and_ps(value, _mm_castsi128_ps(_mm_set1_epi32(0x80000000)));
+			__m128 absolute = _mm_xor_ps(value, sign);
+			__m128i absoluteBits = _mm_castps_si128(absolute);
+
+			__m128i isNaN = _mm_castps_si128(_mm_cmpunord_ps(absolute, absolute));
+			__m128i isRegular = _mm_cmpgt_epi32(f16Max, absoluteBits);
+			__m128i isSubnormal = _mm_cmpgt_epi32(minNormal, absoluteBits);
+			__m128i special = _mm_or_si128(_mm_and_si128(isNaN, _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7C00));
+
+			__m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(absolute, _mm_castsi128_ps(subnormalMagic))), subnormalMagic);
+
+			// -1 where the half's mantissa would be odd, so subtracting it rounds ties to even
+			__m128i mantissaOdd = _mm_srai_epi32(_mm_slli_epi32(absoluteBits, 31 - 13), 31);
+			__m128i normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(absoluteBits, normalBias), mantissaOdd), 13);
+
+			__m128i regular = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+			__m128i half = _mm_or_si128(_mm_and_si128(isRegular, regular), _mm_andnot_si128(isRegular, special));
+
+			return _mm_or_si128(half, _mm_srai_epi32(_mm_castps_si128(sign), 16));
+		}
+
+		static void PackA2B10G10R10SSE2(const float* source, uint32_t* destination, bool isSigned)
+		{
+			__m128 r = _mm_loadu_ps(source);
+			__m128 g = _mm_loadu_ps(source + 4);
+			__m128 b = _mm_loadu_ps(source + 8);
+			__m128 a = _mm_loadu_ps(source + 12);
+			_MM_TRANSPOSE4_PS(r, g, b, a);
+
+			__m128 low = _mm_set1_ps(isSigned ? -1.0f : 0.0f);
+			__m128 high = _mm_set1_ps(1.0f);
+			__m128 rgbScale = _mm_set1_ps(isSigned ? 511.0f : 1023.0f);
+			__m128 alphaScale = _mm_set1_ps(isSigned ? 1.0f : 3.0f);
+
+			__m128i rgbMask = _mm_set1_epi32(0x3FF);
+			__m128i alphaMask = _mm_set1_epi32(0x3);
+
+			auto quantise = [&](__m128 value, __m128 scale, __m128i mask)
+			{
+				return _mm_and_si128(_mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(value, low), high), scale)), mask);
+			};
+
+			__m128i packed = quantise(r, rgbScale, rgbMask);
+			packed = _mm_or_si128(packed, _mm_slli_epi32(quantise(g, rgbScale, rgbMask), 10));
+			packed = _mm_or_si128(packed, _mm_slli_epi32(quantise(b, rgbScale, rgbMask), 20));
+			packed = _mm_or_si128(packed, _mm_slli_epi32(quantise(a, alphaScale, alphaMask), 30));
+
+			_mm_storeu_si128((__m128i*)destination, packed);
+		}
+	#elif defined(VULPEX_SIMD_NEON)
+		static float32x4_t ClampNEON(const float* source, float low, float high)
+		{
+			// The nm variants return the number rather than the NaN, so NaNs become low
+			return vminnmq_f32(vmaxnmq_f32(vld1q_f32(source), vdupq_n_f32(low)), vdupq_n_f32(high));
+		}
+
+		static void PackA2B10G10R10NEON(const float* source, uint32_t* destination, bool isSigned)
+		{
+			// Loads 4 RGBA values split out into 4 vectors of R, G, B and A
+			float32x4x4_t rgba = vld4q_f32(source);
+
+			float low = isSigned ? -1.0f : 0.0f;
+			float rgbScale = isSigned ? 511.0f : 1023.0f;
+			float alphaScale = isSigned ? 1.0f : 3.0f;
+
+			auto quantise = [&](float32x4_t value, float scale, uint32_t mask)
+			{
+				value = vminnmq_f32(vmaxnmq_f32(value, vdupq_n_f32(low)), vdupq_n_f32(1.0f));
+				return vandq_u32(vreinterpretq_u32_s32(vcvtnq_s32_f32(vmulq_n_f32(value, scale))), vdupq_n_u32(mask));
+			};
+
+			uint32x4_t packed = quantise(rgba.val[0], rgbScale, 0x3FF);
+			packed = vorrq_u32(packed, vshlq_n_u32(quantise(rgba.val[1], rgbScale, 0x3FF), 10));
+			packed = vorrq_u32(packed, vshlq_n_u32(quantise(rgba.val[2], rgbScale, 0x3FF), 20));
+			packed = vorrq_u32(packed, vshlq_n_u32(quantise(rgba.val[3], alphaScale, 0x3), 30));
+
+			vst1q_u32(destination, packed);
+		}
+	#endif
+
+	// Public
+	void EncodeHalf(const float* source, uint16_t* destination, size_t count)
+	{
+		size_t i = 0;
+
+		#if defined(VULPEX_SIMD_SSE2)
+			for (; i + 8 <= count; i += 8)
+			{
+				// Every half is already sign-extended, so the saturating pack leaves them alone
+				__m128i low = FloatToHalfSSE2(_mm_loadu_ps(source + i));
+				__m128i high = FloatToHalfSSE2(_mm_loadu_ps(source + i + 4));
+				_mm_storeu_si128((__m128i*)(destination + i), _mm_packs_epi32(low, high));
+			}
+		#elif defined(VULPEX_SIMD_NEON)
+			for (; i + 8 <= count; i += 8)
+			{
+				uint16x4_t low = vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(source + i)));
+				uint16x4_t high = vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(source + i + 4)));
+				vst1q_u16(destination + i, vcombine_u16(low, high));
+			}
+		#endif
+
+		for (; i < count; i++)
+		{
+			destination[i] = FloatToHalf(source[i]);
+		}
+	}
+
+	void EncodeSnorm8(const float* source, int8_t* destination, size_t count)
+	{
+		size_t i = 0;
+
+		#if defined(VULPEX_SIMD_SSE2)
+			__m128 low = _mm_set1_ps(-1.0f);
+			__m128 high = _mm_set1_ps(1.0f);
+			__m128 scale = _mm_set1_ps(127.0f);
+
+			for (; i + 16 <= count; i += 16)
+			{
+				__m128i first = _mm_packs_epi32(QuantiseSSE2(source + i, low, high, scale), QuantiseSSE2(source + i + 4, low, high, scale));
+				__m128i second = _mm_packs_epi32(QuantiseSSE2(source + i + 8, low, high, scale), QuantiseSSE2(source + i + 12, low, high, scale));
+				_mm_storeu_si128((__m128i*)(destination + i), _mm_packs_epi16(first, second));
+			}
+		#elif defined(VULPEX_SIMD_NEON)
+			for (; i + 8 <= count; i += 8)
+			{
+				int16x4_t first = vqmovn_s32(vcvtnq_s32_f32(vmulq_n_f32(ClampNEON(source + i, -1, 1), 127)));
+				int16x4_t second = vqmovn_s32(vcvtnq_s32_f32(vmulq_n_f32(ClampNEON(source + i + 4, -1, 1), 127)));
+				vst1_s8(destination + i, vqmovn_s16(vcombine_s16(first, second)));
+			}
+		#endif
+
+		for (; i < count; i++)
+		{
+			destination[i] = (int8_t)Quantise(source[i], -1, 1, 127);
+		}
+	}
+
+	void EncodeUnorm8(const float* source, uint8_t* destination, size_t count)
+	{
+		size_t i = 0;
+
+		#if defined(VULPEX_SIMD_SSE2)
+			__m128 low = _mm_set1_ps(0.0f);
+			__m128 high = _mm_set1_ps(1.0f);
+			__m128 scale = _mm_set1_ps(255.0f);
+
+			for (; i + 16 <= count; i += 16)
+			{
+				__m128i first = _mm_packs_epi32(QuantiseSSE2(source + i, low, high, scale), QuantiseSSE2(source + i + 4, low, high, scale));
+				__m128i second = _mm_packs_epi32(QuantiseSSE2(source + i + 8, low, high, scale), QuantiseSSE2(source + i + 12, low, high, scale));
+				_mm_storeu_si128((__m128i*)(destination + i), _mm_packus_epi16(first, second));
+			}
+		#elif defined(VULPEX_SIMD_NEON)
+			for (; i + 8 <= count; i += 8)
+			{
+				uint16x4_t first = vqmovn_u32(vcvtnq_u32_f32(vmulq_n_f32(ClampNEON(source + i, 0, 1), 255)));
+				uint16x4_t second = vqmovn_u32(vcvtnq_u32_f32(vmulq_n_f32(ClampNEON(source + i + 4, 0, 1), 255)));
+				vst1_u8(destination + i, vqmovn_u16(vcombine_u16(first, second)));
+			}
+		#endif
+
+		for (; i < count; i++)
+		{
+			destination[i] = (uint8_t)Quantise(source[i], 0, 1, 255);
+		}
+	}
+
+	void EncodeSnorm16(const float* source, int16_t* destination, size_t count)
+	{
+		size_t i = 0;
+
+		#if defined(VULPEX_SIMD_SSE2)
+			__m128 low = _mm_set1_ps(-1.0f);
+			__m128 high = _mm_set1_ps(1.0f);
+			__m128 scale = _mm_set1_ps(32767.0f);
+
+			for (; i + 8 <= count; i += 8)
+			{
+				__m128i packed = _mm_packs_epi32(QuantiseSSE2(source + i, low, high, scale), QuantiseSSE2(source + i + 4, low, high, scale));
+				_mm_storeu_si128((__m128i*)(destination + i), packed);
+			}
+		#elif defined(VULPEX_SIMD_NEON)
+			for (; i + 8 <= count; i += 8)
+			{
+				int16x4_t first = vqmovn_s32(vcvtnq_s32_f32(vmulq_n_f32(ClampNEON(source + i, -1, 1), 32767)));
+				int16x4_t second = vqmovn_s32(vcvtnq_s32_f32(vmulq_n_f32(ClampNEON(source + i + 4, -1, 1), 32767)));
+				vst1q_s16(destination + i, vcombine_s16(first, second));
+			}
+		#endif
+
+		for (; i < count; i++)
+		{
+			destination[i] = (int16_t)Quantise(source[i], -1, 1, 32767);
+		}
+	}
+
+	void EncodeUnorm16(const float* source, uint16_t* destination, size_t count)
+	{
+		size_t i = 0;
+
+		#if defined(VULPEX_SIMD_SSE2)
+			__m128 low = _mm_set1_ps(0.0f);
+			__m128 high = _mm_set1_ps(1.0f);
+			__m128 scale = _mm_set1_ps(65535.0f);
+			__m128i bias = _mm_set1_epi32(0x8000);
+
+			for (; i + 8 <= count; i += 8)
+			{
+				// SSE2 can only pack with signed saturation, so shift into the signed range to pack, then flip the top bit back
+				__m128i first = _mm_sub_epi32(QuantiseSSE2(source + i, low, high, scale), bias);
+				__m128i second = _mm_sub_epi32(QuantiseSSE2(source + i + 4, low, high, scale), bias);
+				__m128i packed = _mm_xor_si128(_mm_packs_epi32(first, second), _mm_set1_epi16((short)0x8000));
+				_mm_storeu_si128((__m128i*)(destination + i), packed);
+			}
+		#elif defined(VULPEX_SIMD_NEON)
+			for (; i + 8 <= count; i += 8)
+			{
+				uint16x4_t first = vqmovn_u32(vcvtnq_u32_f32(vmulq_n_f32(ClampNEON(source + i, 0, 1), 65535)));
+				uint16x4_t second = vqmovn_u32(vcvtnq_u32_f32(vmulq_n_f32(ClampNEON(source + i + 4, 0, 1), 65535)));
+				vst1q_u16(destination + i, vcombine_u16(first, second));
+			}
+		#endif
+
+		for (; i < count; i++)
+		{
+			destination[i] = (uint16_t)Quantise(source[i], 0, 1, 65535);
+		}
+	}
+
+	void EncodeA2B10G10R10Unorm(const float* source, uint32_t* destination, size_t count)
+	{
+		size_t i = 0;
+
+		#if defined(VULPEX_SIMD_SSE2)
+			for (; i + 4 <= count; i += 4) { PackA2B10G10R10SSE2(source + 4 * i, destination + i, false); }
+		#elif defined(VULPEX_SIMD_NEON)
+			for (; i + 4 <= count; i += 4) { PackA2B10G10R10NEON(source + 4 * i, destination + i, false); }
+		#endif
+
+		for (; i < count; i++)
+		{
+			destination[i] = PackA2B10G10R10(source + 4 * i, false);
+		}
+	}
+
+	void EncodeA2B10G10R10Snorm(const float* source, uint32_t* destination, size_t count)
+	{
+		size_t i = 0;
+
+		#if defined(VULPEX_SIMD_SSE2)
+			for (; i + 4 <= count; i += 4) { PackA2B10G10R10SSE2(source + 4 * i, destination + i, true); }
+		#elif defined(VULPEX_SIMD_NEON)
+			for (; i + 4 <= count; i += 4) { PackA2B10G10R10NEON(source + 4 * i, destination + i, true); }
+		#endif
+
+		for (; i < count; i++)
+		{
+			destination[i] = PackA2B10G10R10(source + 4 * i, true);
+		}
+	}
+
+	uint32_t GetComponentCount(vk::Format format)
+	{
+		switch (format)
+		{
+			case vk::Format::eR32G32Sfloat:
+			case vk::Format::eR16G16Sfloat:
+			case vk::Format::eR16G16Snorm:
+			case vk::Format::eR16G16Unorm:
+				return 2;
+			case vk::Format::eR32G32B32Sfloat:
+				return 3;
+			case vk::Format::eR32G32B32A32Sfloat:
+			case vk::Format::eR16G16B16A16Sfloat:
+			case vk::Format::eR8G8B8A8Snorm:
+			case vk::Format::eR8G8B8A8Unorm:
+			case vk::Format::eR16G16B16A16Snorm:
+			case vk::Format::eR16G16B16A16Unorm:
+			case vk::Format::eA2B10G10R10UnormPack32:
+			case vk::Format::eA2B10G10R10SnormPack32:
+				return 4;
+			default:
+				break;
+		}
+
+		throw std::runtime_error("Vertex format " + vk::to_string(format) + " isn't supported");
+	}
+
+	void EncodeVertices(const void* sourceData, uint32_t sizeOfSourceVertex, const std::pair<vk::Format, uint32_t>* sourceVarsInfo,
+						void* destinationData, uint32_t sizeOfDestinationVertex, const std::pair<vk::Format, uint32_t>* destinationVarsInfo,
+						size_t varsInfoCount, uint32_t vertexCount)
+	{
+		// Attributes are gathered into a contiguous block a chunk at a time, encoded in one go, then scattered back out
+		const uint32_t c_chunkSize = 256;
+		float components[c_chunkSize * 4];
+		uint32_t encoded[c_chunkSize * 4];
+
+		const char* source = (const char*)sourceData;
+		char* destination = (char*)destinationData;
+
+		for (size_t var = 0; var < varsInfoCount; var++)
+		{
+			vk::Format sourceFormat = sourceVarsInfo[var].first;
+			vk::Format destinationFormat = destinationVarsInfo[var].first;
+
+			if (sourceFormat != vk::Format::eR32G32Sfloat && sourceFormat != vk::Format::eR32G32B32Sfloat && sourceFormat != vk::Format::eR32G32B32A32Sfloat)
+			{
+				throw std::runtime_error("Vertex attribute " + std::to_string(var) + " can't be encoded from " + vk::to_string(sourceFormat) +
+										 ", only from 32-bit floats");
+			}
+
+			uint32_t sourceComponents = GetComponentCount(sourceFormat);
+			uint32_t destinationComponents = GetComponentCount(destinationFormat);
+
+			for (uint32_t firstVertex = 0; firstVertex < vertexCount; firstVertex += c_chunkSize)
+			{
+				uint32_t chunkVertexCount = std::min(c_chunkSize, vertexCount - firstVertex);
+				size_t componentCount = (size_t)chunkVertexCount * destinationComponents;
+
+				for (uint32_t i = 0; i < chunkVertexCount; i++)
+				{
+					const float* sourceVertex = (const float*)(source + (size_t)(firstVertex + i) * sizeOfSourceVertex + sourceVarsInfo[var].second);
+					float* vertexComponents = components + (size_t)i * destinationComponents;
+
+					for (uint32_t component = 0; component < destinationComponents; component++)
+					{
+						vertexComponents[component] = component < sourceComponents ? sourceVertex[component] : (component == 3 ? 1.0f : 0.0f);
+					}
+				}
+
+				uint32_t sizeOfAttribute;
+				switch (destinationFormat)
+				{
+					case vk::Format::eR32G32Sfloat:
+					case vk::Format::eR32G32B32Sfloat:
+					case vk::Format::eR32G32B32A32Sfloat:
+						std::memcpy(encoded, components, sizeof(float) * componentCount);
+						sizeOfAttribute = sizeof(float) * destinationComponents;
+						break;
+					case vk::Format::eR16G16Sfloat:
+					case vk::Format::eR16G16B16A16Sfloat:
+						EncodeHalf(components, (uint16_t*)encoded, componentCount);
+						sizeOfAttribute = sizeof(uint16_t) * destinationComponents;
+						break;
+					case vk::Format::eR8G8B8A8Snorm:
+						EncodeSnorm8(components, (int8_t*)encoded, componentCount);
+						sizeOfAttribute = sizeof(int8_t) * destinationComponents;
+						break;
+					case vk::Format::eR8G8B8A8Unorm:
+						EncodeUnorm8(components, (uint8_t*)encoded, componentCount);
+						sizeOfAttribute = sizeof(uint8_t) * destinationComponents;
+						break;
+					case vk::Format::eR16G16Snorm:
+					case vk::Format::eR16G16B16A16Snorm:
+						EncodeSnorm16(components, (int16_t*)encoded, componentCount);
+						sizeOfAttribute = sizeof(int16_t) * destinationComponents;
+						break;
+					case vk::Format::eR16G16Unorm:
+					case vk::Format::eR16G16B16A16Unorm:
+						EncodeUnorm16(components, (uint16_t*)encoded, componentCount);
+						sizeOfAttribute = sizeof(uint16_t) * destinationComponents;
+						break;
+					case vk::Format::eA2B10G10R10UnormPack32:
+						EncodeA2B10G10R10Unorm(components, encoded, chunkVertexCount);
+						sizeOfAttribute = sizeof(uint32_t);
+						break;
+					case vk::Format::eA2B10G10R10SnormPack32:
+						EncodeA2B10G10R10Snorm(components, encoded, chunkVertexCount);
+						sizeOfAttribute = sizeof(uint32_t);
+						break;
+					default:
+						throw std::runtime_error("Vertex attribute " + std::to_string(var) + " can't be encoded to " + vk::to_string(destinationFormat));
+				}
+
+				for (uint32_t i = 0; i < chunkVertexCount; i++)
+				{
+					std::memcpy(destination + (size_t)(firstVertex + i) * sizeOfDestinationVertex + destinationVarsInfo[var].second,
+								(const char*)encoded + (size_t)i * sizeOfAttribute, sizeOfAttribute);
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
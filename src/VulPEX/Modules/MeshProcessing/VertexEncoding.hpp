@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+#include "../../Utility/VulkanDynamicInclude.hpp"
+
+namespace MeshProcessing
+{
+	// Each of these converts count floats into count components, 8 or 16 at a time where SIMD is available
+	// Normalised values are clamped to their range first, and everything rounds to nearest even, just like the GPU would
+	void EncodeHalf(const float* source, uint16_t* destination, size_t count);
+	void EncodeSnorm8(const float* source, int8_t* destination, size_t count);
+	void EncodeUnorm8(const float* source, uint8_t* destination, size_t count);
+	void EncodeSnorm16(const float* source, int16_t* destination, size_t count);
+	void EncodeUnorm16(const float* source, uint16_t* destination, size_t count);
+
+	// source is count RGBA values, 4 floats each. A is stored in the top two bits of each, and R in the bottom ten
+	void EncodeA2B10G10R10Unorm(const float* source, uint32_t* destination, size_t count);
+	void EncodeA2B10G10R10Snorm(const float* source, uint32_t* destination, size_t count);
+
+	// The number of components a vertex attribute of this format holds, e.g. 4 for eA2B10G10R10Unorm. Throws for formats it doesn't know
+	uint32_t GetComponentCount(vk::Format format);
+
+	// Converts vertices described by sourceVarsInfo into the layout described by destinationVarsInfo, attribute by attribute
+	// Source attributes have to be 32-bit floats. Components the source doesn't have are filled in as 0, or 1 for the fourth, like
+	// Vulkan does when fetching them. Components the destination doesn't have are dropped
+	void EncodeVertices(const void* sourceData, uint32_t sizeOfSourceVertex, const std::pair<vk::Format, uint32_t>* sourceVarsInfo,
+						void* destinationData, uint32_t sizeOfDestinationVertex, const std::pair<vk::Format, uint32_t>* destinationVarsInfo,
+						size_t varsInfoCount, uint32_t vertexCount);
+
+	// For vertex structs with a GetVarInfo, whose attributes are listed in the same order
+	template<typename PackedVertexType, typename SourceVertexType>
+	std::vector<PackedVertexType> EncodeVertices(const std::vector<SourceVertexType>& verts)
+	{
+		std::array sourceVarsInfo = SourceVertexType::GetVarInfo();
+		std::array packedVarsInfo = PackedVertexType::GetVarInfo();
+		static_assert(std::tuple_size_v<decltype(sourceVarsInfo)> == std::tuple_size_v<decltype(packedVarsInfo)>,
+					  "Packed vertices need the same number of attributes as the vertices they're made from");
+
+		std::vector<PackedVertexType> packedVerts(verts.size());
+		EncodeVertices(verts.data(), sizeof(SourceVertexType), sourceVarsInfo.data(), packedVerts.data(), sizeof(PackedVertexType),
+					   packedVarsInfo.data(), packedVarsInfo.size(), verts.size());
+
+		return packedVerts;
+	}
+}
\ No newline at end of file
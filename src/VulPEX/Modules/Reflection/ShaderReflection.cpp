@@ -0,0 +1,676 @@
+#include "ShaderReflection.hpp"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <iterator>
+
+namespace Reflection
+{
+	// Just the parts of the SPIR-V spec that we need, straight out of spirv.h
+	namespace Spv
+	{
+		constexpr uint32_t c_magicNumber = 0x07230203;
+		constexpr uint32_t c_headerWordCount = 5;
+
+		enum Op : uint32_t
+		{
+			OpEntryPoint = 15,
+			OpExecutionMode = 16,
+			OpTypeVoid = 19,
+			OpTypeBool = 20,
+			OpTypeInt = 21,
+			OpTypeFloat = 22,
+			OpTypeVector = 23,
+			OpTypeMatrix = 24,
+			OpTypeImage = 25,
+			OpTypeSampler = 26,
+			OpTypeSampledImage = 27,
+			OpTypeArray = 28,
+			OpTypeRuntimeArray = 29,
+			OpTypeStruct = 30,
+			OpTypePointer = 32,
+			OpConstant = 43,
+			OpFunction = 54,
+			OpFunctionEnd = 56,
+			OpFunctionCall = 57,
+			OpVariable = 59,
+			OpDecorate = 71,
+			OpMemberDecorate = 72,
+			OpTypeAccelerationStructureKHR = 5341
+		};
+
+		enum Decoration : uint32_t
+		{
+			Block = 2,
+			BufferBlock = 3,
+			ArrayStride = 6,
+			MatrixStride = 7,
+			BuiltIn = 11,
+			Location = 30,
+			Binding = 33,
+			DescriptorSet = 34,
+			Offset = 35
+		};
+
+		enum ExecutionMode : uint32_t
+		{
+			LocalSize = 17
+		};
+
+		enum StorageClass : uint32_t
+		{
+			UniformConstant = 0,
+			Input = 1,
+			Uniform = 2,
+			Function = 7,
+			PushConstant = 9,
+			StorageBuffer = 12
+		};
+
+		enum ExecutionModel : uint32_t
+		{
+			Vertex = 0,
+			TessellationControl = 1,
+			TessellationEvaluation = 2,
+			Geometry = 3,
+			Fragment = 4,
+			GLCompute = 5
+		};
+
+		enum Dim : uint32_t
+		{
+			DimBuffer = 5,
+			DimSubpassData = 6
+		};
+	}
+
+	// Everything we learn about one result ID as we go through the module
+	struct SpvId
+	{
+		uint32_t opcode = 0;
+
+		// Types
+		uint32_t width = 0;
+		bool isSigned = false;
+		uint32_t componentType = 0;
+		uint32_t componentCount = 0;
+		uint32_t arrayLengthId = 0;
+		std::vector<uint32_t> memberTypes;
+		uint32_t imageDim = 0;
+		uint32_t imageSampled = 0;
+
+		// Pointers and variables
+		uint32_t storageClass = 0;
+		uint32_t pointeeType = 0;
+
+		// Constants, only the low word matters for array lengths
+		uint32_t constantValue = 0;
+
+		// Decorations
+		bool hasLocation = false;
+		uint32_t location = 0;
+		uint32_t binding = 0;
+		uint32_t descriptorSet = 0;
+		bool isBuiltIn = false;
+		bool isBlock = false;
+		bool isBufferBlock = false;
+		uint32_t arrayStride = 0;
+		std::vector<uint32_t> memberOffsets;
+		std::vector<uint32_t> memberMatrixStrides;
+	};
+
+	// The global variables a function's body mentions, and the functions it calls
+	struct SpvFunction
+	{
+		std::vector<uint32_t> referencedVariables;
+		std::vector<uint32_t> calledFunctions;
+	};
+
+	class SpvModule
+	{
+		std::vector<SpvId> m_ids;
+		std::unordered_map<uint32_t, SpvFunction> m_functions;
+
+		// Walks every function the entry point can reach
+		void FindStaticallyUsedVariables();
+
+	public:
+		std::vector<uint32_t> variables;
+
+		uint32_t entryPointModel = UINT32_MAX;
+		uint32_t entryPointFunction = UINT32_MAX;
+		std::vector<uint32_t> entryPointInterface;
+
+		// Every global variable the entry point's call tree touches. Before SPIR-V 1.4 the interface only lists inputs and
+		// outputs, so resources used by other entry points in the same module can only be told apart this way
+		std::unordered_set<uint32_t> entryPointVariables;
+
+		// Only compute shaders have one
+		uint32_t localSize[3] = { 1, 1, 1 };
+
+		void Parse(const std::vector<char>& bytecode, const std::string& entryPoint);
+
+		const SpvId& Get(uint32_t id) const { return m_ids.at(id); };
+
+		uint32_t GetTypeSize(uint32_t typeId, uint32_t matrixStride = 0) const;
+		uint32_t GetArrayLength(uint32_t typeId) const;
+	};
+
+	void SpvModule::Parse(const std::vector<char>& bytecode, const std::string& entryPoint)
+	{
+		if (bytecode.size() % 4 != 0 || bytecode.size() < Spv::c_headerWordCount * 4)
+		{
+			throw std::runtime_error("Shader bytecode is too short, or not a whole number of words");
+		}
+
+		std::vector<uint32_t> words(bytecode.size() / 4);
+		std::memcpy(words.data(), bytecode.data(), bytecode.size());
+
+		if (words[0] != Spv::c_magicNumber)
+		{
+			throw std::runtime_error("Shader bytecode is not SPIR-V");
+		}
+
+		// The header's bound is one higher than the largest ID in the module
+		m_ids.resize(words[3]);
+
+		// Global variables are always declared before any function, so by the time we're inside one we know which IDs they are
+		SpvFunction* currentFunction = nullptr;
+
+		for (size_t i = Spv::c_headerWordCount; i < words.size();)
+		{
+			uint32_t opcode = words[i] & 0xFFFF;
+			uint32_t wordCount = words[i] >> 16;
+
+			if (wordCount == 0 || i + wordCount > words.size())
+			{
+				throw std::runtime_error("Shader bytecode contains a malformed instruction");
+			}
+
+			const uint32_t* operands = &words[i + 1];
+			const uint32_t* instructionEnd = &words[i] + wordCount;
+
+			if (currentFunction != nullptr && opcode != Spv::OpFunctionEnd)
+			{
+				// Literals can happen to match a variable's ID, which at worst keeps a resource the entry point doesn't use
+				for (const uint32_t* operand = operands; operand < instructionEnd; operand++)
+				{
+					if (*operand < m_ids.size() && m_ids[*operand].opcode == Spv::OpVariable && m_ids[*operand].storageClass != Spv::Function)
+					{
+						currentFunction->referencedVariables.push_back(*operand);
+					}
+				}
+			}
+
+			switch (opcode)
+			{
+				case Spv::OpFunction:
+					currentFunction = &m_functions[operands[1]];
+					break;
+
+				case Spv::OpFunctionEnd:
+					currentFunction = nullptr;
+					break;
+
+				case Spv::OpFunctionCall:
+					if (currentFunction != nullptr) { currentFunction->calledFunctions.push_back(operands[2]); }
+					break;
+
+				case Spv::OpEntryPoint:
+				{
+					// The name is a null-terminated string padded out to a whole number of words, and the interface IDs follow it
+					const char* name = (const char*)&operands[2];
+					size_t maxNameLength = (wordCount - 3) * 4;
+					size_t nameLength = strnlen(name, maxNameLength);
+
+					if (entryPoint == std::string(name, nameLength))
+					{
+						entryPointModel = operands[0];
+						entryPointFunction = operands[1];
+						entryPointInterface.assign(std::min(&operands[2] + nameLength / 4 + 1, instructionEnd), instructionEnd);
+					}
+					break;
+				}
+
+				case Spv::OpExecutionMode:
+					// Entry points are always declared before their execution modes, so we already know which function is ours
+					if (operands[0] == entryPointFunction && operands[1] == Spv::LocalSize)
+					{
+						localSize[0] = operands[2];
+						localSize[1] = operands[3];
+						localSize[2] = operands[4];
+					}
+					break;
+
+				case Spv::OpTypeVoid:
+				case Spv::OpTypeBool:
+				case Spv::OpTypeSampler:
+				case Spv::OpTypeSampledImage:
+				case Spv::OpTypeAccelerationStructureKHR:
+					m_ids.at(operands[0]).opcode = opcode;
+					break;
+
+				case Spv::OpTypeInt:
+					m_ids.at(operands[0]).opcode = opcode;
+					m_ids.at(operands[0]).width = operands[1];
+					m_ids.at(operands[0]).isSigned = operands[2] != 0;
+					break;
+
+				case Spv::OpTypeFloat:
+					m_ids.at(operands[0]).opcode = opcode;
+					m_ids.at(operands[0]).width = operands[1];
+					break;
+
+				case Spv::OpTypeVector:
+				case Spv::OpTypeMatrix:
+					m_ids.at(operands[0]).opcode = opcode;
+					m_ids.at(operands[0]).componentType = operands[1];
+					m_ids.at(operands[0]).componentCount = operands[2];
+					break;
+
+				case Spv::OpTypeImage:
+					m_ids.at(operands[0]).opcode = opcode;
+					m_ids.at(operands[0]).imageDim = operands[2];
+					m_ids.at(operands[0]).imageSampled = operands[6];
+					break;
+
+				case Spv::OpTypeArray:
+					m_ids.at(operands[0]).opcode = opcode;
+					m_ids.at(operands[0]).componentType = operands[1];
+					m_ids.at(operands[0]).arrayLengthId = operands[2];
+					break;
+
+				case Spv::OpTypeRuntimeArray:
+					m_ids.at(operands[0]).opcode = opcode;
+					m_ids.at(operands[0]).componentType = operands[1];
+					break;
+
+				case Spv::OpTypeStruct:
+					m_ids.at(operands[0]).opcode = opcode;
+					m_ids.at(operands[0]).memberTypes.assign(&operands[1], instructionEnd);
+					break;
+
+				case Spv::OpTypePointer:
+					m_ids.at(operands[0]).opcode = opcode;
+					m_ids.at(operands[0]).storageClass = operands[1];
+					m_ids.at(operands[0]).pointeeType = operands[2];
+					break;
+
+				case Spv::OpConstant:
+					m_ids.at(operands[1]).opcode = opcode;
+					m_ids.at(operands[1]).constantValue = operands[2];
+					break;
+
+				case Spv::OpVariable:
+					m_ids.at(operands[1]).opcode = opcode;
+					m_ids.at(operands[1]).pointeeType = operands[0];
+					m_ids.at(operands[1]).storageClass = operands[2];
+					variables.push_back(operands[1]);
+					break;
+
+				case Spv::OpDecorate:
+				{
+					SpvId& target = m_ids.at(operands[0]);
+					switch (operands[1])
+					{
+						case Spv::Location: target.hasLocation = true; target.location = operands[2]; break;
+						case Spv::Binding: target.binding = operands[2]; break;
+						case Spv::DescriptorSet: target.descriptorSet = operands[2]; break;
+						case Spv::BuiltIn: target.isBuiltIn = true; break;
+						case Spv::Block: target.isBlock = true; break;
+						case Spv::BufferBlock: target.isBufferBlock = true; break;
+						case Spv::ArrayStride: target.arrayStride = operands[2]; break;
+					}
+					break;
+				}
+
+				case Spv::OpMemberDecorate:
+				{
+					SpvId& target = m_ids.at(operands[0]);
+					uint32_t member = operands[1];
+
+					if (operands[2] == Spv::Offset)
+					{
+						target.memberOffsets.resize(std::max<size_t>(target.memberOffsets.size(), member + 1), 0);
+						target.memberOffsets[member] = operands[3];
+					}
+					else if (operands[2] == Spv::MatrixStride)
+					{
+						target.memberMatrixStrides.resize(std::max<size_t>(target.memberMatrixStrides.size(), member + 1), 0);
+						target.memberMatrixStrides[member] = operands[3];
+					}
+					else if (operands[2] == Spv::BuiltIn)
+					{
+						// Members of gl_PerVertex, which we never need
+						target.isBuiltIn = true;
+					}
+					break;
+				}
+			}
+
+			i += wordCount;
+		}
+
+		if (entryPointModel == UINT32_MAX)
+		{
+			throw std::runtime_error("Shader bytecode has no entry point called \"" + entryPoint + "\"");
+		}
+
+		FindStaticallyUsedVariables();
+	}
+
+	void SpvModule::FindStaticallyUsedVariables()
+	{
+		entryPointVariables.insert(entryPointInterface.begin(), entryPointInterface.end());
+
+		std::unordered_set<uint32_t> visitedFunctions = { entryPointFunction };
+		std::vector<uint32_t> functionsToVisit = { entryPointFunction };
+
+		while (!functionsToVisit.empty())
+		{
+			std::unordered_map<uint32_t, SpvFunction>::const_iterator it = m_functions.find(functionsToVisit.back());
+			functionsToVisit.pop_back();
+
+			if (it == m_functions.end()) { continue; }
+
+			entryPointVariables.insert(it->second.referencedVariables.begin(), it->second.referencedVariables.end());
+
+			for (uint32_t calledFunction : it->second.calledFunctions)
+			{
+				if (visitedFunctions.insert(calledFunction).second) { functionsToVisit.push_back(calledFunction); }
+			}
+		}
+	}
+
+	uint32_t SpvModule::GetArrayLength(uint32_t typeId) const
+	{
+		const SpvId& type = Get(typeId);
+		if (type.opcode == Spv::OpTypeRuntimeArray)
+		{
+			throw std::runtime_error("Runtime-sized descriptor arrays need descriptor indexing, which isn't supported yet");
+		}
+
+		return type.opcode == Spv::OpTypeArray ? Get(type.arrayLengthId).constantValue : 1;
+	}
+
+	uint32_t SpvModule::GetTypeSize(uint32_t typeId, uint32_t matrixStride) const
+	{
+		const SpvId& type = Get(typeId);
+
+		switch (type.opcode)
+		{
+			case Spv::OpTypeInt:
+			case Spv::OpTypeFloat:
+				return type.width / 8;
+
+			case Spv::OpTypeVector:
+				return GetTypeSize(type.componentType) * type.componentCount;
+
+			case Spv::OpTypeMatrix:
+				// Columns are padded out to the stride the shader declared, e.g. a mat3 in std140 has 16 byte columns
+				return (matrixStride != 0 ? matrixStride : GetTypeSize(type.componentType)) * type.componentCount;
+
+			case Spv::OpTypeArray:
+			{
+				uint32_t elementSize = type.arrayStride != 0 ? type.arrayStride : GetTypeSize(type.componentType, matrixStride);
+				return elementSize * Get(type.arrayLengthId).constantValue;
+			}
+
+			case Spv::OpTypeStruct:
+			{
+				// The last member isn't necessarily the one that ends furthest in, so check all of them
+				uint32_t size = 0;
+				for (size_t i = 0; i < type.memberTypes.size(); i++)
+				{
+					uint32_t offset = i < type.memberOffsets.size() ? type.memberOffsets[i] : 0;
+					uint32_t memberMatrixStride = i < type.memberMatrixStrides.size() ? type.memberMatrixStrides[i] : 0;
+
+					size = std::max(size, offset + GetTypeSize(type.memberTypes[i], memberMatrixStride));
+				}
+
+				return size;
+			}
+		}
+
+		return 0;
+	}
+
+	static vk::ShaderStageFlagBits GetShaderStage(uint32_t executionModel)
+	{
+		switch (executionModel)
+		{
+			case Spv::Vertex: return vk::ShaderStageFlagBits::eVertex;
+			case Spv::TessellationControl: return vk::ShaderStageFlagBits::eTessellationControl;
+			case Spv::TessellationEvaluation: return vk::ShaderStageFlagBits::eTessellationEvaluation;
+			case Spv::Geometry: return vk::ShaderStageFlagBits::eGeometry;
+			case Spv::Fragment: return vk::ShaderStageFlagBits::eFragment;
+			case Spv::GLCompute: return vk::ShaderStageFlagBits::eCompute;
+		}
+
+		throw std::runtime_error("Shader uses an execution model that isn't supported: " + std::to_string(executionModel));
+	}
+
+	static vk::Format GetInputFormat(const SpvModule& module, uint32_t typeId)
+	{
+		const SpvId& type = module.Get(typeId);
+
+		uint32_t componentCount = 1;
+		const SpvId* component = &type;
+		if (type.opcode == Spv::OpTypeVector)
+		{
+			componentCount = type.componentCount;
+			component = &module.Get(type.componentType);
+		}
+
+		if (component->width != 32)
+		{
+			throw std::runtime_error("Only 32-bit vertex inputs are supported by reflection");
+		}
+
+		static const vk::Format floatFormats[] = { vk::Format::eR32Sfloat, vk::Format::eR32G32Sfloat, vk::Format::eR32G32B32Sfloat, vk::Format::eR32G32B32A32Sfloat };
+		static const vk::Format intFormats[] = { vk::Format::eR32Sint, vk::Format::eR32G32Sint, vk::Format::eR32G32B32Sint, vk::Format::eR32G32B32A32Sint };
+		static const vk::Format uintFormats[] = { vk::Format::eR32Uint, vk::Format::eR32G32Uint, vk::Format::eR32G32B32Uint, vk::Format::eR32G32B32A32Uint };
+
+		if (component->opcode == Spv::OpTypeFloat) { return floatFormats[componentCount - 1]; }
+		if (component->opcode == Spv::OpTypeInt) { return component->isSigned ? intFormats[componentCount - 1] : uintFormats[componentCount - 1]; }
+
+		throw std::runtime_error("Shader input has a type that can't be used as a vertex attribute");
+	}
+
+	// Matrices take up one location per column, and arrays one (or more, for arrays of matrices) per element
+	// Returns the number of locations the type takes up
+	static uint32_t AddInputLocations(const SpvModule& module, uint32_t typeId, uint32_t location, vk::ShaderStageFlagBits stage,
+									  std::vector<ShaderInputVariable>& inputs)
+	{
+		const SpvId& type = module.Get(typeId);
+
+		if (type.opcode == Spv::OpTypeMatrix || type.opcode == Spv::OpTypeArray)
+		{
+			uint32_t elementCount = type.opcode == Spv::OpTypeMatrix ? type.componentCount : module.GetArrayLength(typeId);
+
+			uint32_t locationCount = 0;
+			for (uint32_t i = 0; i < elementCount; i++)
+			{
+				locationCount += AddInputLocations(module, type.componentType, location + locationCount, stage, inputs);
+			}
+
+			return locationCount;
+		}
+
+		// Only vertex inputs turn into attributes, but the other stages' inputs are still handy for matching stages up
+		ShaderInputVariable input;
+		input.location = location;
+		input.format = stage == vk::ShaderStageFlagBits::eVertex ? GetInputFormat(module, typeId) : vk::Format::eUndefined;
+		input.size = module.GetTypeSize(typeId);
+
+		inputs.push_back(input);
+
+		return 1;
+	}
+
+	static vk::DescriptorType GetDescriptorType(const SpvModule& module, const SpvId& variable, uint32_t typeId)
+	{
+		const SpvId& type = module.Get(typeId);
+
+		if (variable.storageClass == Spv::StorageBuffer) { return vk::DescriptorType::eStorageBuffer; }
+
+		// Old-style storage buffers are Uniform blocks decorated with BufferBlock
+		if (variable.storageClass == Spv::Uniform)
+		{
+			return type.isBufferBlock ? vk::DescriptorType::eStorageBuffer : vk::DescriptorType::eUniformBuffer;
+		}
+
+		switch (type.opcode)
+		{
+			case Spv::OpTypeSampler: return vk::DescriptorType::eSampler;
+			case Spv::OpTypeSampledImage: return vk::DescriptorType::eCombinedImageSampler;
+			case Spv::OpTypeAccelerationStructureKHR: return vk::DescriptorType::eAccelerationStructureKHR;
+
+			case Spv::OpTypeImage:
+				if (type.imageDim == Spv::DimSubpassData) { return vk::DescriptorType::eInputAttachment; }
+
+				// Sampled is 1 for images used with a sampler, and 2 for storage images
+				if (type.imageDim == Spv::DimBuffer)
+				{
+					return type.imageSampled == 2 ? vk::DescriptorType::eStorageTexelBuffer : vk::DescriptorType::eUniformTexelBuffer;
+				}
+
+				return type.imageSampled == 2 ? vk::DescriptorType::eStorageImage : vk::DescriptorType::eSampledImage;
+		}
+
+		throw std::runtime_error("Shader has a resource with a type that can't be described by a descriptor");
+	}
+
+	ShaderReflection ReflectShader(const std::vector<char>& bytecode, const std::string& entryPoint)
+	{
+		SpvModule module;
+		module.Parse(bytecode, entryPoint);
+
+		ShaderReflection reflection;
+		reflection.stage = GetShaderStage(module.entryPointModel);
+		reflection.pushConstantRange.stageFlags = reflection.stage;
+		std::copy(std::begin(module.localSize), std::end(module.localSize), reflection.localSize);
+
+		uint32_t pushConstantStart = UINT32_MAX;
+		uint32_t pushConstantEnd = 0;
+
+		for (uint32_t variableId : module.variables)
+		{
+			const SpvId& variable = module.Get(variableId);
+			uint32_t typeId = module.Get(variable.pointeeType).pointeeType;
+
+			switch (variable.storageClass)
+			{
+				case Spv::Input:
+				{
+					// Before SPIR-V 1.4, only inputs and outputs are listed in the interface, so this is all we can filter on
+					bool isInInterface = std::find(module.entryPointInterface.begin(), module.entryPointInterface.end(), variableId) !=
+										 module.entryPointInterface.end();
+
+					if (!isInInterface || variable.isBuiltIn || !variable.hasLocation || module.Get(typeId).isBuiltIn) { continue; }
+
+					AddInputLocations(module, typeId, variable.location, reflection.stage, reflection.inputs);
+					break;
+				}
+
+				case Spv::UniformConstant:
+				case Spv::Uniform:
+				case Spv::StorageBuffer:
+				{
+					// Modules with several entry points share their resources, but each stage only gets the ones it uses
+					if (!module.entryPointVariables.contains(variableId)) { continue; }
+
+					DescriptorBinding binding;
+					binding.set = variable.descriptorSet;
+					binding.binding = variable.binding;
+					binding.stages = reflection.stage;
+
+					// Arrays of resources become one binding with a descriptor count
+					uint32_t resourceTypeId = typeId;
+					const SpvId& type = module.Get(typeId);
+					if (type.opcode == Spv::OpTypeArray || type.opcode == Spv::OpTypeRuntimeArray)
+					{
+						binding.count = module.GetArrayLength(typeId);
+						resourceTypeId = type.componentType;
+					}
+
+					binding.type = GetDescriptorType(module, variable, resourceTypeId);
+
+					reflection.descriptorBindings.push_back(binding);
+					break;
+				}
+
+				case Spv::PushConstant:
+				{
+					if (!module.entryPointVariables.contains(variableId)) { continue; }
+
+					const SpvId& block = module.Get(typeId);
+					for (size_t i = 0; i < block.memberTypes.size(); i++)
+					{
+						uint32_t offset = i < block.memberOffsets.size() ? block.memberOffsets[i] : 0;
+						uint32_t matrixStride = i < block.memberMatrixStrides.size() ? block.memberMatrixStrides[i] : 0;
+
+						pushConstantStart = std::min(pushConstantStart, offset);
+						pushConstantEnd = std::max(pushConstantEnd, offset + module.GetTypeSize(block.memberTypes[i], matrixStride));
+					}
+					break;
+				}
+			}
+		}
+
+		if (pushConstantStart < pushConstantEnd)
+		{
+			reflection.pushConstantRange.offset = pushConstantStart;
+			reflection.pushConstantRange.size = pushConstantEnd - pushConstantStart;
+		}
+
+		std::sort(reflection.inputs.begin(), reflection.inputs.end(),
+			[](const ShaderInputVariable& a, const ShaderInputVariable& b) { return a.location < b.location; });
+
+		std::sort(reflection.descriptorBindings.begin(), reflection.descriptorBindings.end(),
+			[](const DescriptorBinding& a, const DescriptorBinding& b) { return a.set != b.set ? a.set < b.set : a.binding < b.binding; });
+
+		return reflection;
+	}
+
+	uint64_t HashBytecode(const std::vector<char>& bytecode)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (char byte : bytecode)
+		{
+			hash ^= (unsigned char)byte;
+			hash *= 1099511628211ull;
+		}
+
+		return hash;
+	}
+
+	ShaderReflection ShaderReflectionCache::GetReflection(const std::vector<char>& bytecode, const std::string& entryPoint)
+	{
+		std::pair<uint64_t, std::string> key = { HashBytecode(bytecode), entryPoint };
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			std::map<std::pair<uint64_t, std::string>, ShaderReflection>::iterator it = m_reflections.find(key);
+			if (it != m_reflections.end()) { return it->second; }
+		}
+
+		// Parsed outside the lock. If two threads race on the same shader, they'll both get the same answer anyway
+		ShaderReflection reflection = ReflectShader(bytecode, entryPoint);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_reflections.emplace(key, reflection);
+
+		return reflection;
+	}
+
+	void ShaderReflectionCache::Clear()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_reflections.clear();
+	}
+}
\ No newline at end of file
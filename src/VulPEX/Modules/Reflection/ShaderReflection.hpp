@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <map>
+#include <mutex>
+#include <cstdint>
+
+#include "../../Utility/VulkanDynamicInclude.hpp"
+
+namespace Reflection
+{
+	struct ShaderInputVariable
+	{
+		uint32_t location = 0;
+		vk::Format format = vk::Format::eUndefined;
+
+		// In bytes, for packing vertex attributes tightly
+		uint32_t size = 0;
+	};
+
+	struct DescriptorBinding
+	{
+		uint32_t set = 0;
+		uint32_t binding = 0;
+		vk::DescriptorType type = vk::DescriptorType::eUniformBuffer;
+		uint32_t count = 1;
+		vk::ShaderStageFlags stages;
+	};
+
+	struct ShaderReflection
+	{
+		vk::ShaderStageFlagBits stage = vk::ShaderStageFlagBits::eVertex;
+
+		// Sorted by location. Built-ins like gl_VertexIndex aren't included
+		// Matrices and arrays are split up into one input per location, e.g. a mat4 becomes four vec4s
+		std::vector<ShaderInputVariable> inputs;
+
+		// Sorted by set, then binding. Only resources the entry point actually uses are included
+		std::vector<DescriptorBinding> descriptorBindings;
+
+		// Covers every push constant the stage can see. size is 0 if it doesn't use any
+		vk::PushConstantRange pushConstantRange;
+
+		// How many invocations are in each workgroup. Always 1, 1, 1 for anything other than compute shaders
+		uint32_t localSize[3] = { 1, 1, 1 };
+	};
+
+	// Throws if bytecode isn't SPIR-V, doesn't contain entryPoint, or uses something we can't describe yet (e.g. 64-bit vertex inputs)
+	ShaderReflection ReflectShader(const std::vector<char>& bytecode, const std::string& entryPoint = "main");
+
+	// FNV-1a, so it's the same from one run to the next
+	uint64_t HashBytecode(const std::vector<char>& bytecode);
+
+	// The same shaders end up in lots of pipelines, so each one only gets parsed once
+	class ShaderReflectionCache
+	{
+		std::mutex m_mutex;
+		std::map<std::pair<uint64_t, std::string>, ShaderReflection> m_reflections;
+
+	public:
+		// Safe to call from any thread
+		ShaderReflection GetReflection(const std::vector<char>& bytecode, const std::string& entryPoint = "main");
+
+		// Cleanup
+		void Clear();
+	};
+}
\ No newline at end of file
@@ -0,0 +1,316 @@
+#include "JobSystem.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Threading
+{
+	// Which queue the current thread owns. Threads that aren't one of this system's workers use the shared queue
+	static thread_local const JobSystem* s_workerOwner = nullptr;
+	static thread_local uint32_t s_workerIndex = 0;
+
+	// Private
+	void JobSystem::WorkerLoop(uint32_t workerIndex)
+	{
+		s_workerOwner = this;
+		s_workerIndex = workerIndex;
+
+		Job job;
+		while (true)
+		{
+			// Background jobs only get a worker once there's nothing more urgent
+			if (TryPop(job) || TryPopBackground(job, nullptr))
+			{
+				Execute(job);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_wakeCondition.wait(lock, [this]()
+			{
+				return m_queuedJobCount.load() > 0 || m_queuedBackgroundJobCount.load() > 0 || m_stopping.load();
+			});
+
+			// Drain the queues before leaving, so that nobody is left waiting on a counter that will never reach zero
+			if (m_stopping.load() && m_queuedJobCount.load() == 0 && m_queuedBackgroundJobCount.load() == 0) { return; }
+		}
+	}
+
+	void JobSystem::Push(Job job)
+	{
+		// Before creation or after destruction there's nowhere to queue it, and nobody left to run it later
+		if (m_queues.empty())
+		{
+			Execute(job);
+			return;
+		}
+
+		uint32_t queueIndex = s_workerOwner == this ? s_workerIndex : m_queues.size() - 1;
+
+		{
+			std::lock_guard<std::mutex> lock(m_queues[queueIndex]->mutex);
+			m_queues[queueIndex]->jobs.push_back(std::move(job));
+		}
+
+		// Taking the lock means a worker can't miss this between checking the count and going to sleep
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_queuedJobCount++;
+		}
+		m_wakeCondition.notify_one();
+	}
+
+	bool JobSystem::TryPop(Job& job)
+	{
+		if (m_queuedJobCount.load() == 0 || m_queues.empty()) { return false; }
+
+		uint32_t ownQueue = s_workerOwner == this ? s_workerIndex : m_queues.size() - 1;
+
+		// Our own work is newest at the back, which is the most likely to still be in cache
+		{
+			WorkQueue& queue = *m_queues[ownQueue];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (!queue.jobs.empty())
+			{
+				job = std::move(queue.jobs.back());
+				queue.jobs.pop_back();
+				m_queuedJobCount--;
+				return true;
+			}
+		}
+
+		// Steal the oldest job from someone else, starting with our neighbour so that thieves spread out
+		for (uint32_t i = 1; i < m_queues.size(); i++)
+		{
+			WorkQueue& queue = *m_queues[(ownQueue + i) % m_queues.size()];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (!queue.jobs.empty())
+			{
+				job = std::move(queue.jobs.front());
+				queue.jobs.pop_front();
+				m_queuedJobCount--;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool JobSystem::TryPopBackground(Job& job, const JobCounter* counter)
+	{
+		if (m_queuedBackgroundJobCount.load() == 0) { return false; }
+
+		std::lock_guard<std::mutex> lock(m_backgroundQueue.mutex);
+
+		std::deque<Job>::iterator it = m_backgroundQueue.jobs.begin();
+		if (counter != nullptr)
+		{
+			it = std::find_if(m_backgroundQueue.jobs.begin(), m_backgroundQueue.jobs.end(), [counter](const Job& queued) { return queued.counter == counter; });
+		}
+
+		if (it == m_backgroundQueue.jobs.end()) { return false; }
+
+		job = std::move(*it);
+		m_backgroundQueue.jobs.erase(it);
+		m_queuedBackgroundJobCount--;
+		return true;
+	}
+
+	void JobSystem::Execute(Job& job)
+	{
+		std::exception_ptr exception = nullptr;
+		if (job.counter == nullptr)
+		{
+			job.function();
+		}
+		else
+		{
+			try
+			{
+				job.function();
+			}
+			catch (...)
+			{
+				exception = std::current_exception();
+			}
+		}
+
+		FinishJob(job.counter, exception);
+
+		job = {};
+	}
+
+	void JobSystem::FinishJob(JobCounter* counter, std::exception_ptr exception)
+	{
+		if (counter == nullptr) { return; }
+
+		std::vector<Job> continuations;
+		{
+			std::lock_guard<std::mutex> lock(counter->m_mutex);
+			if (exception != nullptr && counter->m_exception == nullptr)
+			{
+				counter->m_exception = exception;
+			}
+
+			if (counter->m_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				continuations.swap(counter->m_continuations);
+			}
+		}
+
+		// The counter might already be gone at this point, so only the local copy is touched
+		for (Job& continuation : continuations)
+		{
+			Push(std::move(continuation));
+		}
+	}
+
+	// Public
+	void JobSystem::CreateJobSystem(uint32_t workerCount)
+	{
+		m_stopping = false;
+
+		for (uint32_t i = 0; i < workerCount + 1; i++)
+		{
+			m_queues.push_back(std::make_unique<WorkQueue>());
+		}
+
+		for (uint32_t i = 0; i < workerCount; i++)
+		{
+			m_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+		}
+	}
+
+	void JobSystem::Run(std::function<void()> function, JobCounter* counter)
+	{
+		if (counter != nullptr) { counter->m_count++; }
+
+		Push({ std::move(function), counter });
+	}
+
+	void JobSystem::RunAfter(JobCounter* dependency, std::function<void()> function, JobCounter* counter)
+	{
+		if (counter != nullptr) { counter->m_count++; }
+
+		{
+			std::lock_guard<std::mutex> lock(dependency->m_mutex);
+			if (dependency->m_count.load(std::memory_order_acquire) > 0)
+			{
+				dependency->m_continuations.push_back({ std::move(function), counter });
+				return;
+			}
+		}
+
+		Push({ std::move(function), counter });
+	}
+
+	void JobSystem::RunBackground(std::function<void()> function, JobCounter* counter)
+	{
+		if (counter != nullptr) { counter->m_count++; }
+
+		Job job = { std::move(function), counter };
+		if (m_queues.empty())
+		{
+			Execute(job);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_backgroundQueue.mutex);
+			m_backgroundQueue.jobs.push_back(std::move(job));
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_queuedBackgroundJobCount++;
+		}
+		m_wakeCondition.notify_one();
+	}
+
+	void JobSystem::Wait(JobCounter* counter)
+	{
+		// Without queues every job has already run inline, so anything still outstanding was lost and would never finish
+		if (m_queues.empty() && !counter->IsComplete())
+		{
+			throw std::runtime_error("Waiting on jobs that were queued on a job system that has since been destroyed");
+		}
+
+		Job job;
+		while (!counter->IsComplete())
+		{
+			if (TryPop(job) || TryPopBackground(job, counter))
+			{
+				Execute(job);
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		// Whoever finished the last job might still be holding the lock, and the counter can be destroyed as soon as we return
+		std::exception_ptr exception = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(counter->m_mutex);
+			std::swap(exception, counter->m_exception);
+		}
+
+		if (exception != nullptr) { std::rethrow_exception(exception); }
+	}
+
+	void JobSystem::ParallelFor(size_t count, size_t minBatchSize, std::function<void(size_t, size_t)> function)
+	{
+		if (count == 0) { return; }
+
+		// A few batches per thread, so that stealing can even things out when some batches are slower than others
+		size_t threadCount = m_workers.size() + 1;
+		size_t batchSize = std::max(std::max(minBatchSize, (size_t)1), (count + threadCount * 4 - 1) / (threadCount * 4));
+
+		JobCounter counter;
+		for (size_t begin = batchSize; begin < count; begin += batchSize)
+		{
+			size_t end = std::min(begin + batchSize, count);
+			Run([&function, begin, end]() { function(begin, end); }, &counter);
+		}
+
+		// The first batch runs here rather than sitting idle
+		// The other batches reference counter and function, so we have to wait for them even if this one throws
+		try
+		{
+			function(0, std::min(batchSize, count));
+		}
+		catch (...)
+		{
+			try { Wait(&counter); } catch (...) {}
+			throw;
+		}
+
+		Wait(&counter);
+	}
+
+	void JobSystem::DestroyJobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_stopping = true;
+		}
+		m_wakeCondition.notify_all();
+
+		for (std::thread& worker : m_workers)
+		{
+			worker.join();
+		}
+
+		// Without workers, or if something was queued after they'd drained everything and left, it's up to us
+		Job job;
+		while (TryPop(job) || TryPopBackground(job, nullptr))
+		{
+			Execute(job);
+		}
+
+		m_workers.clear();
+		m_queues.clear();
+		m_queuedJobCount = 0;
+		m_queuedBackgroundJobCount = 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Threading
+{
+	class JobCounter;
+
+	struct Job
+	{
+		std::function<void()> function;
+
+		// Decremented once the job has finished. Can be nullptr for fire-and-forget jobs
+		JobCounter* counter = nullptr;
+	};
+
+	// Tracks how many jobs in a group are still running, and what should run once they're all done
+	// Must outlive every job it's passed to, and mustn't be reused for another group until JobSystem::Wait has returned
+	class JobCounter
+	{
+		friend class JobSystem;
+
+		std::atomic<uint32_t> m_count = 0;
+
+		// Guards m_continuations, and the final decrement, so that a continuation can't slip in after the count hits zero
+		std::mutex m_mutex;
+		std::vector<Job> m_continuations;
+
+		// The first exception thrown by any job in the group, rethrown by JobSystem::Wait
+		std::exception_ptr m_exception = nullptr;
+
+	public:
+		// Bools
+		bool IsComplete() const { return m_count.load(std::memory_order_acquire) == 0; };
+	};
+
+	// Work-stealing scheduler. Each worker pushes and pops jobs at the back of its own deque, and steals from the front of
+	// everyone else's when it runs out. Jobs queued from outside the workers go into a shared queue that everyone steals from
+	// Anything waiting on a counter runs other jobs in the meantime, so jobs can wait on other jobs without deadlocking
+	// Background jobs go into a queue of their own, which workers only get to once everything else is done
+	class JobSystem
+	{
+		// Each deque is locked individually, so the owner and thieves only contend when they're after the same deque
+		struct WorkQueue
+		{
+			std::mutex mutex;
+			std::deque<Job> jobs;
+		};
+
+		// Misc resources
+		std::vector<std::thread> m_workers;
+
+		// One per worker, plus the shared queue at the end
+		std::vector<std::unique_ptr<WorkQueue>> m_queues;
+
+		std::atomic<uint32_t> m_queuedJobCount = 0;
+		std::atomic<bool> m_stopping = false;
+
+		// Oldest first. Waiting on a counter only ever runs background jobs that belong to that counter
+		WorkQueue m_backgroundQueue;
+		std::atomic<uint32_t> m_queuedBackgroundJobCount = 0;
+
+		// Idle workers sleep on this rather than spinning
+		std::mutex m_sleepMutex;
+		std::condition_variable m_wakeCondition;
+
+		// Helpers
+		void WorkerLoop(uint32_t workerIndex);
+
+		void Push(Job job);
+		bool TryPop(Job& job);
+		// Any background job if counter is nullptr, otherwise only the oldest one belonging to counter
+		bool TryPopBackground(Job& job, const JobCounter* counter);
+		void Execute(Job& job);
+
+		void FinishJob(JobCounter* counter, std::exception_ptr exception);
+
+	public:
+		// workerCount can be 0, in which case every job runs on whichever thread waits for it
+		void CreateJobSystem(uint32_t workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1);
+
+		void Run(std::function<void()> function, JobCounter* counter = nullptr);
+		// Queued once dependency completes, or straight away if it already has
+		void RunAfter(JobCounter* dependency, std::function<void()> function, JobCounter* counter = nullptr);
+		// For long jobs that mustn't hold up threads waiting on something else, e.g. pipeline builds while a frame waits on recording
+		// Only idle workers run them, along with whoever waits on counter itself. With no workers, that's the only way they run
+		void RunBackground(std::function<void()> function, JobCounter* counter);
+
+		// Runs other jobs until counter reaches zero, then rethrows the first exception any of its jobs threw
+		// Background jobs are left alone unless they belong to counter
+		// Jobs without a counter have nowhere to report exceptions to, so they mustn't throw
+		void Wait(JobCounter* counter);
+
+		// Splits [0, count) into batches of at least minBatchSize, and blocks until every batch has run
+		// function is called with the [begin, end) of each batch
+		void ParallelFor(size_t count, size_t minBatchSize, std::function<void(size_t, size_t)> function);
+
+		// Getters
+		uint32_t GetWorkerCount() const { return m_workers.size(); };
+
+		// Cleanup
+		// Anything still queued is run before this returns, on the calling thread if there are no workers left to run it
+		// Afterwards, Run runs jobs straight away on the calling thread, so cleanup that queues or waits on jobs still works
+		// Mustn't be called while other threads are still queueing jobs
+		void DestroyJobSystem();
+	};
+}
\ No newline at end of file
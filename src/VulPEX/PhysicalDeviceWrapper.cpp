@@ -2,6 +2,9 @@
 
 #include <map>
 #include <unordered_set>
+#include <string>
+
+#include <Logger.hpp>
 
 #include "Utility/VulPEXUtils.hpp"
 
@@ -39,24 +42,61 @@ uint PhysicalDeviceWrapper::RatePhysicalDeviceCompatibility(vk::PhysicalDevice d
 {
 	vk::PhysicalDeviceProperties deviceProperties = device.getProperties();
 
-	vk::PhysicalDeviceFeatures deviceFeatures = device.getFeatures();
+	// Every device that gets turned down says why, since otherwise "no compatible GPUs" is all anyone gets to see
+	std::string deviceName = deviceProperties.deviceName;
+	auto reject = [&deviceName](const std::string& reason)
+	{
+		std::string rejectionMessage = "Not using " + deviceName + ", as " + reason;
+		Logger::Log({ rejectionMessage.c_str() }, LogType::Warning);
+		return 0u;
+	};
 
 	// Fail states
+	// Has to come before the features are queried, since getFeatures2 and the 1.2/1.3 feature structs don't exist before then
+	if (deviceProperties.apiVersion < VK_API_VERSION_1_3)
+	{
+		return reject("it only supports Vulkan " + std::to_string(VK_API_VERSION_MAJOR(deviceProperties.apiVersion)) + "." +
+					  std::to_string(VK_API_VERSION_MINOR(deviceProperties.apiVersion)) + ", and 1.3 is needed");
+	}
+
 	if (!AreDeviceExtensionsSupported(device, deviceExtensions))
 	{
-		return 0;
+		return reject("it doesn't support every requested device extension");
+	}
+
+	// Everything the logical device always enables has to be checked here, otherwise device creation fails on GPUs that lack it
+	vk::StructureChain<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features, vk::PhysicalDeviceVulkan13Features> featureChain =
+		device.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features, vk::PhysicalDeviceVulkan13Features>();
+
+	const vk::PhysicalDeviceFeatures& deviceFeatures = featureChain.get<vk::PhysicalDeviceFeatures2>().features;
+	const vk::PhysicalDeviceVulkan12Features& vulkan12Features = featureChain.get<vk::PhysicalDeviceVulkan12Features>();
+	const vk::PhysicalDeviceVulkan13Features& vulkan13Features = featureChain.get<vk::PhysicalDeviceVulkan13Features>();
+
+	if (!deviceFeatures.geometryShader)
+	{
+		return reject("it doesn't support geometry shaders");
 	}
 
-    if (!deviceFeatures.geometryShader)
+	if (!vulkan12Features.timelineSemaphore)
 	{
-        return 0;
-    }
+		return reject("it doesn't support timeline semaphores");
+	}
+
+	if (!vulkan13Features.pipelineCreationCacheControl)
+	{
+		return reject("it doesn't support pipeline creation cache control");
+	}
+
+	if (!vulkan13Features.dynamicRendering || !vulkan13Features.synchronization2)
+	{
+		return reject("it doesn't support dynamic rendering and synchronization2");
+	}
 
 	// This must occur after we've confirmed that deviceExtensions are supported
 	m_supportInfo = QuerySwapChainSupport(device, surface);
 	if (m_supportInfo.surfaceFormats.empty() || m_supportInfo.presentModes.empty())
 	{
-		return 0;
+		return reject("it can't present to the window's surface");
 	}
 
 	int score = 0;
@@ -100,9 +140,13 @@ void PhysicalDeviceWrapper::SelectDevice(vk::Instance instance, vk::SurfaceKHR s
 		deviceCandidates.insert(std::make_pair(deviceScore, device));
 	}
 
-	if (deviceCandidates.begin()->first > 0)
+	// Multimaps are sorted lowest first, so the best device is at the end
+	if (deviceCandidates.rbegin()->first > 0)
 	{
-		m_physicalDevice = deviceCandidates.begin()->second;
+		m_physicalDevice = deviceCandidates.rbegin()->second;
+
+		// Rating leaves behind whichever device was rated last's support info, which isn't necessarily the one we picked
+		m_supportInfo = QuerySwapChainSupport(m_physicalDevice, surface);
 	}
 	else
 	{
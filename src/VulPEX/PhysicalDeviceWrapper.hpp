@@ -31,6 +31,13 @@ public:
 	void ConfigurePhysicalDevice(std::vector<const char*> deviceExtensions);
 	void SelectDevice(vk::Instance instance, vk::SurfaceKHR surface);
 
+	// For optional extensions, which shouldn't stop a device from being selected. Must be called after SelectDevice
+	bool IsDeviceExtensionSupported(const char* extension) const { return AreDeviceExtensionsSupported(m_physicalDevice, { extension }); };
+	void EnableDeviceExtension(const char* extension) { m_enabledDeviceExtensions.push_back(extension); };
+
+	// The surface's capabilities (e.g. its current extent) change when the window does, so this needs calling before the swapchain is recreated
+	void RefreshSwapChainSupportInfo(vk::SurfaceKHR surface) { m_supportInfo = QuerySwapChainSupport(m_physicalDevice, surface); };
+
 	// Getters
 	vk::PhysicalDevice GetPhysicalDevice() const { return m_physicalDevice; };
 	SwapChainSupportInfo GetSwapChainSupportInfo() const { return m_supportInfo; };
@@ -0,0 +1,105 @@
+#include "PipelineCacheWrapper.hpp"
+
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+
+#include <Logger.hpp>
+
+// Private
+std::vector<char> PipelineCacheWrapper::LoadCacheFile() const
+{
+	std::ifstream cacheFile(m_cachePath, std::ios::binary | std::ios::ate);
+
+	// No cache yet, which is expected on first launch
+	if (!cacheFile.is_open()) { return {}; }
+
+	std::vector<char> cacheData(cacheFile.tellg());
+	cacheFile.seekg(0);
+	cacheFile.read(cacheData.data(), cacheData.size());
+
+	if (!cacheFile) { return {}; }
+
+	return cacheData;
+}
+
+bool PipelineCacheWrapper::IsCacheDataValid(const std::vector<char>& cacheData, vk::PhysicalDevice physDevice) const
+{
+	// The layout of VkPipelineCacheHeaderVersionOne, which every cache starts with
+	uint32_t headerSize;
+	uint32_t headerVersion;
+	uint32_t vendorID;
+	uint32_t deviceID;
+	uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+
+	if (cacheData.size() < 16 + VK_UUID_SIZE) { return false; }
+
+	std::memcpy(&headerSize, cacheData.data(), 4);
+	std::memcpy(&headerVersion, cacheData.data() + 4, 4);
+	std::memcpy(&vendorID, cacheData.data() + 8, 4);
+	std::memcpy(&deviceID, cacheData.data() + 12, 4);
+	std::memcpy(pipelineCacheUUID, cacheData.data() + 16, VK_UUID_SIZE);
+
+	vk::PhysicalDeviceProperties deviceProperties = physDevice.getProperties();
+
+	return headerSize >= 16 + VK_UUID_SIZE && headerSize <= cacheData.size() &&
+		   headerVersion == (uint32_t)vk::PipelineCacheHeaderVersion::eOne &&
+		   vendorID == deviceProperties.vendorID && deviceID == deviceProperties.deviceID &&
+		   std::memcmp(pipelineCacheUUID, deviceProperties.pipelineCacheUUID.data(), VK_UUID_SIZE) == 0;
+}
+
+// Public
+void PipelineCacheWrapper::CreatePipelineCache(vk::Device device, vk::PhysicalDevice physDevice, std::string cachePath)
+{
+	m_cachePath = cachePath;
+
+	std::vector<char> cacheData = LoadCacheFile();
+
+	if (!cacheData.empty() && !IsCacheDataValid(cacheData, physDevice))
+	{
+		std::string staleMessage = "Pipeline cache \"" + m_cachePath + "\" was made by a different device or driver, discarding it";
+		Logger::Log({ staleMessage.c_str() }, LogType::Info);
+
+		cacheData.clear();
+	}
+
+	m_loadedFromDisk = !cacheData.empty();
+
+	vk::PipelineCacheCreateInfo cacheInfo(
+		{},					//flags
+		cacheData.size(),	//initialDataSize
+		cacheData.data()	//pInitialData
+	);
+
+	m_pipelineCache = device.createPipelineCache(cacheInfo);
+}
+
+void PipelineCacheWrapper::SavePipelineCache(vk::Device device) const
+{
+	if (m_pipelineCache == nullptr) { return; }
+
+	std::vector<uint8_t> cacheData = device.getPipelineCacheData(m_pipelineCache);
+
+	// Write to a temporary file first, so that crashing halfway through can't leave a corrupted cache behind
+	std::string tempPath = m_cachePath + ".tmp";
+	{
+		std::ofstream cacheFile(tempPath, std::ios::binary | std::ios::trunc);
+		cacheFile.write((const char*)cacheData.data(), cacheData.size());
+
+		if (!cacheFile)
+		{
+			throw std::runtime_error("Could not write pipeline cache to \"" + tempPath + "\"");
+		}
+	}
+
+	std::remove(m_cachePath.c_str());
+	if (std::rename(tempPath.c_str(), m_cachePath.c_str()) != 0)
+	{
+		throw std::runtime_error("Could not move pipeline cache to \"" + m_cachePath + "\"");
+	}
+}
+
+void PipelineCacheWrapper::DestroyPipelineCache(vk::Device device)
+{
+	if (m_pipelineCache != nullptr) { device.destroyPipelineCache(m_pipelineCache); }
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+#include <string>
+
+#include "Utility/VulkanDynamicInclude.hpp"
+
+// A vk::PipelineCache that persists between runs, so pipelines only have to be compiled from scratch the first time
+class PipelineCacheWrapper
+{
+	// Vulkan resources
+	vk::PipelineCache m_pipelineCache = nullptr;
+
+	// Misc resources
+	std::string m_cachePath;
+
+	bool m_loadedFromDisk = false;
+
+	// Helpers
+	std::vector<char> LoadCacheFile() const;
+
+	// A cache made by a different GPU or driver version is useless at best, so anything that doesn't match is thrown away
+	bool IsCacheDataValid(const std::vector<char>& cacheData, vk::PhysicalDevice physDevice) const;
+
+public:
+	// Starts out empty if the file at cachePath doesn't exist, or was made by a different device or driver
+	void CreatePipelineCache(vk::Device device, vk::PhysicalDevice physDevice, std::string cachePath);
+
+	// Safe to call while pipelines are being created
+	void SavePipelineCache(vk::Device device) const;
+
+	// Getters
+	vk::PipelineCache GetPipelineCache() const { return m_pipelineCache; };
+
+	// Bools
+	bool WasLoadedFromDisk() const { return m_loadedFromDisk; };
+
+	// Cleanup
+	void DestroyPipelineCache(vk::Device device);
+};
\ No newline at end of file
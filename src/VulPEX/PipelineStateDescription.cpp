@@ -0,0 +1,126 @@
+#include "PipelineStateDescription.hpp"
+
+#include <cstring>
+
+// FNV-1a, which is simple, fast enough for the amount of state we have, and doesn't change between platforms or runs
+static constexpr uint64_t c_fnvOffsetBasis = 14695981039346656037ull;
+static constexpr uint64_t c_fnvPrime = 1099511628211ull;
+
+static void HashBytes(uint64_t& hash, const void* data, size_t size)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= c_fnvPrime;
+	}
+}
+
+// Every field is widened to a fixed size first, so that the hash never depends on padding or the size of an enum
+static void HashValue(uint64_t& hash, uint64_t value)
+{
+	HashBytes(hash, &value, sizeof(value));
+}
+
+static void HashBytecode(uint64_t& hash, const std::vector<char>& bytecode)
+{
+	HashValue(hash, bytecode.size());
+	HashBytes(hash, bytecode.data(), bytecode.size());
+}
+
+static void HashString(uint64_t& hash, const std::string& string)
+{
+	HashValue(hash, string.size());
+	HashBytes(hash, string.data(), string.size());
+}
+
+static void HashSpecialisationConstants(uint64_t& hash, const SpecialisationConstants& constants)
+{
+	// std::map is ordered, so the same constants always hash the same way
+	HashValue(hash, constants.size());
+	for (const std::pair<const uint32_t, uint32_t>& constant : constants)
+	{
+		HashValue(hash, constant.first);
+		HashValue(hash, constant.second);
+	}
+}
+
+uint64_t PipelineStateDescription::GetHash() const
+{
+	uint64_t hash = c_fnvOffsetBasis;
+
+	HashBytecode(hash, shaderInfo.vertBytecode);
+	HashBytecode(hash, shaderInfo.fragBytecode);
+	HashString(hash, shaderInfo.vertEntryPoint);
+	HashString(hash, shaderInfo.fragEntryPoint);
+	HashSpecialisationConstants(hash, shaderInfo.vertSpecialisationConstants);
+	HashSpecialisationConstants(hash, shaderInfo.fragSpecialisationConstants);
+
+	HashValue(hash, sizeOfVertex);
+	HashValue(hash, vertexVarsInfo.size());
+	for (const std::pair<vk::Format, uint32_t>& vertexVar : vertexVarsInfo)
+	{
+		HashValue(hash, (uint64_t)vertexVar.first);
+		HashValue(hash, vertexVar.second);
+	}
+
+	HashValue(hash, sizeOfInstance);
+	HashValue(hash, instanceVarsInfo.size());
+	for (const std::pair<vk::Format, uint32_t>& instanceVar : instanceVarsInfo)
+	{
+		HashValue(hash, (uint64_t)instanceVar.first);
+		HashValue(hash, instanceVar.second);
+	}
+
+	HashValue(hash, (uint64_t)topology);
+	HashValue(hash, primitiveRestartEnable);
+
+	HashValue(hash, (uint64_t)polygonMode);
+	HashValue(hash, (uint64_t)(VkCullModeFlags)cullMode);
+	HashValue(hash, (uint64_t)frontFace);
+
+	uint32_t lineWidthBits;
+	std::memcpy(&lineWidthBits, &lineWidth, sizeof(lineWidthBits));
+	HashValue(hash, lineWidthBits);
+
+	HashValue(hash, (uint64_t)rasterisationSamples);
+	HashValue(hash, (uint64_t)blendMode);
+
+	return hash;
+}
+
+bool PipelineStateDescription::operator==(const PipelineStateDescription& other) const
+{
+	return shaderInfo.vertBytecode == other.shaderInfo.vertBytecode && shaderInfo.fragBytecode == other.shaderInfo.fragBytecode &&
+		   shaderInfo.vertEntryPoint == other.shaderInfo.vertEntryPoint && shaderInfo.fragEntryPoint == other.shaderInfo.fragEntryPoint &&
+		   shaderInfo.vertSpecialisationConstants == other.shaderInfo.vertSpecialisationConstants &&
+		   shaderInfo.fragSpecialisationConstants == other.shaderInfo.fragSpecialisationConstants &&
+		   sizeOfVertex == other.sizeOfVertex && vertexVarsInfo == other.vertexVarsInfo &&
+		   sizeOfInstance == other.sizeOfInstance && instanceVarsInfo == other.instanceVarsInfo &&
+		   topology == other.topology && primitiveRestartEnable == other.primitiveRestartEnable &&
+		   polygonMode == other.polygonMode && cullMode == other.cullMode && frontFace == other.frontFace && lineWidth == other.lineWidth &&
+		   rasterisationSamples == other.rasterisationSamples && blendMode == other.blendMode;
+}
+
+vk::SpecializationInfo GetSpecialisationInfo(const SpecialisationConstants& constants, std::vector<vk::SpecializationMapEntry>& mapEntries,
+											 std::vector<uint32_t>& data)
+{
+	for (const std::pair<const uint32_t, uint32_t>& constant : constants)
+	{
+		vk::SpecializationMapEntry mapEntry(
+			constant.first,						//constantID
+			data.size() * sizeof(uint32_t),		//offset
+			sizeof(uint32_t)					//size
+		);
+
+		mapEntries.push_back(mapEntry);
+		data.push_back(constant.second);
+	}
+
+	return vk::SpecializationInfo(
+		(uint32_t)mapEntries.size(),		//mapEntryCount
+		mapEntries.data(),					//pMapEntries
+		data.size() * sizeof(uint32_t),		//dataSize
+		data.data()							//pData
+	);
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <map>
+#include <cstdint>
+#include <bit>
+#include <type_traits>
+
+#include "Utility/VulkanDynamicInclude.hpp"
+
+// Maps a specialisation constant's constant_id to its value
+typedef std::map<uint32_t, uint32_t> SpecialisationConstants;
+
+// Bools, ints, uints and floats are all stored as 32 bits, so this is all that any of them need
+template<typename T>
+uint32_t ToSpecialisationValue(T value)
+{
+	static_assert(sizeof(T) == sizeof(uint32_t) || std::is_same_v<T, bool>, "Specialisation constants have to be 32 bits wide");
+
+	if constexpr (std::is_same_v<T, bool>) { return value ? vk::True : vk::False; }
+	else { return std::bit_cast<uint32_t>(value); }
+}
+
+// Every constant is 32 bits, so the data is just the values in constant_id order
+// mapEntries and data have to outlive the returned info, since it points into them
+vk::SpecializationInfo GetSpecialisationInfo(const SpecialisationConstants& constants, std::vector<vk::SpecializationMapEntry>& mapEntries,
+											 std::vector<uint32_t>& data);
+
+struct ShaderInfo
+{
+	std::vector<char> vertBytecode;
+	std::vector<char> fragBytecode;
+
+	std::string vertEntryPoint = "main";
+	std::string fragEntryPoint = "main";
+
+	// Folded in when the pipeline is compiled, so the driver can strip out whatever they turn off
+	// Every different set of values is a different pipeline
+	SpecialisationConstants vertSpecialisationConstants;
+	SpecialisationConstants fragSpecialisationConstants;
+};
+
+enum class BlendMode
+{
+	eOpaque,
+	eAlpha,
+	eAdditive
+};
+
+// The parts of a PipelineStateDescription that can be set while recording instead, when extended dynamic state is enabled
+struct DynamicRenderState
+{
+	vk::PrimitiveTopology topology = vk::PrimitiveTopology::eTriangleList;
+	bool primitiveRestartEnable = false;
+
+	vk::PolygonMode polygonMode = vk::PolygonMode::eFill;
+	vk::CullModeFlags cullMode = vk::CullModeFlagBits::eBack;
+	vk::FrontFace frontFace = vk::FrontFace::eClockwise;
+
+	BlendMode blendMode = BlendMode::eAlpha;
+
+	bool operator==(const DynamicRenderState& other) const = default;
+};
+
+// Everything that goes into building a graphics pipeline, apart from the render pass and layout, which every pipeline shares
+// Two descriptions that compare equal always produce the same pipeline, so this doubles as the key for GraphicsPipelineWrapper's cache
+struct PipelineStateDescription
+{
+	ShaderInfo shaderInfo;
+
+	// Vertex input
+	uint32_t sizeOfVertex = 0;
+	std::vector<std::pair<vk::Format, uint32_t>> vertexVarsInfo;
+
+	// Per-instance input, read from a second binding that steps once per instance rather than once per vertex
+	// Their locations carry on from the vertex attributes. When the vertex attributes come from reflection,
+	// the vertex shader's last instanceVarsInfo.size() inputs are taken to be these
+	uint32_t sizeOfInstance = 0;
+	std::vector<std::pair<vk::Format, uint32_t>> instanceVarsInfo;
+
+	// Input assembly
+	vk::PrimitiveTopology topology = vk::PrimitiveTopology::eTriangleList;
+	bool primitiveRestartEnable = false;
+
+	// Rasterisation
+	vk::PolygonMode polygonMode = vk::PolygonMode::eFill;
+	vk::CullModeFlags cullMode = vk::CullModeFlagBits::eBack;
+	vk::FrontFace frontFace = vk::FrontFace::eClockwise;
+	float lineWidth = 1;
+
+	// Must match the render pass, which is single-sampled for now
+	vk::SampleCountFlagBits rasterisationSamples = vk::SampleCountFlagBits::e1;
+
+	BlendMode blendMode = BlendMode::eAlpha;
+
+	DynamicRenderState GetDynamicRenderState() const { return { topology, primitiveRestartEnable, polygonMode, cullMode, frontFace, blendMode }; };
+
+	// Only depends on the values above, never on pointers, so it's the same from one run to the next
+	uint64_t GetHash() const;
+
+	bool operator==(const PipelineStateDescription& other) const;
+};
+
+struct PipelineStateHasher
+{
+	size_t operator()(const PipelineStateDescription& description) const { return description.GetHash(); };
+};
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "StagingRing.hpp"
+
+void StagingRing::CreateStagingRing(vk::Device device, DeviceMemoryAllocator* allocator, vk::DeviceSize regionSize, uint32_t regionCount,
+									std::vector<uint32_t> queueFamilyIndices)
+{
+	m_regionSize = regionSize;
+	m_regionCount = regionCount;
+
+	m_buffer.CreateBuffer(device, allocator, m_regionSize * m_regionCount, vk::BufferUsageFlagBits::eTransferSrc, queueFamilyIndices,
+		vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+	m_regionTickets.assign(m_regionCount, {});
+	m_regionsAwaitingSubmit.assign(m_regionCount, false);
+}
+
+void StagingRing::BeginFrame(vk::Device device, const TransferQueueWrapper* transferQueue, uint32_t frameIndex)
+{
+	uint32_t region = frameIndex % m_regionCount;
+
+	// With one frame in flight the region we're leaving is the one we're recycling, and it might have been staged into since
+	if (region == m_currentRegion && m_regionsAwaitingSubmit[region]) { return; }
+
+	transferQueue->Wait(device, m_regionTickets[region]);
+
+	m_currentRegion = region;
+	m_regionHead = 0;
+}
+
+StagingAllocation StagingRing::Allocate(vk::DeviceSize size, vk::DeviceSize alignment)
+{
+	vk::DeviceSize offset = (m_regionHead + alignment - 1) & ~(alignment - 1);
+	if (offset + size > m_regionSize)
+	{
+		throw std::runtime_error("Staging ring region ran out of space while allocating " + std::to_string(size) + " bytes");
+	}
+
+	m_regionHead = offset + size;
+	m_regionsAwaitingSubmit[m_currentRegion] = true;
+
+	vk::DeviceSize bufferOffset = m_currentRegion * m_regionSize + offset;
+
+	StagingAllocation allocation;
+	allocation.data = (char*)m_buffer.GetAllocation().mappedData + bufferOffset;
+	allocation.buffer = m_buffer.GetBuffer();
+	allocation.offset = bufferOffset;
+	allocation.size = size;
+
+	return allocation;
+}
+
+void StagingRing::MarkSubmitted(TransferTicket ticket)
+{
+	for (uint32_t i = 0; i < m_regionCount; i++)
+	{
+		if (!m_regionsAwaitingSubmit[i]) { continue; }
+
+		m_regionTickets[i] = ticket;
+		m_regionsAwaitingSubmit[i] = false;
+	}
+}
+
+TransferTicket StagingRing::CopyToBuffer(vk::Device device, TransferQueueWrapper* transferQueue, StagingAllocation source, vk::Buffer destination,
+										 vk::DeviceSize destinationOffset)
+{
+	vk::BufferCopy copyRegion(
+		source.offset,		//srcOffset
+		destinationOffset,	//dstOffset
+		source.size			//size
+	);
+
+	return m_buffer.CopyBuffer(device, transferQueue, destination, { copyRegion });
+}
+
+TransferTicket StagingRing::CopyRegionsToBuffer(vk::Device device, TransferQueueWrapper* transferQueue, std::vector<vk::BufferCopy> copyRegions,
+												vk::Buffer destination)
+{
+	// Nothing to do, so hand back a ticket that's already complete
+	if (copyRegions.empty()) { return {}; }
+
+	return m_buffer.CopyBuffer(device, transferQueue, destination, copyRegions);
+}
+
+vk::DeviceSize StagingRing::GetBytesRemaining(vk::DeviceSize alignment) const
+{
+	vk::DeviceSize alignedHead = (m_regionHead + alignment - 1) & ~(alignment - 1);
+
+	return alignedHead >= m_regionSize ? 0 : m_regionSize - alignedHead;
+}
+
+void StagingRing::DestroyStagingRing(vk::Device device, DeviceMemoryAllocator* allocator)
+{
+	m_buffer.DestroyBuffer(device, allocator);
+}
\ No newline at end of file
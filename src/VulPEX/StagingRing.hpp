@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+
+#include "Utility/VulkanDynamicInclude.hpp"
+
+#include "BufferWrapper.hpp"
+#include "TransferQueueWrapper.hpp"
+#include "DeviceMemoryAllocator.hpp"
+
+// A slice of the staging ring. Write into data, then copy from buffer at offset
+struct StagingAllocation
+{
+	void* data = nullptr;
+
+	vk::Buffer buffer = nullptr;
+	vk::DeviceSize offset = 0;
+	vk::DeviceSize size = 0;
+};
+
+// One persistently mapped, host-coherent buffer, split into one region per frame in flight
+// Each frame bump-allocates out of its own region, so uploads never have to map memory or wait on each other
+class StagingRing
+{
+	// Vulkan resources
+	BufferWrapper m_buffer;
+
+	// Misc resources
+	vk::DeviceSize m_regionSize = 0;
+	uint32_t m_regionCount = 0;
+
+	uint32_t m_currentRegion = 0;
+	vk::DeviceSize m_regionHead = 0;
+
+	// Data can be staged between frames and copied out by the next frame's transfer, which the region's own frame fence doesn't
+	// cover. So each region remembers the last transfer that read from it, and whether it's holding anything not yet submitted
+	std::vector<TransferTicket> m_regionTickets;
+	std::vector<bool> m_regionsAwaitingSubmit;
+
+public:
+	// If the queue families differ, the buffer is shared between them concurrently
+	void CreateStagingRing(vk::Device device, DeviceMemoryAllocator* allocator, vk::DeviceSize regionSize, uint32_t regionCount,
+						   std::vector<uint32_t> queueFamilyIndices);
+
+	// Recycles the region belonging to frameIndex. The caller must have already waited on that frame's fence, and this waits
+	// on the last transfer that read from the region, which has almost always finished by then
+	// Anything staged into the region that hasn't been submitted yet is kept
+	void BeginFrame(vk::Device device, const TransferQueueWrapper* transferQueue, uint32_t frameIndex);
+
+	StagingAllocation Allocate(vk::DeviceSize size, vk::DeviceSize alignment = 16);
+	// Every region allocated from since the last call is read by the transfer with this ticket
+	void MarkSubmitted(TransferTicket ticket);
+
+	TransferTicket CopyToBuffer(vk::Device device, TransferQueueWrapper* transferQueue, StagingAllocation source, vk::Buffer destination,
+								vk::DeviceSize destinationOffset = 0);
+	// srcOffsets are relative to the start of the ring's buffer, i.e. StagingAllocation::offset
+	TransferTicket CopyRegionsToBuffer(vk::Device device, TransferQueueWrapper* transferQueue, std::vector<vk::BufferCopy> copyRegions,
+									   vk::Buffer destination);
+
+	// Getters
+	vk::Buffer GetBuffer() const { return m_buffer.GetBuffer(); };
+	vk::DeviceSize GetRegionSize() const { return m_regionSize; };
+	vk::DeviceSize GetBytesUsedThisFrame() const { return m_regionHead; };
+	vk::DeviceSize GetBytesRemaining(vk::DeviceSize alignment = 16) const;
+
+	// Cleanup
+	void DestroyStagingRing(vk::Device device, DeviceMemoryAllocator* allocator);
+};
\ No newline at end of file
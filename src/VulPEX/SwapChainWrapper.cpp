@@ -61,6 +61,21 @@ vk::Extent2D SwapChainWrapper::ChooseExtent(vk::SurfaceCapabilitiesKHR surfaceCa
 	return extent;
 }
 
+void SwapChainWrapper::DestroyImageViewsAndFramebuffers(vk::Device device)
+{
+	for (vk::Framebuffer frameBuffer : m_frameBuffers)
+	{
+		device.destroyFramebuffer(frameBuffer);
+	}
+	m_frameBuffers.clear();
+
+	for (vk::ImageView imageView : m_imageViews)
+	{
+		device.destroyImageView(imageView);
+	}
+	m_imageViews.clear();
+}
+
 // Public
 SwapChainWrapper::SwapChainWrapper()
 {
@@ -134,7 +149,7 @@ void SwapChainWrapper::CreateSwapChain(vk::Device device, vk::SurfaceKHR surface
 		vk::CompositeAlphaFlagBitsKHR::eOpaque,				//compositeAlpha
 		presentMode,										//presentMode
 		vk::True,											//clipped | If a window covers some pixels, we'll just throw them out. This could cause problems in some niche applications, should be an option
-		nullptr												//oldSwapchain
+		m_swapChain											//oldSwapchain | nullptr unless we're being recreated, in which case the driver can reuse some of it
 	);
 
 	m_swapChain = device.createSwapchainKHR(swapChainInfo);
@@ -179,23 +194,21 @@ void SwapChainWrapper::CreateFramebuffers(vk::Device device, vk::RenderPass rend
 	}
 }
 
-void SwapChainWrapper::DestroySwapChain(vk::Device device)
+void SwapChainWrapper::RecreateSwapChain(vk::Device device, vk::SurfaceKHR surface, GLFWwindow* window, SwapChainSupportInfo supportInfo,
+										 QueueFamilyIndices qfIndices)
 {
-	if (m_frameBuffers.size() != 0)
-	{
-		for (vk::Framebuffer frameBuffer : m_frameBuffers)
-		{
-			device.destroyFramebuffer(frameBuffer);
-		}
-	}
+	DestroyImageViewsAndFramebuffers(device);
 
-	if (m_imageViews.size() != 0)
-	{
-		for (vk::ImageView imageView : m_imageViews)
-		{
-			device.destroyImageView(imageView);
-		}
-	}
+	// CreateSwapChain passes this in as oldSwapchain, and it's retired as soon as the new one exists
+	vk::SwapchainKHR oldSwapChain = m_swapChain;
+	CreateSwapChain(device, surface, window, supportInfo, qfIndices);
+
+	if (oldSwapChain != nullptr) { device.destroySwapchainKHR(oldSwapChain); }
+}
+
+void SwapChainWrapper::DestroySwapChain(vk::Device device)
+{
+	DestroyImageViewsAndFramebuffers(device);
 
 	if (m_swapChain != nullptr) { device.destroySwapchainKHR(m_swapChain); }
 }
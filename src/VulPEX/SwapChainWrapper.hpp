@@ -27,19 +27,28 @@ class SwapChainWrapper
 	vk::PresentModeKHR ChoosePresentMode(std::vector<vk::PresentModeKHR> availablePresentModes);
 	vk::Extent2D ChooseExtent(vk::SurfaceCapabilitiesKHR surfaceCapabilities, GLFWwindow* window);
 
+	void DestroyImageViewsAndFramebuffers(vk::Device device);
+
 public:
 	SwapChainWrapper();
 
 	// Surface formats and present modes should be ordered in order of preference, from most preferred to least preferred
 	void ConfigureSwapChain(std::vector<vk::SurfaceFormatKHR> preferredSurfaceFormats, std::vector<vk::PresentModeKHR> preferredPresentModes);
 	void CreateSwapChain(vk::Device device, vk::SurfaceKHR surface, GLFWwindow* window, SwapChainSupportInfo supportInfo, QueueFamilyIndices qfIndices);
+	// Framebuffers are only needed when rendering with a vk::RenderPass. Dynamic rendering uses the image views directly
 	void CreateFramebuffers(vk::Device device, vk::RenderPass renderPass);
 
+	// For when the surface has changed, e.g. the window was resized. Nothing can still be using the old swapchain
+	// Framebuffers are destroyed along with the old swapchain, and have to be created again afterwards if they're needed
+	void RecreateSwapChain(vk::Device device, vk::SurfaceKHR surface, GLFWwindow* window, SwapChainSupportInfo supportInfo, QueueFamilyIndices qfIndices);
+
 	// Getters
 	vk::SwapchainKHR GetSwapchain() const { return m_swapChain; };
 	vk::Format GetFormat() const { return m_imageFormat; };
 	vk::Extent2D GetExtent() const { return m_extent; };
 	vk::Framebuffer GetFramebuffer(uint32_t index) const { return m_frameBuffers[index]; };
+	vk::Image GetSwapChainImage(uint32_t index) const { return m_swapChainImages[index]; };
+	vk::ImageView GetImageView(uint32_t index) const { return m_imageViews[index]; };
 
 	std::vector<vk::Image> GetSwapChainImages() const { return m_swapChainImages; };
 	std::vector<vk::Framebuffer> GetFramebufferVector() const { return m_frameBuffers; };
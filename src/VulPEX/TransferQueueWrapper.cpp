@@ -0,0 +1,128 @@
+#include "TransferQueueWrapper.hpp"
+
+#include <algorithm>
+
+// Private
+void TransferQueueWrapper::RecycleCompletedCommandBuffers(vk::Device device)
+{
+	uint64_t completedValue = device.getSemaphoreCounterValue(m_timelineSemaphore);
+
+	std::vector<std::pair<uint32_t, uint64_t>>::iterator firstPending = std::partition(m_pendingCommandBuffers.begin(), m_pendingCommandBuffers.end(),
+		[completedValue](const std::pair<uint32_t, uint64_t>& pending) { return pending.second <= completedValue; });
+
+	for (std::vector<std::pair<uint32_t, uint64_t>>::iterator it = m_pendingCommandBuffers.begin(); it != firstPending; it++)
+	{
+		m_freeCommandBuffers.push_back(it->first);
+	}
+
+	m_pendingCommandBuffers.erase(m_pendingCommandBuffers.begin(), firstPending);
+}
+
+// Public
+void TransferQueueWrapper::CreateTransferQueue(vk::Device device, vk::Queue queue, uint32_t queueFamilyIndex)
+{
+	m_queue = queue;
+
+	// Command buffers are reused individually, so they need to be resettable on their own
+	m_commandPool.CreateCommandPool(device, vk::CommandPoolCreateFlagBits::eResetCommandBuffer, queueFamilyIndex);
+
+	vk::SemaphoreTypeCreateInfo timelineInfo(
+		vk::SemaphoreType::eTimeline,	//semaphoreType
+		0								//initialValue
+	);
+
+	vk::SemaphoreCreateInfo semaphoreInfo(
+		{},				//flags
+		&timelineInfo	//pNext
+	);
+
+	m_timelineSemaphore = device.createSemaphore(semaphoreInfo);
+}
+
+TransferTicket TransferQueueWrapper::SubmitCopies(vk::Device device, vk::Buffer source, vk::Buffer destination, std::vector<vk::BufferCopy> copyRegions)
+{
+	return SubmitCopies(device, { { source, destination, copyRegions } });
+}
+
+TransferTicket TransferQueueWrapper::SubmitCopies(vk::Device device, std::vector<BufferCopyBatch> copyBatches, vk::Semaphore waitSemaphore,
+												   uint64_t waitValue)
+{
+	RecycleCompletedCommandBuffers(device);
+
+	uint32_t bufferIndex;
+	if (m_freeCommandBuffers.empty())
+	{
+		bufferIndex = m_commandPool.CreateCommandBuffers(device, vk::CommandBufferLevel::ePrimary, 1)[0];
+	}
+	else
+	{
+		bufferIndex = m_freeCommandBuffers.back();
+		m_freeCommandBuffers.pop_back();
+	}
+
+	// Beginning a command buffer from a pool with eResetCommandBuffer implicitly resets it
+	m_commandPool.BeginRecordingToBuffer(bufferIndex, vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+	for (const BufferCopyBatch& copyBatch : copyBatches)
+	{
+		m_commandPool.GetCommandBuffer(bufferIndex).copyBuffer(copyBatch.source, copyBatch.destination, copyBatch.copyRegions);
+	}
+	m_commandPool.EndRecordingToBuffer(bufferIndex);
+
+	uint32_t waitCount = waitSemaphore != nullptr ? 1 : 0;
+	vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eTransfer;
+
+	uint64_t signalValue = m_lastSubmittedValue + 1;
+	vk::TimelineSemaphoreSubmitInfo timelineSubmitInfo(
+		waitCount,		//waitSemaphoreValueCount
+		&waitValue,		//pWaitSemaphoreValues
+		1,				//signalSemaphoreValueCount
+		&signalValue	//pSignalSemaphoreValues
+	);
+
+	vk::CommandBuffer commandBuffer = m_commandPool.GetCommandBuffer(bufferIndex);
+	vk::SubmitInfo submitInfo(
+		waitCount,				//waitSemaphoreCount
+		&waitSemaphore,			//pWaitSemaphores
+		&waitStage,				//pWaitDstStageMask
+		1,						//commandBufferCount
+		&commandBuffer,			//pCommandBuffers
+		1,						//signalSemaphoreCount
+		&m_timelineSemaphore,	//pSignalSemaphores
+		&timelineSubmitInfo		//pNext
+	);
+
+	m_queue.submit(submitInfo);
+
+	m_lastSubmittedValue = signalValue;
+	m_pendingCommandBuffers.push_back({ bufferIndex, signalValue });
+
+	return { signalValue };
+}
+
+bool TransferQueueWrapper::IsComplete(vk::Device device, TransferTicket ticket) const
+{
+	return device.getSemaphoreCounterValue(m_timelineSemaphore) >= ticket.value;
+}
+
+void TransferQueueWrapper::Wait(vk::Device device, TransferTicket ticket) const
+{
+	vk::SemaphoreWaitInfo waitInfo(
+		{},						//flags
+		1,						//semaphoreCount
+		&m_timelineSemaphore,	//pSemaphores
+		&ticket.value			//pValues
+	);
+
+	vk::Result result = device.waitSemaphores(waitInfo, UINT64_MAX);
+	if (result == vk::Result::eTimeout)
+	{
+		throw std::runtime_error("Timed out while waiting for transfer " + std::to_string(ticket.value));
+	}
+}
+
+void TransferQueueWrapper::DestroyTransferQueue(vk::Device device)
+{
+	m_commandPool.DestroyCommandPool(device);
+
+	if (m_timelineSemaphore != nullptr) { device.destroySemaphore(m_timelineSemaphore); }
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+
+#include "Utility/VulkanDynamicInclude.hpp"
+
+#include "CommandPoolWrapper.hpp"
+
+// Returned by every transfer submission. The transfer is finished once the timeline semaphore reaches value
+struct TransferTicket
+{
+	uint64_t value = 0;
+};
+
+// Every region copied from one buffer into another. Several of these can go into a single submission
+struct BufferCopyBatch
+{
+	vk::Buffer source = nullptr;
+	vk::Buffer destination = nullptr;
+
+	std::vector<vk::BufferCopy> copyRegions;
+};
+
+// Submits copies to a (preferably dedicated) transfer queue without ever blocking the CPU
+// Completion is tracked with a timeline semaphore, which other queues can wait on directly on the GPU
+class TransferQueueWrapper
+{
+	// Vulkan resources
+	vk::Queue m_queue = nullptr;
+	vk::Semaphore m_timelineSemaphore = nullptr;
+
+	CommandPoolWrapper m_commandPool;
+
+	// Misc resources
+	uint64_t m_lastSubmittedValue = 0;
+
+	// Command buffers can't be reused until the GPU is done with them, so they're recycled once their ticket completes
+	std::vector<std::pair<uint32_t, uint64_t>> m_pendingCommandBuffers;
+	std::vector<uint32_t> m_freeCommandBuffers;
+
+	// Functions
+	void RecycleCompletedCommandBuffers(vk::Device device);
+
+public:
+	void CreateTransferQueue(vk::Device device, vk::Queue queue, uint32_t queueFamilyIndex);
+
+	TransferTicket SubmitCopies(vk::Device device, vk::Buffer source, vk::Buffer destination, std::vector<vk::BufferCopy> copyRegions);
+	// Records every batch into one command buffer, and submits it with one vkQueueSubmit
+	// If waitSemaphore is a timeline semaphore, the copies won't start on the GPU until it reaches waitValue
+	TransferTicket SubmitCopies(vk::Device device, std::vector<BufferCopyBatch> copyBatches, vk::Semaphore waitSemaphore = nullptr, uint64_t waitValue = 0);
+
+	bool IsComplete(vk::Device device, TransferTicket ticket) const;
+	void Wait(vk::Device device, TransferTicket ticket) const;
+
+	// Getters
+	vk::Semaphore GetTimelineSemaphore() const { return m_timelineSemaphore; };
+
+	// Waiting on this ticket waits on every transfer submitted so far
+	TransferTicket GetLastSubmittedTicket() const { return { m_lastSubmittedValue }; };
+
+	// Cleanup
+	void DestroyTransferQueue(vk::Device device);
+};
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "UploadBatcher.hpp"
+
+#include <algorithm>
+#include <functional>
+
+// Private
+std::vector<BufferCopyBatch> UploadBatcher::CoalesceCopies()
+{
+	// Handles don't have a meaningful order, we just need copies between the same two buffers to end up next to each other
+	std::less<VkBuffer> handleLess;
+	std::sort(m_pendingCopies.begin(), m_pendingCopies.end(), [&handleLess](const PendingCopy& a, const PendingCopy& b)
+	{
+		if (a.source != b.source) { return handleLess(static_cast<VkBuffer>(a.source), static_cast<VkBuffer>(b.source)); }
+		if (a.destination != b.destination) { return handleLess(static_cast<VkBuffer>(a.destination), static_cast<VkBuffer>(b.destination)); }
+
+		return a.copyRegion.srcOffset < b.copyRegion.srcOffset;
+	});
+
+	std::vector<BufferCopyBatch> copyBatches;
+
+	for (const PendingCopy& pendingCopy : m_pendingCopies)
+	{
+		if (copyBatches.empty() || copyBatches.back().source != pendingCopy.source || copyBatches.back().destination != pendingCopy.destination)
+		{
+			copyBatches.push_back({ pendingCopy.source, pendingCopy.destination, { pendingCopy.copyRegion } });
+			continue;
+		}
+
+		// If this copy carries on exactly where the last one left off at both ends, they can be done as one
+		vk::BufferCopy& previousRegion = copyBatches.back().copyRegions.back();
+		if (previousRegion.srcOffset + previousRegion.size == pendingCopy.copyRegion.srcOffset &&
+			previousRegion.dstOffset + previousRegion.size == pendingCopy.copyRegion.dstOffset)
+		{
+			previousRegion.size += pendingCopy.copyRegion.size;
+		}
+		else
+		{
+			copyBatches.back().copyRegions.push_back(pendingCopy.copyRegion);
+		}
+	}
+
+	return copyBatches;
+}
+
+// Public
+void UploadBatcher::QueueCopy(vk::Buffer source, vk::Buffer destination, vk::BufferCopy copyRegion)
+{
+	m_pendingCopies.push_back({ source, destination, copyRegion });
+}
+
+void UploadBatcher::QueueCopies(vk::Buffer source, vk::Buffer destination, std::vector<vk::BufferCopy> copyRegions)
+{
+	for (vk::BufferCopy copyRegion : copyRegions)
+	{
+		m_pendingCopies.push_back({ source, destination, copyRegion });
+	}
+}
+
+TransferTicket UploadBatcher::Flush(vk::Device device, TransferQueueWrapper* transferQueue, vk::Semaphore waitSemaphore, uint64_t waitValue)
+{
+	m_lastFlushRegionCount = 0;
+
+	if (m_pendingCopies.empty()) { return {}; }
+
+	std::vector<BufferCopyBatch> copyBatches = CoalesceCopies();
+	m_pendingCopies.clear();
+
+	for (const BufferCopyBatch& copyBatch : copyBatches)
+	{
+		m_lastFlushRegionCount += copyBatch.copyRegions.size();
+	}
+
+	return transferQueue->SubmitCopies(device, copyBatches, waitSemaphore, waitValue);
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+
+#include "Utility/VulkanDynamicInclude.hpp"
+
+#include "TransferQueueWrapper.hpp"
+
+struct PendingCopy
+{
+	vk::Buffer source = nullptr;
+	vk::Buffer destination = nullptr;
+
+	vk::BufferCopy copyRegion;
+};
+
+// Collects every staging-to-device copy made during a frame, and sends them all to the GPU in one command buffer and one submit
+// Only buffer copies are supported for now, since VulPEX doesn't have any images to upload to yet
+class UploadBatcher
+{
+	// Misc resources
+	std::vector<PendingCopy> m_pendingCopies;
+
+	uint32_t m_lastFlushRegionCount = 0;
+
+	// Functions
+	// Sorts pending copies, merges any that are contiguous in both source and destination, and groups them by buffer pair
+	std::vector<BufferCopyBatch> CoalesceCopies();
+
+public:
+	void QueueCopy(vk::Buffer source, vk::Buffer destination, vk::BufferCopy copyRegion);
+	void QueueCopies(vk::Buffer source, vk::Buffer destination, std::vector<vk::BufferCopy> copyRegions);
+
+	// Returns an already complete ticket if nothing was queued
+	// waitSemaphore and waitValue are passed on to TransferQueueWrapper::SubmitCopies
+	TransferTicket Flush(vk::Device device, TransferQueueWrapper* transferQueue, vk::Semaphore waitSemaphore = nullptr, uint64_t waitValue = 0);
+
+	// Getters
+	size_t GetPendingCopyCount() const { return m_pendingCopies.size(); };
+
+	// The number of regions actually recorded by the last flush, after coalescing
+	uint32_t GetLastFlushRegionCount() const { return m_lastFlushRegionCount; };
+};
\ No newline at end of file
@@ -5,7 +5,20 @@
 enum VulkanFormat
 {
 	eVec2 = (int)vk::Format::eR32G32Sfloat,
-	eVec3 = (int)vk::Format::eR32G32B32Sfloat
+	eVec3 = (int)vk::Format::eR32G32B32Sfloat,
+	eVec4 = (int)vk::Format::eR32G32B32A32Sfloat,
+
+	// Packed formats, which are expanded back to floats when the vertex is fetched, so shaders read them as vec2s and vec4s as normal
+	eHalf2 = (int)vk::Format::eR16G16Sfloat,
+	eHalf4 = (int)vk::Format::eR16G16B16A16Sfloat,
+	eSnorm8x4 = (int)vk::Format::eR8G8B8A8Snorm,
+	eUnorm8x4 = (int)vk::Format::eR8G8B8A8Unorm,
+	eSnorm16x2 = (int)vk::Format::eR16G16Snorm,
+	eSnorm16x4 = (int)vk::Format::eR16G16B16A16Snorm,
+	eUnorm16x2 = (int)vk::Format::eR16G16Unorm,
+	eUnorm16x4 = (int)vk::Format::eR16G16B16A16Unorm,
+	eA2B10G10R10Unorm = (int)vk::Format::eA2B10G10R10UnormPack32,
+	eA2B10G10R10Snorm = (int)vk::Format::eA2B10G10R10SnormPack32
 };
 
 // Int vectors
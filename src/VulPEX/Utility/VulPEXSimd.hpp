@@ -0,0 +1,11 @@
+#pragma once
+
+// Picks whichever SIMD instruction set every CPU on the target platform is guaranteed to have, so nothing needs checking at runtime
+// SSE2 is part of x86-64, and NEON is part of AArch64. Anything else falls back on plain loops
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define VULPEX_SIMD_SSE2
+#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+	#include <arm_neon.h>
+	#define VULPEX_SIMD_NEON
+#endif
\ No newline at end of file
@@ -5,10 +5,16 @@ VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
 #include <vector>
 #include <map>
 #include <set>
+#include <algorithm>
+#include <cstring>
+#include <chrono>
 
 #include <Logger.hpp>
 
 #include "Utility/VulPEXUtils.hpp"
+#include "Modules/MeshProcessing/MeshOptimiser.hpp"
+#include "Modules/MeshProcessing/MeshSimplifier.hpp"
+#include "Modules/MeshProcessing/IndexNarrowing.hpp"
 
 // Private Methods
 
@@ -26,6 +32,19 @@ void VulkanApplication::CreateVulkanInstance(vk::ApplicationInfo appInfo, std::v
 		throw std::runtime_error("One or more of the extensions specified are not supported by the target system"); 
 	}
 
+	// Everything from dynamic rendering to timeline semaphores is used as core 1.3 functionality, and features can only be queried
+	// with getFeatures2 (which physical device selection relies on) if the instance asked for at least 1.1
+	if (vk::enumerateInstanceVersion() < VK_API_VERSION_1_3)
+	{
+		throw std::runtime_error("Could not continue, as the installed Vulkan loader doesn't support Vulkan 1.3");
+	}
+
+	if (appInfo.apiVersion < VK_API_VERSION_1_3)
+	{
+		Logger::Log({ "Application asked for a Vulkan version older than 1.3, which VulPEX needs, so 1.3 is being used instead" }, LogType::Warning);
+		appInfo.apiVersion = VK_API_VERSION_1_3;
+	}
+
 	// Validation layers
 	uint32_t enabledLayerCount = 0;
 	const char* const* enabledLayerNames = nullptr;
@@ -56,178 +75,445 @@ void VulkanApplication::CreateVulkanInstance(vk::ApplicationInfo appInfo, std::v
 	m_vulkanInstance = vk::createInstance(instanceInfo);
 }
 
-// Public Methods
-void VulkanApplication::Init(WindowInfo winInfo, vk::ApplicationInfo appInfo, std::vector<const char*> vkExtensions,
-							 vk::InstanceCreateFlags vkFlags)
+void VulkanApplication::ConfigureDynamicStateSupport()
 {
-	VULKAN_HPP_DEFAULT_DISPATCHER.init();
+	if (!m_useExtendedDynamicState) { return; }
 
-    // Create window
-    m_window.CreateWindow(winInfo);
+	// Everything in the original extended dynamic state extensions is core in 1.3
+	m_dynamicStateSupport.enabled = true;
 
-    // --Init Vulkan--
-	// Set up our debug messenger. We need to initialise Vulkan before we create the messenger,
-	// but we need info from here to initialise Vulkan in debug mode
-	#ifdef _DEBUG
-		m_debugMessenger.SetUpDebugCallback();
-	#endif
+	std::string supportMessage = "Extended dynamic state enabled for topology, primitive restart, cull mode and front face";
 
-	// Initialise vulkan
-	CreateVulkanInstance(appInfo, vkExtensions, vkFlags);
-	VULKAN_HPP_DEFAULT_DISPATCHER.init(m_vulkanInstance);
+	if (m_physicalDevice.IsDeviceExtensionSupported(vk::EXTExtendedDynamicState3ExtensionName))
+	{
+		vk::PhysicalDevice physicalDevice = m_physicalDevice.GetPhysicalDevice();
+
+		vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT supportedFeatures =
+			physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT>()
+				.get<vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT>();
+		vk::PhysicalDeviceExtendedDynamicState3PropertiesEXT properties =
+			physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceExtendedDynamicState3PropertiesEXT>()
+				.get<vk::PhysicalDeviceExtendedDynamicState3PropertiesEXT>();
+
+		// Only enable the parts we actually use
+		vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT enabledFeatures;
+		enabledFeatures.extendedDynamicState3PolygonMode = supportedFeatures.extendedDynamicState3PolygonMode;
+		enabledFeatures.extendedDynamicState3ColorBlendEnable = supportedFeatures.extendedDynamicState3ColorBlendEnable &&
+																 supportedFeatures.extendedDynamicState3ColorBlendEquation;
+		enabledFeatures.extendedDynamicState3ColorBlendEquation = enabledFeatures.extendedDynamicState3ColorBlendEnable;
+
+		m_dynamicStateSupport.polygonMode = enabledFeatures.extendedDynamicState3PolygonMode;
+		m_dynamicStateSupport.colourBlend = enabledFeatures.extendedDynamicState3ColorBlendEnable;
+		m_dynamicStateSupport.unrestrictedTopology = properties.dynamicPrimitiveTopologyUnrestricted;
+
+		if (m_dynamicStateSupport.polygonMode || m_dynamicStateSupport.colourBlend)
+		{
+			m_physicalDevice.EnableDeviceExtension(vk::EXTExtendedDynamicState3ExtensionName);
+			m_logicalDevice.ConfigureExtendedDynamicState3(enabledFeatures);
+		}
+
+		if (m_dynamicStateSupport.polygonMode) { supportMessage += ", polygon mode"; }
+		if (m_dynamicStateSupport.colourBlend) { supportMessage += ", blend mode"; }
+		if (m_dynamicStateSupport.unrestrictedTopology) { supportMessage += " (any topology)"; }
+	}
 
-	// Initialise debug messenger
-	#ifdef _DEBUG
-		m_debugMessenger.LinkDebugCallback(m_vulkanInstance);
-	#endif
+	Logger::Log({ supportMessage.c_str() }, LogType::Info);
+}
 
-	// Create the GLFW surface we'll be using in our swapchain
-	m_displaySurface.CreateDisplaySurface(m_vulkanInstance, m_window.GetWindow());
+void VulkanApplication::ConfigureIndirectDrawSupport()
+{
+	vk::PhysicalDevice physicalDevice = m_physicalDevice.GetPhysicalDevice();
 
-	// Find and select a GPU to render with
-	m_physicalDevice.SelectDevice(m_vulkanInstance, m_displaySurface.GetSurface());
+	m_multiDrawIndirect = physicalDevice.getFeatures().multiDrawIndirect;
+	m_drawIndirectFirstInstance = physicalDevice.getFeatures().drawIndirectFirstInstance;
+	m_drawIndirectCount = physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>()
+							  .get<vk::PhysicalDeviceVulkan12Features>().drawIndirectCount;
 
-	// Create a logical device to interface with our physical device
-	#ifdef _DEBUG
-	m_logicalDevice.CreateLogicalDevice(m_physicalDevice.GetPhysicalDevice(), m_displaySurface.GetSurface(), m_physicalDevice.GetDeviceExtensions(),
-										m_debugMessenger.GetValidationLayers());
-	#else
-	m_logicalDevice.CreateLogicalDevice(m_physicalDevice.GetPhysicalDevice(), m_displaySurface.GetSurface(), m_physicalDevice.GetDeviceExtensions());
-	#endif
+	m_logicalDevice.ConfigureIndirectDrawing(m_multiDrawIndirect, m_drawIndirectCount, m_drawIndirectFirstInstance);
 
-	VULKAN_HPP_DEFAULT_DISPATCHER.init(m_logicalDevice.GetLogicalDevice());
+	std::string supportMessage = "Indirect drawing: ";
+	if (m_drawIndirectCount) { supportMessage += "one draw call per batch, with GPU draw counts"; }
+	else if (m_multiDrawIndirect) { supportMessage += "one draw call per batch"; }
+	else { supportMessage += "one draw call per object, as multiDrawIndirect isn't supported"; }
+	if (!m_drawIndirectFirstInstance) { supportMessage += ", without per-object instance data"; }
 
-	// Create a swapchain to present images to the screen with
-	m_swapChain.CreateSwapChain(m_logicalDevice.GetLogicalDevice(), m_displaySurface.GetSurface(), m_window.GetWindow(),
-								m_physicalDevice.GetSwapChainSupportInfo(), m_logicalDevice.GetQueueFamilyIndices());
+	Logger::Log({ supportMessage.c_str() }, LogType::Info);
 }
 
-void VulkanApplication::GraphicsPipelineSetup(ShaderInfo shaderInfo, uint32_t sizeOfVertex, std::pair<vk::Format, uint32_t>* vertexVarsInfo,
-											  size_t vertexVarsInfoCount, std::vector<DataStructures::Vertex> verts, std::vector<uint32_t> indices)
+void VulkanApplication::CreateFrameResources()
 {
-	// Create a graphics pipeline to run shaders and draw our image
-	m_graphicsPipeline.CreateGraphicsPipeline(m_logicalDevice.GetLogicalDevice(), shaderInfo, m_swapChain.GetExtent(), m_swapChain.GetFormat(),
-											  sizeOfVertex, vertexVarsInfo, vertexVarsInfoCount);
-
-	// Create framebuffers to display our image
-	m_swapChain.CreateFramebuffers(m_logicalDevice.GetLogicalDevice(), m_graphicsPipeline.GetRenderPass());
-
-	// Create vertex buffers to so we can send our vertex data to the GPU
-	// Staging buffer
-	// TODO: This needs to be made on the fly when loading data, eventually
-	uint32_t qfIndicesArray[] = { m_logicalDevice.GetQueueFamilyIndices().queueFamilies.at("graphicsQueueFamily"),
-								  m_logicalDevice.GetQueueFamilyIndices().queueFamilies.at("transferQueueFamily") };
-	vk::BufferCreateInfo vertexBufferInfo(
-		{},											//flags
-		sizeOfVertex * verts.size(),				//size
-		vk::BufferUsageFlagBits::eTransferSrc,		//usage
-		vk::SharingMode::eConcurrent,				//sharingMode
-		2,											//queueFamilyIndexCount
-		qfIndicesArray								//pQueueFamilyIndices
+	vk::Device logicalDevice = m_logicalDevice.GetLogicalDevice();
+
+	// This has no functionality as of yet, but we have to specify it in case a future version of Vulkan defines some
+	vk::SemaphoreCreateInfo semaphoreInfo;
+
+	// Fences start signalled, so that the first wait on each frame doesn't hang forever
+	vk::FenceCreateInfo fenceInfo(
+		vk::FenceCreateFlagBits::eSignaled	//flags
+	);
+
+	m_frames.resize(m_framesInFlight);
+	for (FrameResources& frame : m_frames)
+	{
+		// The whole pool is reset at the start of the frame, so its command buffers are always short-lived
+		frame.commandPool.CreateCommandPool(logicalDevice, vk::CommandPoolCreateFlagBits::eTransient,
+											m_logicalDevice.GetQueueFamilyIndices().queueFamilies.at("graphicsQueueFamily"));
+		frame.commandBufferIndex = frame.commandPool.CreateCommandBuffers(logicalDevice, vk::CommandBufferLevel::ePrimary, 1)[0];
+
+		frame.imageAvailable = logicalDevice.createSemaphore(semaphoreInfo);
+		frame.inFlight = logicalDevice.createFence(fenceInfo);
+	}
+
+	// Cached command buffers are re-recorded individually, so they need to be resettable on their own
+	m_cachedCommandPool.CreateCommandPool(logicalDevice, vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+										  m_logicalDevice.GetQueueFamilyIndices().queueFamilies.at("graphicsQueueFamily"));
+
+	CreateSwapChainImageResources();
+
+	vk::SemaphoreTypeCreateInfo timelineInfo(
+		vk::SemaphoreType::eTimeline,	//semaphoreType
+		0								//initialValue
 	);
-	// TODO: Those MemoryProperty bits should probably be customisable
-	m_vertexStagingBuffer.CreateBuffer(m_physicalDevice.GetPhysicalDevice(), m_logicalDevice.GetLogicalDevice(), vertexBufferInfo,
-									   vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
-
-	//Device buffer
-	vertexBufferInfo.usage = vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer;
-	m_vertexDeviceBuffer.CreateBuffer(m_physicalDevice.GetPhysicalDevice(), m_logicalDevice.GetLogicalDevice(), vertexBufferInfo,
-									  vk::MemoryPropertyFlagBits::eDeviceLocal);
-	
-	// Create index buffers to so we can send our index data to the GPU
-	// Staging buffer
-	// TODO: This needs to be made on the fly when loading data, eventually
-	vk::BufferCreateInfo indexBufferInfo(
-		{},											//flags
-		sizeof(uint32_t) * indices.size(),			//size
-		vk::BufferUsageFlagBits::eTransferSrc,		//usage
-		vk::SharingMode::eConcurrent,				//sharingMode
-		2,											//queueFamilyIndexCount
-		qfIndicesArray								//pQueueFamilyIndices
+	vk::SemaphoreCreateInfo timelineSemaphoreInfo(
+		{},				//flags
+		&timelineInfo	//pNext
 	);
-	// TODO: Those MemoryProperty bits should probably be customisable
-	m_indexStagingBuffer.CreateBuffer(m_physicalDevice.GetPhysicalDevice(), m_logicalDevice.GetLogicalDevice(), indexBufferInfo,
-									   vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
 
-	//Device buffer
-	indexBufferInfo.usage = vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer;
-	m_indexDeviceBuffer.CreateBuffer(m_physicalDevice.GetPhysicalDevice(), m_logicalDevice.GetLogicalDevice(), indexBufferInfo,
-									  vk::MemoryPropertyFlagBits::eDeviceLocal);
+	m_renderTimeline = logicalDevice.createSemaphore(timelineSemaphoreInfo);
 
-	m_graphicsCommandPool.CreateCommandPool(m_logicalDevice.GetLogicalDevice(), vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
-											m_logicalDevice.GetQueueFamilyIndices().queueFamilies.at("graphicsQueueFamily"));
-	m_renderCommandBufferIndex = m_graphicsCommandPool.CreateCommandBuffers(m_logicalDevice.GetLogicalDevice(), vk::CommandBufferLevel::ePrimary, 1)[0];
+	CreateWorkerCommandPools();
+}
 
-	m_transientTransferCommandPool.CreateCommandPool(m_logicalDevice.GetLogicalDevice(), vk::CommandPoolCreateFlagBits::eTransient,
-													 m_logicalDevice.GetQueueFamilyIndices().queueFamilies.at("transferQueueFamily"));
+void VulkanApplication::CreateSwapChainImageResources()
+{
+	vk::Device logicalDevice = m_logicalDevice.GetLogicalDevice();
 
-	// TODO: Find somewhere better to initialise these
-	// This has no functionality as of yet, but we have to specify it in case a future version of Vulkan defines some
 	vk::SemaphoreCreateInfo semaphoreInfo;
-	vk::FenceCreateInfo fenceInfo(
-		vk::FenceCreateFlagBits::eSignaled	//flags
-	);
 
-	m_imageAvailable = m_logicalDevice.GetLogicalDevice().createSemaphore(semaphoreInfo);
-	m_renderFinished = m_logicalDevice.GetLogicalDevice().createSemaphore(semaphoreInfo);
-	m_startRender = m_logicalDevice.GetLogicalDevice().createFence(fenceInfo);
+	size_t swapChainImageCount = m_swapChain.GetSwapChainImages().size();
+
+	m_renderFinished.resize(swapChainImageCount);
+	for (vk::Semaphore& renderFinished : m_renderFinished)
+	{
+		renderFinished = logicalDevice.createSemaphore(semaphoreInfo);
+	}
+
+	m_imagesInFlight.assign(swapChainImageCount, nullptr);
+
+	m_cachedCommandBufferIndices = m_cachedCommandPool.CreateCommandBuffers(logicalDevice, vk::CommandBufferLevel::ePrimary, swapChainImageCount);
+	m_cachedCommandBuffersValid.assign(swapChainImageCount, false);
 }
 
-void VulkanApplication::RenderFrame(uint32_t sizeOfVertex, std::vector<DataStructures::Vertex> verts, std::vector<uint32_t> indices)
+void VulkanApplication::DestroySwapChainImageResources()
 {
-	vk::Result result;
+	vk::Device logicalDevice = m_logicalDevice.GetLogicalDevice();
 
-	result = m_logicalDevice.GetLogicalDevice().waitForFences(m_startRender, vk::True, UINT64_MAX);
-	if (result == vk::Result::eTimeout)
+	for (vk::Semaphore renderFinished : m_renderFinished)
 	{
-		throw std::runtime_error("Timed out while waiting for fence \"m_startRender\"");
+		logicalDevice.destroySemaphore(renderFinished);
 	}
-	m_graphicsCommandPool.ResetCommandPool(m_logicalDevice.GetLogicalDevice());
-	m_logicalDevice.GetLogicalDevice().resetFences(m_startRender);
+	m_renderFinished.clear();
 
-	uint32_t scImageIndex;
-	std::tie(result, scImageIndex) = m_logicalDevice.GetLogicalDevice().acquireNextImageKHR(m_swapChain.GetSwapchain(), UINT64_MAX, m_imageAvailable, nullptr);
-	if (result == vk::Result::eTimeout)
+	m_imagesInFlight.clear();
+
+	if (!m_cachedCommandBufferIndices.empty()) { m_cachedCommandPool.EmptyCommandPool(logicalDevice); }
+	m_cachedCommandBufferIndices.clear();
+	m_cachedCommandBuffersValid.clear();
+}
+
+void VulkanApplication::RecreateSwapChain()
+{
+	// A minimised window has no size, and there's nothing we could create a swapchain for until it comes back
+	int width = 0, height = 0;
+	glfwGetFramebufferSize(m_window.GetWindow(), &width, &height);
+	while ((width == 0 || height == 0) && m_window.IsWindowRunning())
 	{
-		throw std::runtime_error("Timed out while acquiring next swapchain image");
+		glfwWaitEvents();
+		glfwGetFramebufferSize(m_window.GetWindow(), &width, &height);
 	}
-	
 
-	m_vertexStagingBuffer.FillBuffer(m_logicalDevice.GetLogicalDevice(), verts.data(), sizeOfVertex, verts.size());
+	vk::Device logicalDevice = m_logicalDevice.GetLogicalDevice();
+
+	// Every frame in flight could be using the old swapchain's images
+	logicalDevice.waitIdle();
+
+	m_physicalDevice.RefreshSwapChainSupportInfo(m_displaySurface.GetSurface());
+	m_swapChain.RecreateSwapChain(logicalDevice, m_displaySurface.GetSurface(), m_window.GetWindow(), m_physicalDevice.GetSwapChainSupportInfo(),
+								  m_logicalDevice.GetQueueFamilyIndices());
 
-	m_vertexStagingBuffer.CopyBuffer(m_logicalDevice.GetLogicalDevice(), m_logicalDevice.GetQueue("transferQueue"), &m_transientTransferCommandPool,
-									 m_vertexDeviceBuffer.GetBuffer());
+	// Pipelines are built against this format, whether that's through the render pass or directly
+	if (m_swapChain.GetFormat() != m_graphicsPipeline.GetColourFormat())
+	{
+		throw std::runtime_error("Swapchain format changed when it was recreated, which would need every pipeline rebuilding");
+	}
+
+	// With dynamic rendering, that's the end of it. Otherwise, the framebuffers need making again for the new image views
+	if (!m_useDynamicRendering)
+	{
+		m_swapChain.CreateFramebuffers(logicalDevice, m_graphicsPipeline.GetRenderPass());
+	}
 
-	m_indexStagingBuffer.FillBuffer(m_logicalDevice.GetLogicalDevice(), indices.data(), sizeof(uint32_t), indices.size());
+	// The image count can change too
+	DestroySwapChainImageResources();
+	CreateSwapChainImageResources();
 
-	m_indexStagingBuffer.CopyBuffer(m_logicalDevice.GetLogicalDevice(), m_logicalDevice.GetQueue("transferQueue"), &m_transientTransferCommandPool,
-									m_indexDeviceBuffer.GetBuffer());
+	vk::Extent2D extent = m_swapChain.GetExtent();
+	std::string recreationMessage = "Swapchain recreated at " + std::to_string(extent.width) + "x" + std::to_string(extent.height);
+	Logger::Log({ recreationMessage.c_str() }, LogType::Info);
+}
 
-	// Graphics buffer recording start
-	vk::Extent2D scExtent = m_swapChain.GetExtent();
+void VulkanApplication::CreateWorkerCommandPools()
+{
+	vk::Device logicalDevice = m_logicalDevice.GetLogicalDevice();
+
+	for (FrameResources& frame : m_frames)
+	{
+		for (CommandPoolWrapper& workerPool : frame.workerPools)
+		{
+			workerPool.DestroyCommandPool(logicalDevice);
+		}
+
+		frame.workerPools.clear();
+		frame.workerBufferIndices.clear();
+
+		if (m_recordingWorkerCount < 2) { continue; }
+
+		frame.workerPools.resize(m_recordingWorkerCount);
+		for (CommandPoolWrapper& workerPool : frame.workerPools)
+		{
+			workerPool.CreateCommandPool(logicalDevice, vk::CommandPoolCreateFlagBits::eTransient,
+										 m_logicalDevice.GetQueueFamilyIndices().queueFamilies.at("graphicsQueueFamily"));
+			frame.workerBufferIndices.push_back(workerPool.CreateCommandBuffers(logicalDevice, vk::CommandBufferLevel::eSecondary, 1)[0]);
+		}
+	}
+}
+
+void VulkanApplication::UploadDirtyGeometry()
+{
+	// Geometry whose first upload gets fully staged this frame, which becomes drawable once this frame's transfer completes
+	std::vector<GeometryBuffer*> stagedGeometries;
+
+	for (GeometryBuffer& geometry : m_geometries)
+	{
+		if (!geometry.IsDirty()) { continue; }
+
+		std::vector<vk::BufferCopy> vertexCopies;
+		std::vector<vk::BufferCopy> indexCopies;
+
+		m_frameStats.bytesUploaded += geometry.StageDirtyRanges(&m_stagingRing, vertexCopies, indexCopies);
+
+		m_uploadBatcher.QueueCopies(m_stagingRing.GetBuffer(), geometry.GetVertexBuffer(), vertexCopies);
+		m_uploadBatcher.QueueCopies(m_stagingRing.GetBuffer(), geometry.GetIndexBuffer(), indexCopies);
+
+		if (!geometry.IsResident() && !geometry.IsDirty()) { stagedGeometries.push_back(&geometry); }
+	}
+
+	for (InstanceBuffer& instanceBuffer : m_instanceBuffers)
+	{
+		if (!instanceBuffer.IsDirty()) { continue; }
+
+		std::vector<vk::BufferCopy> instanceCopies;
+
+		m_frameStats.bytesUploaded += instanceBuffer.StageDirtyRanges(&m_stagingRing, instanceCopies);
+
+		m_uploadBatcher.QueueCopies(m_stagingRing.GetBuffer(), instanceBuffer.GetBuffer(), instanceCopies);
+	}
+
+	// Meshes were staged as they were added, so their copies just have to go out
+	if (m_meshRegistry.IsDirty())
+	{
+		m_frameStats.bytesUploaded += m_meshRegistry.QueuePendingUploads(&m_uploadBatcher);
+	}
+
+	for (MeshFileUpload& upload : m_meshFileUploads)
+	{
+		if (upload.ticket.has_value()) { continue; }
+
+		const MeshRange& range = m_meshRegistry.GetMesh(upload.mesh);
+		vk::DeviceSize vertexByteOffset = (vk::DeviceSize)range.vertexOffset * m_meshRegistry.GetSizeOfVertex();
+		vk::DeviceSize indexByteOffset = (vk::DeviceSize)range.lods[0].firstIndex * MeshProcessing::GetIndexSize(range.indexType);
+
+		std::vector<vk::BufferCopy> vertexCopies;
+		std::vector<vk::BufferCopy> indexCopies;
+
+		m_frameStats.bytesUploaded += upload.vertexRanges.StageRanges(&m_stagingRing, (const char*)upload.file.GetVertexData(), vertexCopies);
+		m_frameStats.bytesUploaded += upload.indexRanges.StageRanges(&m_stagingRing, (const char*)upload.file.GetIndexData(), indexCopies);
+
+		// The ranges are relative to the file's sections, so the copies are moved to wherever the registry put the mesh
+		for (vk::BufferCopy& copy : vertexCopies) { copy.dstOffset += vertexByteOffset; }
+		for (vk::BufferCopy& copy : indexCopies) { copy.dstOffset += indexByteOffset; }
+
+		m_uploadBatcher.QueueCopies(m_stagingRing.GetBuffer(), m_meshRegistry.GetVertexBuffer(), vertexCopies);
+		m_uploadBatcher.QueueCopies(m_stagingRing.GetBuffer(), m_meshRegistry.GetIndexBuffer(), indexCopies);
+	}
+
+	if (m_frustumCuller.IsDirty())
+	{
+		std::vector<vk::BufferCopy> cullCopies;
+
+		m_frameStats.bytesUploaded += m_frustumCuller.StageDirtyRanges(&m_stagingRing, cullCopies);
+
+		m_uploadBatcher.QueueCopies(m_stagingRing.GetBuffer(), m_frustumCuller.GetBuffer(), cullCopies);
+	}
+
+	if (m_objectInstances.IsDirty())
+	{
+		std::vector<vk::BufferCopy> instanceCopies;
+
+		m_frameStats.bytesUploaded += m_objectInstances.StageDirtyRanges(&m_stagingRing, instanceCopies);
+
+		m_uploadBatcher.QueueCopies(m_stagingRing.GetBuffer(), m_objectInstances.GetBuffer(), instanceCopies);
+	}
+
+	if (m_indirectDraws.IsDirty())
+	{
+		std::vector<vk::BufferCopy> drawCopies;
+
+		m_frameStats.bytesUploaded += m_indirectDraws.StageDirtyRanges(&m_stagingRing, drawCopies);
+
+		m_uploadBatcher.QueueCopies(m_stagingRing.GetBuffer(), m_indirectDraws.GetBuffer(), drawCopies);
+	}
+
+	if (m_uploadBatcher.GetPendingCopyCount() == 0)
+	{
+		// Anything staged for an upload that was dropped since can be recycled straight away
+		m_stagingRing.MarkSubmitted({});
+		return;
+	}
+
+	// Earlier frames might still be drawing from the buffers we're about to overwrite, so the copies wait for them on the GPU
+	// m_frameNumber is the last frame we submitted, since the current frame hasn't been given a number yet
+	TransferTicket ticket = m_uploadBatcher.Flush(m_logicalDevice.GetLogicalDevice(), &m_transferQueue, m_renderTimeline, m_frameNumber);
+
+	m_stagingRing.MarkSubmitted(ticket);
+	m_meshRegistry.SetUploadTicket(ticket);
+
+	for (MeshFileUpload& upload : m_meshFileUploads)
+	{
+		if (!upload.ticket.has_value() && upload.vertexRanges.IsEmpty() && upload.indexRanges.IsEmpty()) { upload.ticket = ticket; }
+	}
+
+	for (GeometryBuffer* geometry : stagedGeometries)
+	{
+		geometry->SetUploadTicket(ticket);
+	}
 
-	m_graphicsCommandPool.BeginRecordingToBuffer(m_renderCommandBufferIndex);
+	m_frameStats.copyRegionCount += m_uploadBatcher.GetLastFlushRegionCount();
+	m_frameStats.transferSubmitCount++;
+}
 
+void VulkanApplication::BeginRendering(vk::CommandBuffer commandBuffer, uint32_t scImageIndex, vk::SubpassContents subpassContents)
+{
 	vk::ClearValue clearValue({ 0.0f, 0.0f, 0.0f, 1.0f });
-	vk::RenderPassBeginInfo rpBeginInfo(
-		m_graphicsPipeline.GetRenderPass(),				//renderPass
-		m_swapChain.GetFramebuffer(scImageIndex),			//framebuffer
-		{ {0, 0}, scExtent },	//renderArea
-		1,						//clearValueCount
-		&clearValue				//pClearValues
+
+	if (!m_useDynamicRendering)
+	{
+		vk::RenderPassBeginInfo rpBeginInfo(
+			m_graphicsPipeline.GetRenderPass(),			//renderPass
+			m_swapChain.GetFramebuffer(scImageIndex),	//framebuffer
+			{ {0, 0}, m_swapChain.GetExtent() },		//renderArea
+			1,											//clearValueCount
+			&clearValue									//pClearValues
+		);
+
+		commandBuffer.beginRenderPass(rpBeginInfo, subpassContents);
+		return;
+	}
+
+	// The render pass used to do these transitions for us
+	// We clear the whole image, so whatever was in it before can be thrown away
+	vk::ImageMemoryBarrier2 toAttachmentBarrier(
+		vk::PipelineStageFlagBits2::eColorAttachmentOutput,	//srcStageMask | Matches the stage that waits on imageAvailable
+		vk::AccessFlagBits2::eNone,							//srcAccessMask
+		vk::PipelineStageFlagBits2::eColorAttachmentOutput,	//dstStageMask
+		vk::AccessFlagBits2::eColorAttachmentWrite,			//dstAccessMask
+		vk::ImageLayout::eUndefined,						//oldLayout
+		vk::ImageLayout::eColorAttachmentOptimal,			//newLayout
+		vk::QueueFamilyIgnored,								//srcQueueFamilyIndex
+		vk::QueueFamilyIgnored,								//dstQueueFamilyIndex
+		m_swapChain.GetSwapChainImage(scImageIndex),		//image
+		{vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1}		//subresourceRange
 	);
 
-	// Render pass start
-	m_graphicsCommandPool.GetCommandBuffer(m_renderCommandBufferIndex).beginRenderPass(rpBeginInfo, vk::SubpassContents::eInline);
+	vk::DependencyInfo dependencyInfo(
+		{},						//dependencyFlags
+		0,						//memoryBarrierCount
+		nullptr,				//pMemoryBarriers
+		0,						//bufferMemoryBarrierCount
+		nullptr,				//pBufferMemoryBarriers
+		1,						//imageMemoryBarrierCount
+		&toAttachmentBarrier	//pImageMemoryBarriers
+	);
+	commandBuffer.pipelineBarrier2(dependencyInfo);
+
+	vk::RenderingAttachmentInfo colourAttachmentInfo(
+		m_swapChain.GetImageView(scImageIndex),		//imageView
+		vk::ImageLayout::eColorAttachmentOptimal,	//imageLayout
+		vk::ResolveModeFlagBits::eNone,				//resolveMode
+		nullptr,									//resolveImageView
+		vk::ImageLayout::eUndefined,				//resolveImageLayout
+		vk::AttachmentLoadOp::eClear,				//loadOp
+		vk::AttachmentStoreOp::eStore,				//storeOp
+		clearValue									//clearValue
+	);
+
+	vk::RenderingInfo renderingInfo(
+		subpassContents == vk::SubpassContents::eSecondaryCommandBuffers ?
+			vk::RenderingFlagBits::eContentsSecondaryCommandBuffers : vk::RenderingFlags(),	//flags
+		{ {0, 0}, m_swapChain.GetExtent() },												//renderArea
+		1,																					//layerCount
+		0,																					//viewMask
+		1,																					//colorAttachmentCount
+		&colourAttachmentInfo,																//pColorAttachments
+		nullptr,																			//pDepthAttachment
+		nullptr																				//pStencilAttachment
+	);
+
+	commandBuffer.beginRendering(renderingInfo);
+}
+
+void VulkanApplication::EndRendering(vk::CommandBuffer commandBuffer, uint32_t scImageIndex)
+{
+	if (!m_useDynamicRendering)
+	{
+		commandBuffer.endRenderPass();
+		return;
+	}
 
-	m_graphicsCommandPool.GetCommandBuffer(m_renderCommandBufferIndex).bindPipeline(vk::PipelineBindPoint::eGraphics, m_graphicsPipeline.GetPipeline());
+	commandBuffer.endRendering();
+
+	// Presentation is synchronised by the renderFinished semaphore, so nothing after this has to wait on the barrier itself
+	vk::ImageMemoryBarrier2 toPresentBarrier(
+		vk::PipelineStageFlagBits2::eColorAttachmentOutput,	//srcStageMask
+		vk::AccessFlagBits2::eColorAttachmentWrite,			//srcAccessMask
+		vk::PipelineStageFlagBits2::eNone,					//dstStageMask
+		vk::AccessFlagBits2::eNone,							//dstAccessMask
+		vk::ImageLayout::eColorAttachmentOptimal,			//oldLayout
+		vk::ImageLayout::ePresentSrcKHR,					//newLayout
+		vk::QueueFamilyIgnored,								//srcQueueFamilyIndex
+		vk::QueueFamilyIgnored,								//dstQueueFamilyIndex
+		m_swapChain.GetSwapChainImage(scImageIndex),		//image
+		{vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1}		//subresourceRange
+	);
 
-	vk::Buffer vertexBuffers[] = { m_vertexDeviceBuffer.GetBuffer() };
-	vk::DeviceSize offsets[] = { 0 };
-	m_graphicsCommandPool.GetCommandBuffer(m_renderCommandBufferIndex).bindVertexBuffers(0, 1, vertexBuffers, offsets);
-	m_graphicsCommandPool.GetCommandBuffer(m_renderCommandBufferIndex).bindIndexBuffer(m_indexDeviceBuffer.GetBuffer(), 0, vk::IndexType::eUint32);
+	vk::DependencyInfo dependencyInfo(
+		{},					//dependencyFlags
+		0,					//memoryBarrierCount
+		nullptr,			//pMemoryBarriers
+		0,					//bufferMemoryBarrierCount
+		nullptr,			//pBufferMemoryBarriers
+		1,					//imageMemoryBarrierCount
+		&toPresentBarrier	//pImageMemoryBarriers
+	);
+	commandBuffer.pipelineBarrier2(dependencyInfo);
+}
 
+void VulkanApplication::RecordDrawCommands(vk::CommandBuffer commandBuffer, size_t firstGeometry, size_t geometryCount)
+{
+	vk::Extent2D scExtent = m_swapChain.GetExtent();
 
+	// Secondary command buffers don't inherit any state, so every one of them has to bind pipelines and set dynamic state itself
+	// Every pipeline has the same dynamic state, so it survives pipelines being switched
 	vk::Viewport viewport(
 		0,					//x
 		0,					//y
@@ -236,81 +522,1289 @@ void VulkanApplication::RenderFrame(uint32_t sizeOfVertex, std::vector<DataStruc
 		0,					//minDepth
 		1					//maxDepth
 	);
-	m_graphicsCommandPool.GetCommandBuffer(m_renderCommandBufferIndex).setViewport(0, viewport);
+	commandBuffer.setViewport(0, viewport);
 
 	vk::Rect2D scissorRect(
 		{0, 0},		//offset
 		scExtent	//extent
 	);
-	m_graphicsCommandPool.GetCommandBuffer(m_renderCommandBufferIndex).setScissor(0, scissorRect);
-
-	m_graphicsCommandPool.GetCommandBuffer(m_renderCommandBufferIndex).drawIndexed(
-		indices.size(),		//indexCount
-		1,					//instanceCount
-		0,					//firstIndex
-		0,					//vertexOffset
-		0					//firstInstance
-	);
+	commandBuffer.setScissor(0, scissorRect);
+
+	vk::Pipeline boundPipeline = nullptr;
+	std::optional<DynamicRenderState> boundRenderState;
+
+	for (size_t i = firstGeometry; i < firstGeometry + geometryCount; i++)
+	{
+		const GeometryBuffer& geometry = m_geometries[i];
+
+		// Still waiting on its pipeline, with nothing to fall back on, or still being uploaded
+		if (m_geometryPipelines[i] == nullptr || !geometry.IsResident()) { continue; }
+
+		if (m_geometryPipelines[i] != boundPipeline)
+		{
+			boundPipeline = m_geometryPipelines[i];
+			commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, boundPipeline);
+		}
+
+		// Dynamic state survives pipelines being switched, so it's only set when it actually changes
+		if (m_dynamicStateSupport.enabled && boundRenderState != m_geometryRenderStates[i])
+		{
+			boundRenderState = m_geometryRenderStates[i];
+			m_graphicsPipeline.RecordDynamicState(commandBuffer, boundRenderState.value());
+		}
+
+		const InstanceBuffer& instanceBuffer = m_instanceBuffers[i];
+
+		// Instanced geometry reads its instances from binding 1
+		vk::Buffer vertexBuffers[] = { geometry.GetVertexBuffer(), instanceBuffer.GetBuffer() };
+		vk::DeviceSize offsets[] = { 0, 0 };
+		commandBuffer.bindVertexBuffers(0, instanceBuffer.IsCreated() ? 2 : 1, vertexBuffers, offsets);
+		commandBuffer.bindIndexBuffer(geometry.GetIndexBuffer(), 0, geometry.GetIndexType());
+
+		commandBuffer.drawIndexed(
+			geometry.GetIndexCount(),													//indexCount
+			instanceBuffer.IsCreated() ? instanceBuffer.GetInstanceCount() : 1,		//instanceCount
+			0,																			//firstIndex
+			0,																			//vertexOffset
+			0																			//firstInstance
+		);
+	}
+}
+
+void VulkanApplication::RecordIndirectDrawCommands(vk::CommandBuffer commandBuffer, uint32_t firstDraw, uint32_t drawCount)
+{
+	if (m_indirectBatches.empty() || drawCount == 0) { return; }
+
+	uint32_t endDraw = firstDraw + drawCount;
+
+	// Every mesh lives in the same two buffers, so they're bound once no matter how many batches there are
+	// The index buffer is only bound again to switch between 16 and 32-bit indices
+	m_meshRegistry.RecordBindVertexBuffer(commandBuffer);
+
+	// Each draw's firstInstance picks out its object's slot, so every object's data is in one buffer that's bound once too
+	if (m_objectInstances.IsCreated())
+	{
+		vk::Buffer instanceBuffer = m_objectInstances.GetBuffer();
+		vk::DeviceSize offset = 0;
+		commandBuffer.bindVertexBuffers(1, 1, &instanceBuffer, &offset);
+	}
+
+	vk::Pipeline boundPipeline = nullptr;
+	std::optional<DynamicRenderState> boundRenderState;
+	std::optional<vk::IndexType> boundIndexType;
+
+	for (uint32_t i = 0; i < m_indirectBatches.size(); i++)
+	{
+		const IndirectBatch& batch = m_indirectBatches[i];
+
+		// The part of this batch that falls in our range
+		uint32_t batchStart = std::max(batch.firstDraw, firstDraw);
+		uint32_t batchEnd = std::min(batch.firstDraw + batch.drawCount, endDraw);
+
+		// A batch whose count is written on the GPU can't be split, so it's recorded whole by whoever gets its first draw
+		if (m_drawIndirectCount)
+		{
+			if (batch.firstDraw < firstDraw || batch.firstDraw >= endDraw) { continue; }
+
+			batchStart = batch.firstDraw;
+			batchEnd = batch.firstDraw + batch.drawCount;
+		}
+
+		if (batchStart >= batchEnd) { continue; }
+
+		if (batch.pipeline != boundPipeline)
+		{
+			boundPipeline = batch.pipeline;
+			commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, boundPipeline);
+		}
+
+		if (m_dynamicStateSupport.enabled && boundRenderState != batch.renderState)
+		{
+			boundRenderState = batch.renderState;
+			m_graphicsPipeline.RecordDynamicState(commandBuffer, boundRenderState.value());
+		}
+
+		if (boundIndexType != batch.indexType)
+		{
+			boundIndexType = batch.indexType;
+			m_meshRegistry.RecordBindIndexBuffer(commandBuffer, boundIndexType.value());
+		}
+
+		if (m_drawIndirectCount)
+		{
+			// The count is read on the GPU, so it can change without the command buffer being re-recorded
+			commandBuffer.drawIndexedIndirectCount(
+				m_indirectDraws.GetBuffer(),						//buffer
+				m_indirectDraws.GetCommandOffset(batch.firstDraw),	//offset
+				m_indirectDraws.GetBuffer(),						//countBuffer
+				m_indirectDraws.GetDrawCountOffset(i),				//countBufferOffset
+				batch.drawCount,									//maxDrawCount
+				sizeof(vk::DrawIndexedIndirectCommand)				//stride
+			);
+		}
+		else if (m_multiDrawIndirect)
+		{
+			commandBuffer.drawIndexedIndirect(m_indirectDraws.GetBuffer(), m_indirectDraws.GetCommandOffset(batchStart), batchEnd - batchStart,
+											  sizeof(vk::DrawIndexedIndirectCommand));
+		}
+		else
+		{
+			for (uint32_t draw = batchStart; draw < batchEnd; draw++)
+			{
+				commandBuffer.drawIndexedIndirect(m_indirectDraws.GetBuffer(), m_indirectDraws.GetCommandOffset(draw), 1,
+												  sizeof(vk::DrawIndexedIndirectCommand));
+			}
+		}
+	}
+}
+
+void VulkanApplication::RecordCullingCommands(vk::CommandBuffer commandBuffer)
+{
+	if (!m_frustumCuller.IsCreated()) { return; }
+
+	m_frustumCuller.RecordCulling(commandBuffer, m_indirectDraws, m_indirectBatches.size());
+}
+
+uint32_t VulkanApplication::RecordRenderCommands(vk::CommandBuffer commandBuffer, uint32_t scImageIndex)
+{
+	// Dispatches aren't allowed inside a render pass
+	RecordCullingCommands(commandBuffer);
+
+	// Render pass start
+	BeginRendering(commandBuffer, scImageIndex, vk::SubpassContents::eInline);
 
-	/*m_graphicsCommandPool.GetCommandBuffer(m_renderCommandBufferIndex).draw(
-		verts.size(),	//vertexCount
-		1,				//instanceCount
-		0,				//firstVertex
-		0				//firstInstance
-	);*/
+	RecordDrawCommands(commandBuffer, 0, m_geometries.size());
+	RecordIndirectDrawCommands(commandBuffer, 0, m_indirectDrawOrder.size());
 
 	// Render pass finish
-	m_graphicsCommandPool.GetCommandBuffer(m_renderCommandBufferIndex).endRenderPass();
+	EndRendering(commandBuffer, scImageIndex);
 
-	// Graphics buffer recording finish
-	m_graphicsCommandPool.EndRecordingToBuffer(m_renderCommandBufferIndex);
-	
-	vk::PipelineStageFlags pipelineStage = vk::PipelineStageFlagBits::eColorAttachmentOutput;
-	std::vector<vk::CommandBuffer> graphicsCommandBuffers = m_graphicsCommandPool.GetCommandBuffers();
-	vk::SubmitInfo submitInfo(
-		1,									//waitSemaphoreCount
-		&m_imageAvailable,					//pWaitSemaphores
-		&pipelineStage,						//pWaitDstStageMask
-		graphicsCommandBuffers.size(),		//commandBufferCount
-		graphicsCommandBuffers.data(),		//pCommandBuffers
-		1,									//signalSemaphoreCount
-		&m_renderFinished					//pSignalSemaphores
-	);
+	return 1;
+}
 
-	m_logicalDevice.GetQueue("graphicsQueue").submit(submitInfo, m_startRender);
+uint32_t VulkanApplication::RecordRenderCommandsParallel(FrameResources& frame, vk::CommandBuffer primaryBuffer, uint32_t scImageIndex)
+{
+	// Direct and indirect draws are split as one list, geometry first and then indirect draws in the order they were written
+	size_t geometryCount = m_geometries.size();
+	size_t drawCount = geometryCount + m_indirectDrawOrder.size();
 
-	vk::SwapchainKHR swapchain = m_swapChain.GetSwapchain();
-	vk::PresentInfoKHR presentInfo(
-		1,						//waitSemaphoreCount
-		&m_renderFinished,		//pWaitSemaphores
-		1,						//swapchainCount
-		&swapchain,				//pSwapchains
-		&scImageIndex,			//pImageIndices
-		nullptr					//pResults
+	// With only a handful of draws, handing out jobs costs more than recording does
+	size_t workerCount = std::min<size_t>(frame.workerPools.size(), drawCount / std::max(m_minDrawsPerWorker, 1u));
+	if (workerCount < 2)
+	{
+		return RecordRenderCommands(primaryBuffer, scImageIndex);
+	}
+
+	// Rounding up can leave the last worker with nothing to do, so recount afterwards
+	size_t drawsPerWorker = (drawCount + workerCount - 1) / workerCount;
+	workerCount = (drawCount + drawsPerWorker - 1) / drawsPerWorker;
+
+	vk::CommandBufferInheritanceInfo inheritanceInfo;
+
+	// Only read while the jobs below are running, which is before this function returns
+	vk::Format colourFormat = m_swapChain.GetFormat();
+	vk::CommandBufferInheritanceRenderingInfo renderingInheritanceInfo(
+		{},								//flags
+		0,								//viewMask
+		1,								//colorAttachmentCount
+		&colourFormat,					//pColorAttachmentFormats
+		vk::Format::eUndefined,			//depthAttachmentFormat
+		vk::Format::eUndefined,			//stencilAttachmentFormat
+		vk::SampleCountFlagBits::e1		//rasterizationSamples
 	);
 
-	(void) m_logicalDevice.GetQueue("surfaceQueue").presentKHR(presentInfo);
+	if (m_useDynamicRendering)
+	{
+		inheritanceInfo.pNext = &renderingInheritanceInfo;
+	}
+	else
+	{
+		inheritanceInfo.renderPass = m_graphicsPipeline.GetRenderPass();
+		inheritanceInfo.subpass = 0;
+		inheritanceInfo.framebuffer = m_swapChain.GetFramebuffer(scImageIndex);
+	}
+
+	Threading::JobCounter recordingCounter;
+
+	for (size_t i = 0; i < workerCount; i++)
+	{
+		size_t firstDraw = i * drawsPerWorker;
+		size_t endDraw = std::min(firstDraw + drawsPerWorker, drawCount);
+
+		size_t firstGeometry = std::min(firstDraw, geometryCount);
+		size_t workerGeometryCount = std::min(endDraw, geometryCount) - firstGeometry;
+		uint32_t firstIndirectDraw = std::max(firstDraw, geometryCount) - geometryCount;
+		uint32_t workerIndirectDrawCount = std::max(endDraw, geometryCount) - geometryCount - firstIndirectDraw;
+
+		m_jobSystem.Run([this, &frame, inheritanceInfo, i, firstGeometry, workerGeometryCount, firstIndirectDraw, workerIndirectDrawCount]()
+		{
+			CommandPoolWrapper& workerPool = frame.workerPools[i];
+			uint32_t bufferIndex = frame.workerBufferIndices[i];
+
+			workerPool.BeginRecordingToBuffer(bufferIndex, vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue,
+											  inheritanceInfo);
+			// Always called, since it also sets the viewport and scissor that the indirect draws need
+			RecordDrawCommands(workerPool.GetCommandBuffer(bufferIndex), firstGeometry, workerGeometryCount);
+			RecordIndirectDrawCommands(workerPool.GetCommandBuffer(bufferIndex), firstIndirectDraw, workerIndirectDrawCount);
+			workerPool.EndRecordingToBuffer(bufferIndex);
+		}, &recordingCounter);
+	}
+
+	// The primary buffer only starts the render pass and runs the secondaries, so it can be recorded while the workers are busy
+	RecordCullingCommands(primaryBuffer);
+	BeginRendering(primaryBuffer, scImageIndex, vk::SubpassContents::eSecondaryCommandBuffers);
+
+	// Helps record whatever slices haven't been picked up yet, and rethrows anything thrown by a slice
+	m_jobSystem.Wait(&recordingCounter);
+
+	std::vector<vk::CommandBuffer> secondaryBuffers;
+	for (size_t i = 0; i < workerCount; i++)
+	{
+		secondaryBuffers.push_back(frame.workerPools[i].GetCommandBuffer(frame.workerBufferIndices[i]));
+	}
+
+	primaryBuffer.executeCommands(secondaryBuffers);
+
+	EndRendering(primaryBuffer, scImageIndex);
+
+	return workerCount + 1;
 }
 
-VulkanApplication::~VulkanApplication()
+// Public Methods
+void VulkanApplication::Init(WindowInfo winInfo, vk::ApplicationInfo appInfo, std::vector<const char*> vkExtensions,
+							 vk::InstanceCreateFlags vkFlags)
 {
-	vk::Device logicalDevice = m_logicalDevice.GetLogicalDevice();
+	VULKAN_HPP_DEFAULT_DISPATCHER.init();
+
+	// Start our worker threads, which anything that can be split up (e.g. command recording) fans out onto
+	m_jobSystem.CreateJobSystem(m_jobWorkerCount);
+
+    // Create window
+    m_window.CreateWindow(winInfo);
+
+    // --Init Vulkan--
+	// Set up our debug messenger. We need to initialise Vulkan before we create the messenger,
+	// but we need info from here to initialise Vulkan in debug mode
+	#ifdef _DEBUG
+		m_debugMessenger.SetUpDebugCallback();
+	#endif
 
-	// TODO: Find somewhere better to destroy these
-	if (m_imageAvailable != nullptr) { logicalDevice.destroySemaphore(m_imageAvailable); }
-	if (m_renderFinished != nullptr) { logicalDevice.destroySemaphore(m_renderFinished); }
-	if (m_startRender != nullptr) { logicalDevice.destroyFence(m_startRender); }
+	// Initialise vulkan
+	CreateVulkanInstance(appInfo, vkExtensions, vkFlags);
+	VULKAN_HPP_DEFAULT_DISPATCHER.init(m_vulkanInstance);
 
-	m_transientTransferCommandPool.DestroyCommandPool(logicalDevice);
-	m_graphicsCommandPool.DestroyCommandPool(logicalDevice);
+	// Initialise debug messenger
+	#ifdef _DEBUG
+		m_debugMessenger.LinkDebugCallback(m_vulkanInstance);
+	#endif
 
-	m_indexDeviceBuffer.DestroyBuffer(logicalDevice);
-	m_indexStagingBuffer.DestroyBuffer(logicalDevice);
+	// Create the GLFW surface we'll be using in our swapchain
+	m_displaySurface.CreateDisplaySurface(m_vulkanInstance, m_window.GetWindow());
 
-	m_vertexDeviceBuffer.DestroyBuffer(logicalDevice);
-	m_vertexStagingBuffer.DestroyBuffer(logicalDevice);
+	// Find and select a GPU to render with
+	m_physicalDevice.SelectDevice(m_vulkanInstance, m_displaySurface.GetSurface());
 
-	m_graphicsPipeline.DestroyPipeline(logicalDevice);
+	// Has to know which GPU we're using, but the logical device needs to know the outcome
+	ConfigureDynamicStateSupport();
+	ConfigureIndirectDrawSupport();
+
+	// Create a logical device to interface with our physical device
+	#ifdef _DEBUG
+	m_logicalDevice.CreateLogicalDevice(m_physicalDevice.GetPhysicalDevice(), m_displaySurface.GetSurface(), m_physicalDevice.GetDeviceExtensions(),
+										m_debugMessenger.GetValidationLayers());
+	#else
+	m_logicalDevice.CreateLogicalDevice(m_physicalDevice.GetPhysicalDevice(), m_displaySurface.GetSurface(), m_physicalDevice.GetDeviceExtensions());
+	#endif
+
+	VULKAN_HPP_DEFAULT_DISPATCHER.init(m_logicalDevice.GetLogicalDevice());
+
+	// Pipelines built on previous runs can be pulled straight out of here instead of being compiled again
+	m_pipelineCache.CreatePipelineCache(m_logicalDevice.GetLogicalDevice(), m_physicalDevice.GetPhysicalDevice(), m_pipelineCachePath);
+
+	// Set up our allocator, so that buffers can share large blocks of device memory instead of each allocating their own
+	m_memoryAllocator.CreateAllocator(m_physicalDevice.GetPhysicalDevice());
+
+	// Uploads go through the dedicated transfer queue if there is one, and never block the CPU
+	m_transferQueue.CreateTransferQueue(m_logicalDevice.GetLogicalDevice(), m_logicalDevice.GetQueue("transferQueue"),
+										m_logicalDevice.GetQueueFamilyIndices().queueFamilies.at("transferQueueFamily"));
+
+	// Create a staging ring, which every upload writes into before being copied to device memory
+	// It's persistently mapped, so we never have to map or unmap memory while rendering
+	m_stagingRing.CreateStagingRing(m_logicalDevice.GetLogicalDevice(), &m_memoryAllocator, m_stagingRegionSize, m_framesInFlight,
+									{ m_logicalDevice.GetQueueFamilyIndices().queueFamilies.at("graphicsQueueFamily"),
+									  m_logicalDevice.GetQueueFamilyIndices().queueFamilies.at("transferQueueFamily") });
+
+	// Create a swapchain to present images to the screen with
+	m_swapChain.CreateSwapChain(m_logicalDevice.GetLogicalDevice(), m_displaySurface.GetSurface(), m_window.GetWindow(),
+								m_physicalDevice.GetSwapChainSupportInfo(), m_logicalDevice.GetQueueFamilyIndices());
+}
+
+void VulkanApplication::GraphicsPipelineSetup(ShaderInfo shaderInfo, uint32_t sizeOfVertex, std::pair<vk::Format, uint32_t>* vertexVarsInfo,
+											  size_t vertexVarsInfoCount)
+{
+	// Create a graphics pipeline to run shaders and draw our image
+	// Later permutations are compiled on the job system, but the default pipeline is needed straight away
+	m_graphicsPipeline.ConfigureDynamicRendering(m_useDynamicRendering);
+	m_graphicsPipeline.ConfigureExtendedDynamicState(m_dynamicStateSupport);
+	m_graphicsPipeline.CreateGraphicsPipeline(m_logicalDevice.GetLogicalDevice(), m_pipelineCache.GetPipelineCache(), &m_jobSystem, shaderInfo,
+											  m_swapChain.GetFormat(), sizeOfVertex, vertexVarsInfo, vertexVarsInfoCount);
+
+	std::string creationMessage = "Graphics pipeline created in " + std::to_string(m_graphicsPipeline.GetCreationTimeMs()) + "ms (" +
+								  (m_pipelineCache.WasLoadedFromDisk() ? "warm start, cache loaded from disk)" : "cold start, no usable cache on disk)");
+	Logger::Log({ creationMessage.c_str() }, LogType::Info);
+
+	// Create framebuffers to display our image. Dynamic rendering draws straight into the image views instead
+	if (!m_useDynamicRendering)
+	{
+		m_swapChain.CreateFramebuffers(m_logicalDevice.GetLogicalDevice(), m_graphicsPipeline.GetRenderPass());
+	}
+
+	// Sync objects, command buffers and the like, one set for each frame in flight
+	CreateFrameResources();
+
+	InvalidateCommandBuffers();
+}
+
+void VulkanApplication::ConfigureCommandBufferCaching(bool cacheCommandBuffers)
+{
+	m_cacheCommandBuffers = cacheCommandBuffers;
+
+	InvalidateCommandBuffers();
+}
+
+void VulkanApplication::InvalidateCommandBuffers()
+{
+	m_cachedCommandBuffersValid.assign(m_cachedCommandBuffersValid.size(), false);
+}
+
+void VulkanApplication::ConfigureParallelRecording(uint32_t workerCount, uint32_t minDrawsPerWorker)
+{
+	m_recordingWorkerCount = workerCount;
+	m_minDrawsPerWorker = minDrawsPerWorker;
+
+	// Before GraphicsPipelineSetup, the pools are created along with everything else
+	if (m_frames.empty()) { return; }
+
+	// Otherwise frames in flight might still be using the old pools
+	m_logicalDevice.GetLogicalDevice().waitIdle();
+	CreateWorkerCommandPools();
+}
+
+GeometryHandle VulkanApplication::CreateGeometry(const void* vertexData, uint32_t sizeOfVertex, uint32_t vertexCount, std::vector<uint32_t> indices)
+{
+	GeometryBuffer geometry;
+	geometry.CreateGeometryBuffer(m_logicalDevice.GetLogicalDevice(), &m_memoryAllocator,
+								  { m_logicalDevice.GetQueueFamilyIndices().queueFamilies.at("graphicsQueueFamily"),
+									m_logicalDevice.GetQueueFamilyIndices().queueFamilies.at("transferQueueFamily") },
+								  vertexData, sizeOfVertex, vertexCount, indices);
+
+	m_geometries.push_back(geometry);
+	m_geometryPipelines.push_back(m_graphicsPipeline.GetPipeline());
+	m_geometryRenderStates.push_back(m_graphicsPipeline.GetDefaultState().GetDynamicRenderState());
+	m_instanceBuffers.push_back({});
+
+	// New geometry means new draws
+	InvalidateCommandBuffers();
+
+	return m_geometries.size() - 1;
+}
+
+void VulkanApplication::CreateMeshRegistryIfNeeded(uint32_t sizeOfVertex)
+{
+	if (!m_meshRegistry.IsCreated())
+	{
+		m_meshRegistry.CreateMeshRegistry(m_logicalDevice.GetLogicalDevice(), &m_memoryAllocator,
+										  { m_logicalDevice.GetQueueFamilyIndices().queueFamilies.at("graphicsQueueFamily"),
+											m_logicalDevice.GetQueueFamilyIndices().queueFamilies.at("transferQueueFamily") },
+										  sizeOfVertex, m_meshVertexCapacity, m_meshIndexCapacity);
+	}
+	else if (m_meshRegistry.GetSizeOfVertex() != sizeOfVertex)
+	{
+		throw std::runtime_error("Mesh vertex size " + std::to_string(sizeOfVertex) + " does not match the mesh registry's vertex size " +
+								 std::to_string(m_meshRegistry.GetSizeOfVertex()));
+	}
+}
+
+MeshHandle VulkanApplication::CreateMesh(const void* vertexData, uint32_t sizeOfVertex, uint32_t vertexCount, std::vector<uint32_t> indices)
+{
+	CreateMeshRegistryIfNeeded(sizeOfVertex);
+
+	std::optional<std::pair<vk::Format, uint32_t>> position = GetPositionAttribute(sizeOfVertex);
+	bool generateLods = m_maxLodCount > 1 && position.has_value();
+
+	if (!m_optimiseMeshes && !generateLods)
+	{
+		return m_meshRegistry.AddMesh(m_logicalDevice.GetLogicalDevice(), &m_memoryAllocator, &m_stagingRing, vertexData, vertexCount, indices);
+	}
+
+	std::vector<char> meshVertexData((const char*)vertexData, (const char*)vertexData + (size_t)sizeOfVertex * vertexCount);
+	if (m_optimiseMeshes)
+	{
+		OptimiseMeshData(meshVertexData, sizeOfVertex, indices);
+		vertexCount = meshVertexData.size() / sizeOfVertex;
+	}
+
+	if (!generateLods)
+	{
+		return m_meshRegistry.AddMesh(m_logicalDevice.GetLogicalDevice(), &m_memoryAllocator, &m_stagingRing, meshVertexData.data(), vertexCount, indices);
+	}
+
+	// LODs are made from the optimised vertices, so they get the same fetch order for free
+	uint32_t positionComponents = position.value().first == (vk::Format)VulkanFormat::eVec3 ? 3 : 2;
+	std::vector<MeshProcessing::LodLevel> lods = MeshProcessing::GenerateLodChain(indices, meshVertexData.data() + position.value().second, sizeOfVertex,
+																				  positionComponents, vertexCount, m_maxLodCount, m_lodReduction);
+
+	std::string lodMessage = "Mesh LODs:";
+	for (uint32_t i = 0; i < lods.size(); i++)
+	{
+		// Simplifying leaves triangles in whatever order the collapses did, so they're put back into cache order
+		if (m_optimiseMeshes && i > 0) { MeshProcessing::OptimiseVertexCache(lods[i].indices, vertexCount); }
+
+		lodMessage += " " + std::to_string(lods[i].indices.size() / 3) + " (" + std::to_string(lods[i].error) + ")";
+	}
+	Logger::Log({ lodMessage.c_str() }, LogType::Info);
+
+	return m_meshRegistry.AddMesh(m_logicalDevice.GetLogicalDevice(), &m_memoryAllocator, &m_stagingRing, meshVertexData.data(), vertexCount, lods);
+}
+
+MeshHandle VulkanApplication::LoadMesh(const std::string& path)
+{
+	MeshFileUpload upload;
+	upload.file.OpenMeshFile(path);
+
+	// Points into the mapping, which doesn't move when the upload does
+	const Assets::MeshFileHeader& header = upload.file.GetHeader();
+	CreateMeshRegistryIfNeeded(header.sizeOfVertex);
+
+	// Objects can be drawn with any pipeline state, so a different layout isn't necessarily wrong
+	PipelineStateDescription defaultState = m_graphicsPipeline.GetDefaultState();
+	bool layoutMatches = defaultState.sizeOfVertex == header.sizeOfVertex && defaultState.vertexVarsInfo.size() == header.attributeCount;
+	for (uint32_t i = 0; layoutMatches && i < header.attributeCount; i++)
+	{
+		layoutMatches = (uint32_t)defaultState.vertexVarsInfo[i].first == header.attributes[i].format &&
+						defaultState.vertexVarsInfo[i].second == header.attributes[i].offset;
+	}
+
+	if (!layoutMatches)
+	{
+		Logger::Log({ path.c_str(), "'s vertex layout doesn't match the default pipeline state's" }, LogType::Warning);
+	}
+
+	if (header.lodCount > c_maxMeshLods)
+	{
+		throw std::runtime_error(path + " has " + std::to_string(header.lodCount) + " LODs, but meshes can only have " + std::to_string(c_maxMeshLods));
+	}
+
+	// MeshFileLod has the same fields as MeshLod, in the same units, so they're copied across on the stack
+	std::array<MeshLod, c_maxMeshLods> lods;
+	for (uint32_t i = 0; i < header.lodCount; i++)
+	{
+		lods[i].firstIndex = header.lods[i].firstIndex;
+		lods[i].indexCount = header.lods[i].indexCount;
+		lods[i].error = header.lods[i].error;
+	}
+
+	MeshHandle mesh = m_meshRegistry.ReserveMesh(header.vertexCount, upload.file.GetIndexType(), std::span<const MeshLod>(lods.data(), header.lodCount));
+
+	// Nothing is copied yet. The mapped bytes go straight into staging memory once the upload comes around
+	upload.mesh = mesh;
+	upload.vertexRanges.MarkDirty(0, upload.file.GetVertexDataSize());
+	upload.indexRanges.MarkDirty(0, upload.file.GetIndexDataSize());
+	m_meshFileUploads.push_back(std::move(upload));
+
+	return mesh;
+}
+
+std::optional<std::pair<vk::Format, uint32_t>> VulkanApplication::GetPositionAttribute(uint32_t sizeOfVertex) const
+{
+	// Only trust the default vertex layout if it's describing vertices of this size
+	PipelineStateDescription defaultState = m_graphicsPipeline.GetDefaultState();
+	if (defaultState.sizeOfVertex != sizeOfVertex || defaultState.vertexVarsInfo.empty()) { return std::nullopt; }
+
+	vk::Format positionFormat = defaultState.vertexVarsInfo[0].first;
+	if (positionFormat != (vk::Format)VulkanFormat::eVec2 && positionFormat != (vk::Format)VulkanFormat::eVec3) { return std::nullopt; }
+
+	return defaultState.vertexVarsInfo[0];
+}
+
+void VulkanApplication::OptimiseMeshData(std::vector<char>& vertexData, uint32_t sizeOfVertex, std::vector<uint32_t>& indices)
+{
+	std::optional<std::pair<vk::Format, uint32_t>> position = GetPositionAttribute(sizeOfVertex);
+
+	MeshProcessing::MeshOptimisationStats stats = MeshProcessing::OptimiseMesh(vertexData, sizeOfVertex, indices, position);
+
+	std::string statsMessage = "Mesh optimised: " + std::to_string(stats.vertexCountBefore) + " -> " + std::to_string(stats.vertexCountAfter) +
+							   " vertices, ACMR " + std::to_string(stats.before.acmr) + " -> " + std::to_string(stats.after.acmr) + ", ATVR " +
+							   std::to_string(stats.before.atvr) + " -> " + std::to_string(stats.after.atvr) +
+							   (position.has_value() ? "" : ", overdraw not optimised since there's no float position to sort by");
+	Logger::Log({ statsMessage.c_str() }, LogType::Info);
+}
+
+void VulkanApplication::DestroyMesh(MeshHandle mesh)
+{
+	for (ObjectHandle object = 0; object < m_indirectObjects.size(); object++)
+	{
+		if (m_indirectObjects[object].isAlive && m_indirectObjects[object].mesh == mesh)
+		{
+			throw std::runtime_error("Cannot destroy mesh " + std::to_string(mesh) + " while object " + std::to_string(object) + " is still using it");
+		}
+	}
+
+	// A file that's still uploading stops being staged, but stays mapped until whatever was already submitted has finished
+	for (MeshFileUpload& upload : m_meshFileUploads)
+	{
+		if (upload.mesh == mesh && !upload.ticket.has_value()) { upload.ticket = m_transferQueue.GetLastSubmittedTicket(); }
+	}
+
+	m_meshRegistry.RemoveMesh(mesh);
+}
+
+ObjectHandle VulkanApplication::CreateObject(MeshHandle mesh, std::optional<PipelineStateDescription> pipelineState)
+{
+	if (!m_meshRegistry.MeshExists(mesh))
+	{
+		throw std::runtime_error("Mesh handle " + std::to_string(mesh) + " does not exist");
+	}
+
+	if (m_indirectObjects.size() - m_freeObjectHandles.size() >= m_maxIndirectObjects)
+	{
+		throw std::runtime_error("Cannot create more than " + std::to_string(m_maxIndirectObjects) + " objects");
+	}
+
+	if (!m_indirectDraws.IsCreated())
+	{
+		m_indirectDraws.CreateIndirectDrawBuffer(m_logicalDevice.GetLogicalDevice(), &m_memoryAllocator,
+												 { m_logicalDevice.GetQueueFamilyIndices().queueFamilies.at("graphicsQueueFamily"),
+												   m_logicalDevice.GetQueueFamilyIndices().queueFamilies.at("transferQueueFamily") },
+												 m_maxIndirectObjects);
+	}
+
+	if (m_useGpuCulling && !m_frustumCuller.IsCreated())
+	{
+		// Culling runs on the graphics queue, right before the draws that read its results
+		m_frustumCuller.CreateFrustumCuller(m_logicalDevice.GetLogicalDevice(), &m_memoryAllocator,
+											{ m_logicalDevice.GetQueueFamilyIndices().queueFamilies.at("graphicsQueueFamily"),
+											  m_logicalDevice.GetQueueFamilyIndices().queueFamilies.at("transferQueueFamily") },
+											m_pipelineCache.GetPipelineCache(), m_cullShaderInfo, m_maxIndirectObjects, m_drawIndirectCount, m_indirectDraws);
+		m_frustumCuller.SetFrustum(m_cullingViewProjection);
+	}
+
+	IndirectObject object;
+	object.mesh = mesh;
+
+	if (pipelineState.has_value())
+	{
+		object.pipeline = m_graphicsPipeline.GetOrCreatePipeline(m_logicalDevice.GetLogicalDevice(), pipelineState.value());
+		object.renderState = pipelineState.value().GetDynamicRenderState();
+	}
+	else
+	{
+		object.pipeline = m_graphicsPipeline.GetPipeline();
+		object.renderState = m_graphicsPipeline.GetDefaultState().GetDynamicRenderState();
+	}
+
+	m_indirectBatchesDirty = true;
+
+	if (!m_freeObjectHandles.empty())
+	{
+		ObjectHandle handle = m_freeObjectHandles.back();
+		m_freeObjectHandles.pop_back();
+
+		m_indirectObjects[handle] = object;
+		return handle;
+	}
+
+	m_indirectObjects.push_back(object);
+	return m_indirectObjects.size() - 1;
+}
+
+void VulkanApplication::DestroyObject(ObjectHandle object)
+{
+	if (object >= m_indirectObjects.size() || !m_indirectObjects[object].isAlive)
+	{
+		throw std::runtime_error("Object handle " + std::to_string(object) + " does not exist");
+	}
+
+	m_indirectObjects[object].isAlive = false;
+	m_freeObjectHandles.push_back(object);
+
+	m_indirectBatchesDirty = true;
+}
+
+void VulkanApplication::RebuildIndirectBatches()
+{
+	if (!m_indirectBatchesDirty) { return; }
+
+	// Objects are grouped by everything that has to be bound between draw calls, keeping them in creation order within a group
+	std::vector<uint32_t>& drawOrder = m_indirectDrawOrder;
+	drawOrder.clear();
+	for (uint32_t i = 0; i < m_indirectObjects.size(); i++)
+	{
+		if (m_indirectObjects[i].isAlive && IsMeshResident(m_indirectObjects[i].mesh)) { drawOrder.push_back(i); }
+	}
+
+	std::vector<vk::Pipeline> batchPipelines;
+	std::vector<DynamicRenderState> batchRenderStates;
+	std::vector<vk::IndexType> batchIndexTypes;
+	std::vector<uint32_t> objectBatches(m_indirectObjects.size());
+
+	for (uint32_t i : drawOrder)
+	{
+		const IndirectObject& object = m_indirectObjects[i];
+		vk::IndexType indexType = m_meshRegistry.GetMesh(object.mesh).indexType;
+
+		uint32_t batch = 0;
+		while (batch < batchPipelines.size() && (batchPipelines[batch] != object.pipeline || batchRenderStates[batch] != object.renderState ||
+												 batchIndexTypes[batch] != indexType)) { batch++; }
+
+		if (batch == batchPipelines.size())
+		{
+			batchPipelines.push_back(object.pipeline);
+			batchRenderStates.push_back(object.renderState);
+			batchIndexTypes.push_back(indexType);
+		}
+
+		objectBatches[i] = batch;
+	}
+
+	std::stable_sort(drawOrder.begin(), drawOrder.end(), [&](uint32_t a, uint32_t b) { return objectBatches[a] < objectBatches[b]; });
+
+	m_indirectBatches.clear();
+	for (uint32_t draw = 0; draw < drawOrder.size(); draw++)
+	{
+		const IndirectObject& object = m_indirectObjects[drawOrder[draw]];
+		vk::IndexType indexType = m_meshRegistry.GetMesh(object.mesh).indexType;
+
+		if (m_indirectBatches.empty() || m_indirectBatches.back().pipeline != object.pipeline || m_indirectBatches.back().renderState != object.renderState ||
+			m_indirectBatches.back().indexType != indexType)
+		{
+			IndirectBatch batch;
+			batch.pipeline = object.pipeline;
+			batch.renderState = object.renderState;
+			batch.indexType = indexType;
+			batch.firstDraw = draw;
+
+			m_indirectBatches.push_back(batch);
+		}
+
+		m_indirectBatches.back().drawCount++;
+	}
+
+	m_indirectBatchesDirty = false;
+	m_indirectDrawsDirty = true;
+
+	// Batches are baked into cached command buffers
+	InvalidateCommandBuffers();
+}
+
+void VulkanApplication::WriteIndirectDraws()
+{
+	std::vector<vk::DrawIndexedIndirectCommand> commands;
+	std::vector<uint32_t> drawCounts;
+	commands.reserve(m_indirectDrawOrder.size());
+	m_indirectTriangleCount = 0;
+
+	for (const IndirectBatch& batch : m_indirectBatches)
+	{
+		for (uint32_t draw = batch.firstDraw; draw < batch.firstDraw + batch.drawCount; draw++)
+		{
+			ObjectHandle objectHandle = m_indirectDrawOrder[draw];
+			const IndirectObject& object = m_indirectObjects[objectHandle];
+			const MeshRange& mesh = m_meshRegistry.GetMesh(object.mesh);
+			const MeshLod& lod = mesh.lods[object.lod];
+
+			// A non-zero firstInstance needs drawIndirectFirstInstance, and without it objects can't have instance data anyway
+			commands.push_back(vk::DrawIndexedIndirectCommand(
+				lod.indexCount,										//indexCount
+				1,													//instanceCount
+				lod.firstIndex,										//firstIndex
+				mesh.vertexOffset,									//vertexOffset
+				m_drawIndirectFirstInstance ? objectHandle : 0		//firstInstance
+			));
+
+			m_indirectTriangleCount += lod.indexCount / 3;
+		}
+
+		drawCounts.push_back(batch.drawCount);
+	}
+
+	// With GPU culling, the culling shader writes the draws from the cull objects instead
+	if (m_frustumCuller.IsCreated())
+	{
+		m_cullObjectsDirty = true;
+	}
+	else
+	{
+		// Only the commands that actually changed are uploaded, so an object switching LOD costs one command's worth
+		m_indirectDraws.SetDraws(commands, drawCounts);
+	}
+
+	// The batches are the same, so cached command buffers are still drawing the right thing
+	m_indirectDrawsDirty = false;
+}
+
+void VulkanApplication::SetLodSelection(Vec3 cameraPosition, float projectionScale, float maxScreenError)
+{
+	m_lodCameraPosition = cameraPosition;
+	m_lodProjectionScale = projectionScale;
+	m_maxLodScreenError = maxScreenError;
+
+	m_lodSelectionDirty = true;
+}
+
+void VulkanApplication::SelectLods()
+{
+	if (!m_lodSelectionDirty || m_lodProjectionScale <= 0) { return; }
+
+	for (IndirectObject& object : m_indirectObjects)
+	{
+		if (!object.isAlive) { continue; }
+
+		const MeshRange& mesh = m_meshRegistry.GetMesh(object.mesh);
+		uint32_t lod = 0;
+
+		if (object.boundingSphere.w >= 0)
+		{
+			// Measured to the nearest point of the bounds, so nothing's ever coarser than it should be. Inside them, it's LOD 0
+			float distance = glm::length(Vec3(object.boundingSphere) - m_lodCameraPosition) - object.boundingSphere.w;
+			float maxError = distance > 0 ? m_maxLodScreenError * distance / m_lodProjectionScale : 0;
+
+			// Errors only grow with each LOD, so the first one that's too big ends the search
+			while (lod + 1 < mesh.lodCount && mesh.lods[lod + 1].error <= maxError) { lod++; }
+		}
+
+		if (lod != object.lod)
+		{
+			object.lod = lod;
+			m_indirectDrawsDirty = true;
+		}
+	}
+
+	m_lodSelectionDirty = false;
+}
+
+void VulkanApplication::WriteCullObjects()
+{
+	std::vector<CullObject> cullObjects;
+	cullObjects.reserve(m_indirectDrawOrder.size());
+
+	for (uint32_t batchIndex = 0; batchIndex < m_indirectBatches.size(); batchIndex++)
+	{
+		const IndirectBatch& batch = m_indirectBatches[batchIndex];
+
+		for (uint32_t draw = batch.firstDraw; draw < batch.firstDraw + batch.drawCount; draw++)
+		{
+			ObjectHandle objectHandle = m_indirectDrawOrder[draw];
+			const IndirectObject& object = m_indirectObjects[objectHandle];
+			const MeshRange& mesh = m_meshRegistry.GetMesh(object.mesh);
+
+			CullObject cullObject;
+			cullObject.boundingSphere = object.boundingSphere;
+			cullObject.indexCount = mesh.lods[object.lod].indexCount;
+			cullObject.firstIndex = mesh.lods[object.lod].firstIndex;
+			cullObject.vertexOffset = mesh.vertexOffset;
+			cullObject.drawIndex = draw;
+			cullObject.batchIndex = batchIndex;
+			cullObject.batchFirstDraw = batch.firstDraw;
+			cullObject.firstInstance = m_drawIndirectFirstInstance ? objectHandle : 0;
+
+			cullObjects.push_back(cullObject);
+		}
+	}
+
+	// Objects that haven't moved aren't uploaded again
+	m_frustumCuller.SetObjects(cullObjects);
+	m_cullObjectsDirty = false;
+}
+
+void VulkanApplication::SetObjectBounds(ObjectHandle object, Vec3 centre, float radius)
+{
+	if (object >= m_indirectObjects.size() || !m_indirectObjects[object].isAlive)
+	{
+		throw std::runtime_error("Object handle " + std::to_string(object) + " does not exist");
+	}
+
+	m_indirectObjects[object].boundingSphere = Vec4(centre, radius);
+	m_lodSelectionDirty = true;
+
+	// Bounds are only read on the GPU, so unlike batches, they don't invalidate cached command buffers
+	m_cullObjectsDirty = true;
+}
+
+void VulkanApplication::SetObjectInstanceData(ObjectHandle object, const void* instanceData, uint32_t sizeOfInstance)
+{
+	if (object >= m_indirectObjects.size() || !m_indirectObjects[object].isAlive)
+	{
+		throw std::runtime_error("Object handle " + std::to_string(object) + " does not exist");
+	}
+
+	if (!m_drawIndirectFirstInstance)
+	{
+		throw std::runtime_error("Per-object instance data needs drawIndirectFirstInstance, which this device doesn't support");
+	}
+
+	// Sized for every object there can be, so it never has to be replaced
+	if (!m_objectInstances.IsCreated())
+	{
+		m_objectInstances.CreateInstanceBuffer(m_logicalDevice.GetLogicalDevice(), &m_memoryAllocator,
+											   { m_logicalDevice.GetQueueFamilyIndices().queueFamilies.at("graphicsQueueFamily"),
+												 m_logicalDevice.GetQueueFamilyIndices().queueFamilies.at("transferQueueFamily") },
+											   sizeOfInstance, m_maxIndirectObjects);
+
+		// The buffer is bound when the indirect draws are recorded
+		InvalidateCommandBuffers();
+	}
+	else if (m_objectInstances.GetSizeOfInstance() != sizeOfInstance)
+	{
+		throw std::runtime_error("Every object's instance data has to be " + std::to_string(m_objectInstances.GetSizeOfInstance()) + " bytes, not " +
+								 std::to_string(sizeOfInstance));
+	}
+
+	m_objectInstances.SetInstance(object, instanceData);
+}
+
+void VulkanApplication::SetCullingFrustum(const Mat4& viewProjection)
+{
+	m_cullingViewProjection = viewProjection;
+
+	if (m_frustumCuller.IsCreated()) { m_frustumCuller.SetFrustum(viewProjection); }
+}
+
+void VulkanApplication::UpdateGeometryVertices(GeometryHandle geometry, uint32_t firstVertex, const void* vertexData, uint32_t vertexCount)
+{
+	m_geometries.at(geometry).UpdateVertices(firstVertex, vertexData, vertexCount);
+}
+
+void VulkanApplication::UpdateGeometryIndices(GeometryHandle geometry, uint32_t firstIndex, std::vector<uint32_t> indices)
+{
+	m_geometries.at(geometry).UpdateIndices(firstIndex, indices);
+}
+
+void VulkanApplication::SubmitInstances(GeometryHandle geometry, const void* instanceData, uint32_t sizeOfInstance, uint32_t instanceCount)
+{
+	if (geometry >= m_instanceBuffers.size())
+	{
+		throw std::runtime_error("Geometry handle " + std::to_string(geometry) + " does not exist");
+	}
+
+	InstanceBuffer& instanceBuffer = m_instanceBuffers[geometry];
+	uint32_t previousInstanceCount = instanceBuffer.GetInstanceCount();
+
+	bool needsNewBuffer = !instanceBuffer.IsCreated() || instanceBuffer.GetSizeOfInstance() != sizeOfInstance ||
+						  instanceBuffer.GetCapacity() < instanceCount;
+	if (needsNewBuffer)
+	{
+		// Doubling means that growing a few instances at a time doesn't replace the buffer every frame
+		uint32_t capacity = std::max(instanceCount, 1u);
+		if (instanceBuffer.IsCreated() && instanceBuffer.GetSizeOfInstance() == sizeOfInstance)
+		{
+			capacity = std::max(capacity, instanceBuffer.GetCapacity() * 2);
+		}
+
+		// Frames in flight might still be drawing from the old buffer, and uploads might still be copying into it
+		if (instanceBuffer.IsCreated())
+		{
+			m_retiredInstanceBuffers.push_back({ instanceBuffer, m_frameNumber, m_transferQueue.GetLastSubmittedTicket() });
+		}
+
+		instanceBuffer = {};
+		instanceBuffer.CreateInstanceBuffer(m_logicalDevice.GetLogicalDevice(), &m_memoryAllocator,
+											{ m_logicalDevice.GetQueueFamilyIndices().queueFamilies.at("graphicsQueueFamily"),
+											  m_logicalDevice.GetQueueFamilyIndices().queueFamilies.at("transferQueueFamily") },
+											sizeOfInstance, capacity);
+	}
+
+	instanceBuffer.SetInstances(instanceData, instanceCount);
+
+	// Cached command buffers have the buffer and instance count baked in, but not the instances themselves
+	if (needsNewBuffer || instanceCount != previousInstanceCount) { InvalidateCommandBuffers(); }
+}
+
+void VulkanApplication::SetGeometryPipelineState(GeometryHandle geometry, const PipelineStateDescription& pipelineState,
+												 std::optional<PipelineStateDescription> fallbackState)
+{
+	vk::Device logicalDevice = m_logicalDevice.GetLogicalDevice();
+
+	if (geometry >= m_geometryPipelines.size())
+	{
+		throw std::runtime_error("Geometry handle " + std::to_string(geometry) + " does not exist");
+	}
+
+	// Whatever was asked for last wins
+	std::erase_if(m_pendingGeometryPipelines, [geometry](const PendingGeometryPipeline& pending) { return pending.geometry == geometry; });
+
+	PendingGeometryPipeline pending;
+	pending.geometry = geometry;
+	pending.pipeline = m_graphicsPipeline.RequestPipeline(logicalDevice, pipelineState);
+	pending.renderState = pipelineState.GetDynamicRenderState();
+
+	if (fallbackState.has_value())
+	{
+		pending.fallback = m_graphicsPipeline.RequestPipeline(logicalDevice, fallbackState.value());
+		pending.fallbackRenderState = fallbackState.value().GetDynamicRenderState();
+	}
+
+	// Usually nothing until the next frame picks it up
+	m_geometryPipelines[geometry] = nullptr;
+	m_pendingGeometryPipelines.push_back(pending);
+
+	ResolvePendingPipelines();
+
+	// The geometry now binds a different pipeline
+	InvalidateCommandBuffers();
+}
+
+void VulkanApplication::ResolvePendingPipelines()
+{
+	for (std::vector<PendingGeometryPipeline>::iterator it = m_pendingGeometryPipelines.begin(); it != m_pendingGeometryPipelines.end();)
+	{
+		vk::Pipeline pipeline = m_graphicsPipeline.GetPipeline(it->pipeline);
+		DynamicRenderState renderState = it->renderState;
+
+		// Failed builds stay on their fallback for good, rather than being checked every frame
+		bool isFinished = m_graphicsPipeline.GetPipelineStatus(it->pipeline) != PipelineStatus::ePending;
+
+		if (pipeline == nullptr && it->fallback.has_value())
+		{
+			pipeline = m_graphicsPipeline.GetPipeline(it->fallback.value());
+			renderState = it->fallbackRenderState;
+			isFinished = isFinished && m_graphicsPipeline.GetPipelineStatus(it->fallback.value()) != PipelineStatus::ePending;
+		}
+
+		// With extended dynamic state, the same pipeline can come back with a different render state
+		if (pipeline != m_geometryPipelines[it->geometry] || renderState != m_geometryRenderStates[it->geometry])
+		{
+			m_geometryPipelines[it->geometry] = pipeline;
+			m_geometryRenderStates[it->geometry] = renderState;
+			InvalidateCommandBuffers();
+		}
+
+		it = isFinished ? m_pendingGeometryPipelines.erase(it) : it + 1;
+	}
+}
+
+void VulkanApplication::ReleaseRetiredInstanceBuffers()
+{
+	if (m_retiredInstanceBuffers.empty()) { return; }
+
+	vk::Device logicalDevice = m_logicalDevice.GetLogicalDevice();
+	uint64_t completedFrame = logicalDevice.getSemaphoreCounterValue(m_renderTimeline);
+
+	std::erase_if(m_retiredInstanceBuffers, [&](RetiredInstanceBuffer& retired)
+	{
+		if (retired.frameNumber > completedFrame || !m_transferQueue.IsComplete(logicalDevice, retired.transferTicket)) { return false; }
+
+		retired.instanceBuffer.DestroyInstanceBuffer(logicalDevice, &m_memoryAllocator);
+		return true;
+	});
+}
+
+void VulkanApplication::ReleaseMeshFiles()
+{
+	vk::Device logicalDevice = m_logicalDevice.GetLogicalDevice();
+
+	std::erase_if(m_meshFileUploads, [&](MeshFileUpload& upload)
+	{
+		if (!upload.ticket.has_value() || !m_transferQueue.IsComplete(logicalDevice, upload.ticket.value())) { return false; }
+
+		upload.file.CloseMeshFile();
+
+		// Any objects using the mesh were left out of the batches until now
+		m_indirectBatchesDirty = true;
+		return true;
+	});
+}
+
+bool VulkanApplication::IsMeshResident(MeshHandle mesh) const
+{
+	vk::Device logicalDevice = m_logicalDevice.GetLogicalDevice();
+
+	return std::none_of(m_meshFileUploads.begin(), m_meshFileUploads.end(), [&](const MeshFileUpload& upload)
+	{
+		return upload.mesh == mesh && (!upload.ticket.has_value() || !m_transferQueue.IsComplete(logicalDevice, upload.ticket.value()));
+	});
+}
+
+void VulkanApplication::LogPipelineStats() const
+{
+	PipelineCacheStats stats = m_graphicsPipeline.GetStats();
+
+	std::string statsMessage = "Pipelines: " + std::to_string(stats.pipelineCount) + " built sharing " + std::to_string(stats.pipelineLayoutCount) +
+							   " layouts, " + std::to_string(stats.hits) + " hits, " +
+							   std::to_string(stats.misses) + " misses (" + std::to_string(stats.fastPathBuilds) + " already cached by the driver, " +
+							   std::to_string(stats.backgroundBuilds) + " built in the background, " + std::to_string(stats.pendingBuilds) + " still pending, " +
+							   std::to_string(stats.failedBuilds) + " failed), " + std::to_string(stats.totalCreationTimeMs) + "ms spent creating, slowest " +
+							   std::to_string(stats.slowestCreationTimeMs) + "ms";
+
+	Logger::Log({ statsMessage.c_str() }, LogType::Info);
+}
+
+void VulkanApplication::LogMeshStats() const
+{
+	const FreeRangeList& freeVertices = m_meshRegistry.GetFreeVertices();
+	const FreeRangeList& freeIndexSlots = m_meshRegistry.GetFreeIndexSlots();
+
+	std::string statsMessage = "Meshes: " + std::to_string(m_meshRegistry.GetMeshCount()) + " registered, " +
+							   std::to_string(freeVertices.GetFreeCount()) + " vertices free in " + std::to_string(freeVertices.GetFreeRangeCount()) +
+							   " ranges (largest " + std::to_string(freeVertices.GetLargestFreeRange()) + "), " +
+							   std::to_string(freeIndexSlots.GetFreeCount()) + " 16-bit index slots free in " + std::to_string(freeIndexSlots.GetFreeRangeCount()) +
+							   " ranges (largest " + std::to_string(freeIndexSlots.GetLargestFreeRange()) + ")";
+
+	Logger::Log({ statsMessage.c_str() }, LogType::Info);
+}
+
+void VulkanApplication::RenderFrame()
+{
+	std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+
+	vk::Device logicalDevice = m_logicalDevice.GetLogicalDevice();
+	FrameResources& frame = m_frames[m_currentFrame];
+
+	vk::Result result;
+
+	// Only waits if the CPU has got m_framesInFlight frames ahead of the GPU
+	result = logicalDevice.waitForFences(frame.inFlight, vk::True, UINT64_MAX);
+	if (result == vk::Result::eTimeout)
+	{
+		throw std::runtime_error("Timed out while waiting for fence \"inFlight\" of frame " + std::to_string(m_currentFrame));
+	}
+
+	uint32_t scImageIndex;
+	try
+	{
+		std::tie(result, scImageIndex) = logicalDevice.acquireNextImageKHR(m_swapChain.GetSwapchain(), UINT64_MAX, frame.imageAvailable, nullptr);
+	}
+	catch (const vk::OutOfDateKHRError&)
+	{
+		// Nothing's been signalled or reset yet, so this frame can just be skipped
+		RecreateSwapChain();
+		return;
+	}
+
+	if (result == vk::Result::eTimeout)
+	{
+		throw std::runtime_error("Timed out while acquiring next swapchain image");
+	}
+
+	// A suboptimal swapchain can still be presented to, so it's only recreated once this frame is out of the way
+	bool recreateSwapChain = result == vk::Result::eSuboptimalKHR;
+
+	// The swapchain can hand images back out of order, so a different frame might still be rendering to this one
+	if (m_imagesInFlight[scImageIndex] != nullptr && m_imagesInFlight[scImageIndex] != frame.inFlight)
+	{
+		result = logicalDevice.waitForFences(m_imagesInFlight[scImageIndex], vk::True, UINT64_MAX);
+		if (result == vk::Result::eTimeout)
+		{
+			throw std::runtime_error("Timed out while waiting for swapchain image " + std::to_string(scImageIndex));
+		}
+	}
+	m_imagesInFlight[scImageIndex] = frame.inFlight;
+
+	// Only reset once we know we're definitely going to submit, otherwise the next wait on this fence would never return
+	logicalDevice.resetFences(frame.inFlight);
+	frame.commandPool.ResetCommandPool(logicalDevice);
+	for (CommandPoolWrapper& workerPool : frame.workerPools)
+	{
+		workerPool.ResetCommandPool(logicalDevice);
+	}
+
+	// We've waited on this frame's fence, so the GPU is done with whatever was in its staging region
+	m_stagingRing.BeginFrame(logicalDevice, &m_transferQueue, m_currentFrame);
+	m_frameStats = {};
+
+	ReleaseRetiredInstanceBuffers();
+	ReleaseMeshFiles();
+	m_meshRegistry.ReleaseStagingBuffers(logicalDevice, &m_memoryAllocator, &m_transferQueue);
+
+	// Has to happen before uploading, since it writes out the indirect draw commands
+	SelectLods();
+	RebuildIndirectBatches();
+	if (m_indirectDrawsDirty) { WriteIndirectDraws(); }
+	if (m_cullObjectsDirty && m_frustumCuller.IsCreated()) { WriteCullObjects(); }
+	m_frameStats.indirectObjectCount = m_indirectDrawOrder.size();
+	m_frameStats.indirectBatchCount = m_indirectBatches.size();
+
+	// Geometry only starts being drawn once its first upload has landed. Cached command buffers were recorded without it
+	for (GeometryBuffer& geometry : m_geometries)
+	{
+		if (geometry.UpdateResidency(m_logicalDevice.GetLogicalDevice(), &m_transferQueue)) { InvalidateCommandBuffers(); }
+	}
+
+	m_frameStats.trianglesSubmitted = m_indirectTriangleCount;
+	for (GeometryHandle i = 0; i < m_geometries.size(); i++)
+	{
+		if (m_geometryPipelines[i] == nullptr || !m_geometries[i].IsResident()) { continue; }
+
+		uint32_t instanceCount = m_instanceBuffers[i].IsCreated() ? m_instanceBuffers[i].GetInstanceCount() : 1;
+		m_frameStats.trianglesSubmitted += (uint64_t)(m_geometries[i].GetIndexCount() / 3) * instanceCount;
+	}
+
+	UploadDirtyGeometry();
+
+	// Has to happen before recording, since it can invalidate cached command buffers
+	ResolvePendingPipelines();
+	m_frameStats.pendingPipelineCount = m_pendingGeometryPipelines.size();
+
+	vk::CommandBuffer commandBuffer;
+	std::chrono::steady_clock::time_point recordStart = std::chrono::steady_clock::now();
+
+	if (m_cacheCommandBuffers)
+	{
+		// We've waited on whichever fence last used this image, so its cached command buffer isn't pending any more and is safe to re-record
+		uint32_t cachedBufferIndex = m_cachedCommandBufferIndices[scImageIndex];
+		commandBuffer = m_cachedCommandPool.GetCommandBuffer(cachedBufferIndex);
+
+		if (!m_cachedCommandBuffersValid[scImageIndex])
+		{
+			m_cachedCommandPool.BeginRecordingToBuffer(cachedBufferIndex);
+			m_frameStats.commandBuffersRecorded += RecordRenderCommands(commandBuffer, scImageIndex);
+			m_cachedCommandPool.EndRecordingToBuffer(cachedBufferIndex);
+
+			m_cachedCommandBuffersValid[scImageIndex] = true;
+		}
+	}
+	else
+	{
+		commandBuffer = frame.commandPool.GetCommandBuffer(frame.commandBufferIndex);
+
+		// Graphics buffer recording start
+		frame.commandPool.BeginRecordingToBuffer(frame.commandBufferIndex, vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+
+		m_frameStats.commandBuffersRecorded += RecordRenderCommandsParallel(frame, commandBuffer, scImageIndex);
+
+		// Graphics buffer recording finish
+		frame.commandPool.EndRecordingToBuffer(frame.commandBufferIndex);
+	}
+
+	m_frameStats.recordTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - recordStart).count();
+
+	// As well as waiting for the swapchain image, we wait for every upload so far to land before culling, or reading any vertices or indirect draws
+	// Culling also clears the draw counts with a fill, which mustn't race an upload writing the same bytes, so transfers wait too
+	// This happens on the GPU, so the CPU can carry straight on
+	vk::Semaphore waitSemaphores[] = { frame.imageAvailable, m_transferQueue.GetTimelineSemaphore() };
+	vk::PipelineStageFlags waitStages[] = { vk::PipelineStageFlagBits::eColorAttachmentOutput,
+											vk::PipelineStageFlagBits::eTransfer | vk::PipelineStageFlagBits::eComputeShader |
+												vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexInput };
+
+	// Uploads made before this point waited on the previous frame's number, so this one is new
+	m_frameNumber++;
+	vk::Semaphore signalSemaphores[] = { m_renderFinished[scImageIndex], m_renderTimeline };
+
+	// Binary semaphores ignore their values, but we still need to give them one
+	uint64_t waitValues[] = { 0, m_transferQueue.GetLastSubmittedTicket().value };
+	uint64_t signalValues[] = { 0, m_frameNumber };
+	vk::TimelineSemaphoreSubmitInfo timelineSubmitInfo(
+		2,				//waitSemaphoreValueCount
+		waitValues,		//pWaitSemaphoreValues
+		2,				//signalSemaphoreValueCount
+		signalValues	//pSignalSemaphoreValues
+	);
+
+	vk::SubmitInfo submitInfo(
+		2,						//waitSemaphoreCount
+		waitSemaphores,			//pWaitSemaphores
+		waitStages,				//pWaitDstStageMask
+		1,						//commandBufferCount
+		&commandBuffer,			//pCommandBuffers
+		2,						//signalSemaphoreCount
+		signalSemaphores,		//pSignalSemaphores
+		&timelineSubmitInfo		//pNext
+	);
+
+	m_logicalDevice.GetQueue("graphicsQueue").submit(submitInfo, frame.inFlight);
+
+	vk::SwapchainKHR swapchain = m_swapChain.GetSwapchain();
+	vk::PresentInfoKHR presentInfo(
+		1,									//waitSemaphoreCount
+		&m_renderFinished[scImageIndex],	//pWaitSemaphores
+		1,									//swapchainCount
+		&swapchain,							//pSwapchains
+		&scImageIndex,						//pImageIndices
+		nullptr								//pResults
+	);
+
+	try
+	{
+		result = m_logicalDevice.GetQueue("surfaceQueue").presentKHR(presentInfo);
+		recreateSwapChain |= result == vk::Result::eSuboptimalKHR;
+	}
+	catch (const vk::OutOfDateKHRError&)
+	{
+		recreateSwapChain = true;
+	}
+
+	m_currentFrame = (m_currentFrame + 1) % m_framesInFlight;
+
+	if (recreateSwapChain) { RecreateSwapChain(); }
+
+	m_frameStats.cpuFrameTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+}
+
+VulkanApplication::~VulkanApplication()
+{
+	vk::Device logicalDevice = m_logicalDevice.GetLogicalDevice();
+
+	for (FrameResources& frame : m_frames)
+	{
+		if (frame.imageAvailable != nullptr) { logicalDevice.destroySemaphore(frame.imageAvailable); }
+		if (frame.inFlight != nullptr) { logicalDevice.destroyFence(frame.inFlight); }
+
+		frame.commandPool.DestroyCommandPool(logicalDevice);
+		for (CommandPoolWrapper& workerPool : frame.workerPools)
+		{
+			workerPool.DestroyCommandPool(logicalDevice);
+		}
+	}
+
+	DestroySwapChainImageResources();
+
+	if (m_renderTimeline != nullptr) { logicalDevice.destroySemaphore(m_renderTimeline); }
+
+	m_cachedCommandPool.DestroyCommandPool(logicalDevice);
+
+	m_transferQueue.DestroyTransferQueue(logicalDevice);
+
+	for (GeometryBuffer& geometry : m_geometries)
+	{
+		geometry.DestroyGeometryBuffer(logicalDevice, &m_memoryAllocator);
+	}
+
+	for (InstanceBuffer& instanceBuffer : m_instanceBuffers)
+	{
+		instanceBuffer.DestroyInstanceBuffer(logicalDevice, &m_memoryAllocator);
+	}
+
+	for (RetiredInstanceBuffer& retired : m_retiredInstanceBuffers)
+	{
+		retired.instanceBuffer.DestroyInstanceBuffer(logicalDevice, &m_memoryAllocator);
+	}
+
+	m_objectInstances.DestroyInstanceBuffer(logicalDevice, &m_memoryAllocator);
+	m_meshFileUploads.clear();
+	m_meshRegistry.DestroyMeshRegistry(logicalDevice, &m_memoryAllocator);
+	m_frustumCuller.DestroyFrustumCuller(logicalDevice, &m_memoryAllocator);
+	m_indirectDraws.DestroyIndirectDrawBuffer(logicalDevice, &m_memoryAllocator);
+
+	m_stagingRing.DestroyStagingRing(logicalDevice, &m_memoryAllocator);
+
+	m_memoryAllocator.DestroyAllocator(logicalDevice);
+
+	m_graphicsPipeline.DestroyPipeline(logicalDevice);
+
+	// Every job is waited on by whoever queued it, and the pipeline wrapper waits on its background builds as it's destroyed
+	// So the job system only has to outlive the wrappers that wait on it, and everything the builds use is still alive here
+	m_jobSystem.DestroyJobSystem();
+
+	// Saving can throw, and throwing out of a destructor would terminate, so a failed save is only reported
+	try
+	{
+		m_pipelineCache.SavePipelineCache(logicalDevice);
+	}
+	catch (const std::exception& ex)
+	{
+		Logger::Log({ "Could not save pipeline cache: ", ex.what() }, LogType::Warning);
+	}
+	m_pipelineCache.DestroyPipelineCache(logicalDevice);
 
 	m_swapChain.DestroySwapChain(logicalDevice);
 
@@ -3,6 +3,9 @@
 #include <unordered_map>
 #include <string>
 #include <array>
+#include <optional>
+#include <span>
+#include <algorithm>
 
 // Include vulkan.hpp before glfw
 #include "Utility/VulkanDynamicInclude.hpp"
@@ -17,10 +20,133 @@
 #include "LogicalDeviceWrapper.hpp"
 #include "SwapChainWrapper.hpp"
 #include "GraphicsPipelineWrapper.hpp"
+#include "PipelineCacheWrapper.hpp"
+#include "DeviceMemoryAllocator.hpp"
 #include "BufferWrapper.hpp"
+#include "StagingRing.hpp"
+#include "TransferQueueWrapper.hpp"
+#include "UploadBatcher.hpp"
+#include "GeometryBuffer.hpp"
+#include "InstanceBuffer.hpp"
+#include "MeshRegistry.hpp"
+#include "IndirectDrawBuffer.hpp"
+#include "FrustumCuller.hpp"
 #include "CommandPoolWrapper.hpp"
 
 #include "Modules/DataStructures/DefaultVertex.hpp"
+#include "Modules/Threading/JobSystem.hpp"
+#include "Modules/Assets/MeshFile.hpp"
+
+typedef uint32_t GeometryHandle;
+
+// Meshes live in the mesh registry, and objects are drawn from them with indirect draws
+typedef uint32_t ObjectHandle;
+
+struct IndirectObject
+{
+	MeshHandle mesh = 0;
+
+	// Destroyed objects keep their slot until it's reused, but aren't drawn
+	bool isAlive = true;
+
+	vk::Pipeline pipeline = nullptr;
+	DynamicRenderState renderState;
+
+	// Only used when culling on the GPU. A negative radius means the object is never culled
+	// Also what LOD selection measures distance to, so objects without bounds always use LOD 0
+	Vec4 boundingSphere = Vec4(0, 0, 0, -1);
+
+	// Which of the mesh's LODs is drawn
+	uint32_t lod = 0;
+};
+
+// Objects that share a pipeline, render state and index type, whose draws are next to each other in the indirect draw buffer
+struct IndirectBatch
+{
+	vk::Pipeline pipeline = nullptr;
+	DynamicRenderState renderState;
+	vk::IndexType indexType = vk::IndexType::eUint32;
+
+	uint32_t firstDraw = 0;
+	uint32_t drawCount = 0;
+};
+
+// A geometry whose pipeline is still being built in the background
+struct PendingGeometryPipeline
+{
+	GeometryHandle geometry = 0;
+	PipelineHandle pipeline = 0;
+	std::optional<PipelineHandle> fallback;
+
+	// Whichever pipeline ends up being drawn, it's drawn with the state it was asked for
+	DynamicRenderState renderState;
+	DynamicRenderState fallbackRenderState;
+};
+
+// An instance buffer that's been replaced by a bigger one, which earlier frames or uploads might still be using
+struct RetiredInstanceBuffer
+{
+	InstanceBuffer instanceBuffer;
+
+	// Safe to destroy once the render timeline reaches frameNumber and the transfer ticket is complete
+	uint64_t frameNumber = 0;
+	TransferTicket transferTicket;
+};
+
+// A mesh file whose vertices and indices are staged straight out of its mapping, as much as fits in the staging ring each frame
+struct MeshFileUpload
+{
+	Assets::MeshFile file;
+	MeshHandle mesh = 0;
+
+	// Relative to the start of the file's vertex and index sections. Whatever doesn't fit this frame is staged next frame
+	DirtyRangeList vertexRanges;
+	DirtyRangeList indexRanges;
+
+	// Set once the last of the file has been submitted, and the file stays mapped until it's complete
+	std::optional<TransferTicket> ticket;
+};
+
+// Everything that a frame needs to itself while it's in flight
+struct FrameResources
+{
+	CommandPoolWrapper commandPool;
+	uint32_t commandBufferIndex = 0;
+
+	vk::Semaphore imageAvailable = nullptr;
+	vk::Fence inFlight = nullptr;
+
+	// Parallel recording. Each worker thread gets its own pool, since command pools can't be used from more than one thread at a time
+	std::vector<CommandPoolWrapper> workerPools;
+	std::vector<uint32_t> workerBufferIndices;
+};
+
+struct FrameStats
+{
+	// CPU time spent inside RenderFrame, including any time spent waiting for a frame in flight to finish
+	double cpuFrameTimeMs = 0;
+
+	// Bytes copied from the staging ring to device memory during the frame
+	vk::DeviceSize bytesUploaded = 0;
+
+	// After adjacent regions have been merged
+	uint32_t copyRegionCount = 0;
+	uint32_t transferSubmitCount = 0;
+
+	// Geometry waiting on a background pipeline build, which is drawn with its fallback or not at all
+	uint32_t pendingPipelineCount = 0;
+
+	// Each batch is one indirect draw call, however many objects are in it
+	uint32_t indirectObjectCount = 0;
+	uint32_t indirectBatchCount = 0;
+
+	// Zero when a cached command buffer was reused
+	uint32_t commandBuffersRecorded = 0;
+	double recordTimeMs = 0;
+
+	// Every instance of every geometry, plus the selected LOD of every object, before any GPU culling
+	uint64_t trianglesSubmitted = 0;
+};
 
 class VulkanApplication
 {
@@ -38,21 +164,111 @@ class VulkanApplication
 
 	SwapChainWrapper m_swapChain;
 
+	// Renders straight into the swapchain images with vkCmdBeginRendering, so there are no render pass or framebuffer objects
+	bool m_useDynamicRendering = false;
+
+	// Sets cull mode, topology and the like while recording, so that fewer pipelines are needed
+	bool m_useExtendedDynamicState = false;
+	ExtendedDynamicStateSupport m_dynamicStateSupport;
+
 	GraphicsPipelineWrapper m_graphicsPipeline;
 
-	BufferWrapper m_vertexStagingBuffer;
-	BufferWrapper m_vertexDeviceBuffer;
-	BufferWrapper m_indexStagingBuffer;
-	BufferWrapper m_indexDeviceBuffer;
+	PipelineCacheWrapper m_pipelineCache;
+	std::string m_pipelineCachePath = "PipelineCache.bin";
+
+	DeviceMemoryAllocator m_memoryAllocator;
+
+	StagingRing m_stagingRing;
+	vk::DeviceSize m_stagingRegionSize = 4 * 1024 * 1024;
+
+	std::vector<GeometryBuffer> m_geometries;
+	// Which pipeline each geometry is drawn with, indexed by GeometryHandle. Geometry with a nullptr pipeline isn't drawn
+	std::vector<vk::Pipeline> m_geometryPipelines;
+	// Only used with extended dynamic state, where it's whatever the geometry's pipeline no longer bakes in
+	std::vector<DynamicRenderState> m_geometryRenderStates;
+
+	// Indexed by GeometryHandle. Geometry whose instance buffer hasn't been created is drawn once, without instancing
+	std::vector<InstanceBuffer> m_instanceBuffers;
+	std::vector<RetiredInstanceBuffer> m_retiredInstanceBuffers;
+
+	// Indirect drawing. The registry is created the first time it's needed, since that's when we know the vertex size
+	MeshRegistry m_meshRegistry;
+	std::vector<MeshFileUpload> m_meshFileUploads;
+	uint32_t m_meshVertexCapacity = 256 * 1024;
+	uint32_t m_meshIndexCapacity = 1024 * 1024;
+	bool m_optimiseMeshes = false;
+	uint32_t m_maxLodCount = 1;
+	float m_lodReduction = 0.5f;
+
+	IndirectDrawBuffer m_indirectDraws;
+	uint32_t m_maxIndirectObjects = 16 * 1024;
+	std::vector<IndirectObject> m_indirectObjects;
+	std::vector<ObjectHandle> m_freeObjectHandles;
+	std::vector<IndirectBatch> m_indirectBatches;
+	bool m_indirectBatchesDirty = false;
+	// Set when the draw commands have to be written again without the batches changing, e.g. when an object switches LOD
+	bool m_indirectDrawsDirty = false;
+	uint64_t m_indirectTriangleCount = 0;
+
+	// LOD selection. projectionScale turns an error over a distance into pixels, and no selection happens while it's zero
+	Vec3 m_lodCameraPosition = Vec3(0);
+	float m_lodProjectionScale = 0;
+	float m_maxLodScreenError = 1;
+	bool m_lodSelectionDirty = false;
+
+	// Which object each indirect draw belongs to, in the order they're drawn
+	std::vector<uint32_t> m_indirectDrawOrder;
+
+	// With GPU culling, the draws are written by a compute shader at the start of every frame instead of being uploaded
+	bool m_useGpuCulling = false;
+	ComputeShaderInfo m_cullShaderInfo;
+	FrustumCuller m_frustumCuller;
+	Mat4 m_cullingViewProjection = Mat4(1);
+	bool m_cullObjectsDirty = false;
 
-	CommandPoolWrapper m_graphicsCommandPool;
-	uint32_t m_renderCommandBufferIndex;
-	CommandPoolWrapper m_transientTransferCommandPool;
-	
-	// TODO: Find somewhere better to put these
-	vk::Semaphore m_imageAvailable = nullptr;
-	vk::Semaphore m_renderFinished = nullptr;
-	vk::Fence m_startRender = nullptr;
+	// Without multiDrawIndirect, each indirect draw is issued on its own, which still saves recording the draw's parameters
+	bool m_multiDrawIndirect = false;
+	bool m_drawIndirectCount = false;
+	// Without drawIndirectFirstInstance, every indirect draw starts at instance 0, so objects can't have their own instance data
+	bool m_drawIndirectFirstInstance = false;
+
+	// One slot per object, indexed by ObjectHandle, which is what each object's draw uses as its firstInstance
+	// Read through vertex binding 1, just like a geometry's instances, by pipelines that have instance inputs
+	InstanceBuffer m_objectInstances;
+
+	std::vector<PendingGeometryPipeline> m_pendingGeometryPipelines;
+
+	TransferQueueWrapper m_transferQueue;
+	UploadBatcher m_uploadBatcher;
+
+	// Frames in flight
+	std::vector<FrameResources> m_frames;
+	uint32_t m_framesInFlight = 2;
+	uint32_t m_currentFrame = 0;
+
+	// Presentation can finish in any order, so these belong to swapchain images rather than frames
+	std::vector<vk::Semaphore> m_renderFinished;
+	std::vector<vk::Fence> m_imagesInFlight;
+
+	// Command buffer caching. When enabled, each swapchain image gets a command buffer that's only re-recorded once it's invalidated
+	CommandPoolWrapper m_cachedCommandPool;
+	std::vector<uint32_t> m_cachedCommandBufferIndices;
+	std::vector<bool> m_cachedCommandBuffersValid;
+	bool m_cacheCommandBuffers = false;
+
+	// Parallel recording. Fewer than 2 workers means everything is recorded inline on the caller's thread
+	uint32_t m_recordingWorkerCount = 0;
+	uint32_t m_minDrawsPerWorker = 256;
+
+	// Signalled with m_frameNumber by each graphics submit, so that uploads can wait for earlier frames to stop reading geometry
+	vk::Semaphore m_renderTimeline = nullptr;
+	uint64_t m_frameNumber = 0;
+
+	// Misc resources
+	FrameStats m_frameStats;
+
+	Threading::JobSystem m_jobSystem;
+	uint32_t m_jobWorkerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
 
 	// GLFW resources
 	WindowWrapper m_window;
@@ -60,18 +276,228 @@ class VulkanApplication
 	// Helper functions
 	void CreateVulkanInstance(vk::ApplicationInfo appInfo, std::vector<const char *> vkExtensions, vk::InstanceCreateFlags vkFlags);
 
+	// Finds out which optional dynamic states the physical device has, and enables them on the logical device
+	void ConfigureDynamicStateSupport();
+	void ConfigureIndirectDrawSupport();
+
+	void CreateFrameResources();
+	void CreateWorkerCommandPools();
+
+	// Everything that there's one of per swapchain image, which has to be remade whenever the swapchain is
+	void CreateSwapChainImageResources();
+	void DestroySwapChainImageResources();
+
+	// Pipelines are left alone, since they only depend on the swapchain's format
+	void RecreateSwapChain();
+
+	// Either a render pass or dynamic rendering, along with the layout transitions the render pass would otherwise do
+	void BeginRendering(vk::CommandBuffer commandBuffer, uint32_t scImageIndex, vk::SubpassContents subpassContents);
+	void EndRendering(vk::CommandBuffer commandBuffer, uint32_t scImageIndex);
+	void RecordDrawCommands(vk::CommandBuffer commandBuffer, size_t firstGeometry, size_t geometryCount);
+	// Expects the viewport and scissor to have already been set by RecordDrawCommands
+	// Records every indirect draw in [firstDraw, firstDraw + drawCount), splitting batches where they cross either end
+	void RecordIndirectDrawCommands(vk::CommandBuffer commandBuffer, uint32_t firstDraw, uint32_t drawCount);
+	// Has to be recorded before rendering starts
+	void RecordCullingCommands(vk::CommandBuffer commandBuffer);
+
+	// Both return the number of command buffers recorded
+	uint32_t RecordRenderCommands(vk::CommandBuffer commandBuffer, uint32_t scImageIndex);
+	uint32_t RecordRenderCommandsParallel(FrameResources& frame, vk::CommandBuffer primaryBuffer, uint32_t scImageIndex);
+
+	// Every dirty range of every geometry and instance buffer goes out in a single submit
+	// Returns straight away, the graphics submit waits on the transfers on the GPU instead
+	void UploadDirtyGeometry();
+
+	// Swaps in any pipelines that have finished building since last frame. Never waits for a build
+	void ResolvePendingPipelines();
+
+	// Destroys whichever retired instance buffers the GPU has finished with. Never waits
+	void ReleaseRetiredInstanceBuffers();
+	// Unmaps whichever mesh files have finished uploading, and rebatches objects so that their meshes start being drawn. Never waits
+	void ReleaseMeshFiles();
+	// Meshes from files can take more than one frame to stage, so they aren't drawn until the last of their upload has landed
+	bool IsMeshResident(MeshHandle mesh) const;
+
+	// Picks each object's LOD from how big its mesh's error would be on screen, if the camera or any bounds have changed
+	void SelectLods();
+	// Sorts objects into batches, if anything has changed since last time. Objects whose mesh isn't resident yet are left out
+	void RebuildIndirectBatches();
+	// Writes out every object's draw command, or its cull object when culling on the GPU
+	void WriteIndirectDraws();
+	void WriteCullObjects();
+
+	// Creates the mesh registry the first time it's needed, and checks the vertex size against it every time after
+	void CreateMeshRegistryIfNeeded(uint32_t sizeOfVertex);
+	// The default pipeline state's first vertex attribute, if it describes vertices of this size and is an eVec2 or eVec3
+	std::optional<std::pair<vk::Format, uint32_t>> GetPositionAttribute(uint32_t sizeOfVertex) const;
+	// Reorders the mesh's triangles and vertices in place, and logs what difference it made
+	void OptimiseMeshData(std::vector<char>& vertexData, uint32_t sizeOfVertex, std::vector<uint32_t>& indices);
+
 public:
     VulkanApplication(std::map<int, int> windowHints)
 		: m_window(windowHints) {};
 
+	// Must be called before Init
+	// More frames in flight lets the CPU get further ahead of the GPU, at the cost of latency and memory
+	void ConfigureFramesInFlight(uint32_t framesInFlight) { m_framesInFlight = framesInFlight; };
+
+	// Must be called before Init
+	// Defaults to one worker per hardware thread, minus one for the thread calling RenderFrame
+	void ConfigureJobSystem(uint32_t workerCount) { m_jobWorkerCount = workerCount; };
+
+	// Must be called before Init
+	// The cache is loaded from here in Init, and saved back when the application is destroyed
+	void ConfigurePipelineCache(std::string pipelineCachePath) { m_pipelineCachePath = pipelineCachePath; };
+
+	// Must be called before GraphicsPipelineSetup
+	// Needs Vulkan 1.3. Resizing the window then only recreates the swapchain, rather than the framebuffers as well
+	void ConfigureDynamicRendering(bool useDynamicRendering) { m_useDynamicRendering = useDynamicRendering; };
+
+	// Must be called before Init
+	// Vulkan 1.3 always has cull mode, front face, topology and primitive restart. Polygon mode and blend mode are
+	// also dynamic where VK_EXT_extended_dynamic_state3 is supported
+	void ConfigureExtendedDynamicState(bool useExtendedDynamicState) { m_useExtendedDynamicState = useExtendedDynamicState; };
+
 	void Init(WindowInfo winInfo, vk::ApplicationInfo appInfo, std::vector<const char*> vkExtensions, vk::InstanceCreateFlags vkFlags);
 
 	void GraphicsPipelineSetup(ShaderInfo shaderInfo, uint32_t sizeOfVertex, std::pair<vk::Format, uint32_t>* vertexVarsInfo,
-							   size_t vertexVarsInfoCount, std::vector<DataStructures::Vertex> verts, std::vector<uint32_t> indices);
+							   size_t vertexVarsInfoCount);
+	// Reads the vertex inputs from the vertex shader, for vertices that are packed tightly in location order
+	void GraphicsPipelineSetup(ShaderInfo shaderInfo) { GraphicsPipelineSetup(shaderInfo, 0, nullptr, 0); };
 
-	void RenderFrame(uint32_t sizeOfVertex, std::vector<DataStructures::Vertex> verts, std::vector<uint32_t> indices);
+	// Geometry is uploaded during the next RenderFrame (or over several, if it doesn't fit in the staging ring), and is drawn every frame once that upload has completed
+	// Updates only upload the bytes that changed, and geometry that hasn't changed isn't uploaded at all
+	GeometryHandle CreateGeometry(const void* vertexData, uint32_t sizeOfVertex, uint32_t vertexCount, std::vector<uint32_t> indices);
+	void UpdateGeometryVertices(GeometryHandle geometry, uint32_t firstVertex, const void* vertexData, uint32_t vertexCount);
+	void UpdateGeometryIndices(GeometryHandle geometry, uint32_t firstIndex, std::vector<uint32_t> indices);
+
+	// Geometry is drawn with the default pipeline state until told otherwise
+	// States that need compiling are built in the background. Until then the geometry is drawn with fallbackState,
+	// as long as that's ready, and otherwise isn't drawn at all
+	void SetGeometryPipelineState(GeometryHandle geometry, const PipelineStateDescription& pipelineState,
+								  std::optional<PipelineStateDescription> fallbackState = std::nullopt);
+
+	// Draws the geometry once per instance, in a single draw call, until the next SubmitInstances for the same geometry
+	// The geometry's pipeline state needs instanceVarsInfo to describe the layout of the instance data
+	// Instances that haven't changed since the last submit aren't uploaded again, so it's fine to call this every frame
+	void SubmitInstances(GeometryHandle geometry, const void* instanceData, uint32_t sizeOfInstance, uint32_t instanceCount);
+
+	template<typename InstanceType>
+	void SubmitInstances(GeometryHandle geometry, std::span<const InstanceType> instances)
+	{
+		SubmitInstances(geometry, instances.data(), sizeof(InstanceType), instances.size());
+	}
+
+	// Must be called before the first CreateMesh or CreateObject
+	// Capacities are in vertices, indices and objects respectively
+	void ConfigureIndirectDrawing(uint32_t vertexCapacity, uint32_t indexCapacity, uint32_t maxObjects)
+	{
+		m_meshVertexCapacity = vertexCapacity;
+		m_meshIndexCapacity = indexCapacity;
+		m_maxIndirectObjects = maxObjects;
+	};
+
+	// Deduplicates and reorders every mesh's vertices and triangles before it's added, for fewer vertex shader runs and less overdraw
+	// Overdraw is only optimised when the default pipeline state's first vertex attribute is an eVec2 or eVec3 position
+	// Geometry is left alone, since updates address its vertices by where the caller put them
+	void ConfigureMeshOptimisation(bool optimiseMeshes) { m_optimiseMeshes = optimiseMeshes; };
+
+	// Simplifies every mesh into up to maxLodCount LODs, each aiming for reduction times the triangles of the one before
+	// Like overdraw optimisation, this needs the default pipeline state's first vertex attribute to be an eVec2 or eVec3 position
+	// The LODs share the mesh's vertices, so they only cost index buffer space
+	void ConfigureLodGeneration(uint32_t maxLodCount, float reduction = 0.5f)
+	{
+		m_maxLodCount = std::clamp(maxLodCount, 1u, c_maxMeshLods);
+		m_lodReduction = reduction;
+	};
+
+	// Each object draws the coarsest LOD whose error would cover no more than maxScreenError pixels, measured from the nearest
+	// point of its bounding sphere. projectionScale is half the viewport's height times projection[1][1]
+	// Only objects with bounds are given LODs, and picking them again only costs anything when this is called or bounds change
+	void SetLodSelection(Vec3 cameraPosition, float projectionScale, float maxScreenError = 1);
+
+	// Meshes are all sub-allocated from one shared vertex and index buffer, and have to have the same vertex size
+	// They aren't drawn until they're used by an object
+	MeshHandle CreateMesh(const void* vertexData, uint32_t sizeOfVertex, uint32_t vertexCount, std::vector<uint32_t> indices);
+	// Maps a mesh file written by the mesh converter and stages its vertices and indices straight out of the mapping, with no parsing
+	// The file stays mapped until its upload has finished, which can take more than one frame if it's bigger than the staging ring
+	// Objects can be created from the mesh straight away, but aren't drawn until then
+	// Meshes from files are already optimised and have their LODs, so mesh optimisation and LOD generation are skipped
+	// Throws if the file's vertex size doesn't match the registry's. A vertex layout that differs from the default is only warned about
+	MeshHandle LoadMesh(const std::string& path);
+	// Its space goes straight back to the registry. Throws if an object is still using it
+	void DestroyMesh(MeshHandle mesh);
+
+	// Objects are drawn every frame with indirect draws, with one draw call for every group of objects that share a pipeline state
+	// Unlike SetGeometryPipelineState, pipelineState is built straight away if it isn't already, so create objects outside the render loop
+	ObjectHandle CreateObject(MeshHandle mesh, std::optional<PipelineStateDescription> pipelineState = std::nullopt);
+	void DestroyObject(ObjectHandle object);
+
+	// Must be called before the first CreateObject. cullShader is cull.comp, or anything with the same interface
+	// cull.comp's SPIR-V isn't checked in, and is compiled to Assets/Shaders/SPIR-V/cullComp.spv before the test application and benchmarks build
+	// Visible draws are compacted on the GPU if drawIndirectCount is supported, otherwise culled draws are just skipped over
+	void ConfigureGpuCulling(ComputeShaderInfo cullShader)
+	{
+		m_useGpuCulling = true;
+		m_cullShaderInfo = cullShader;
+	};
+
+	// Spheres are in the same space as the frustum, usually world space. Objects without bounds are never culled
+	void SetObjectBounds(ObjectHandle object, Vec3 centre, float radius);
+
+	// Per-object data (e.g. a transform), read by the object's pipeline as its instance inputs. Every object's data has to be the same size
+	// Objects that are never given any read whatever the last object with the same handle left behind, or zeroes
+	// Throws if the device doesn't support drawIndirectFirstInstance
+	void SetObjectInstanceData(ObjectHandle object, const void* instanceData, uint32_t sizeOfInstance);
+
+	template<typename InstanceType>
+	void SetObjectInstanceData(ObjectHandle object, const InstanceType& instance)
+	{
+		SetObjectInstanceData(object, &instance, sizeof(InstanceType));
+	}
+	// Usually projection * view. Until this is called, objects are culled against clip space
+	void SetCullingFrustum(const Mat4& viewProjection);
+
+	template<typename VertexType>
+	MeshHandle CreateMesh(std::vector<VertexType> verts, std::vector<uint32_t> indices)
+	{
+		return CreateMesh(verts.data(), sizeof(VertexType), verts.size(), indices);
+	}
+
+	template<typename VertexType>
+	GeometryHandle CreateGeometry(std::vector<VertexType> verts, std::vector<uint32_t> indices)
+	{
+		return CreateGeometry(verts.data(), sizeof(VertexType), verts.size(), indices);
+	}
+
+	template<typename VertexType>
+	void UpdateGeometryVertices(GeometryHandle geometry, uint32_t firstVertex, std::vector<VertexType> verts)
+	{
+		UpdateGeometryVertices(geometry, firstVertex, verts.data(), verts.size());
+	}
+
+	void RenderFrame();
+
+	// For static content, this removes the cost of recording commands every frame
+	// Anything that changes what gets drawn (geometry being added, pipelines, the swapchain) invalidates the cache automatically
+	// Editing the contents of existing geometry doesn't, since the same buffers are still drawn
+	void ConfigureCommandBufferCaching(bool cacheCommandBuffers);
+	void InvalidateCommandBuffers();
+
+	// Splits the draw list into workerCount slices, which are each recorded into a secondary command buffer on the job system
+	// Draw lists too short to give every worker at least minDrawsPerWorker draws use fewer workers, or none at all
+	// Cached command buffers are always recorded inline, since they're recorded so rarely
+	void ConfigureParallelRecording(uint32_t workerCount, uint32_t minDrawsPerWorker = 256);
 	void SynchroniseBeforeQuit() const { m_logicalDevice.GetLogicalDevice().waitIdle(); };
 
+	void LogMemoryStats() const { m_memoryAllocator.LogStats(); };
+	void LogPipelineStats() const;
+	// How full the mesh registry is, and how fragmented its free space has got
+	void LogMeshStats() const;
+
+	// Saves now rather than waiting for shutdown, e.g. after a loading screen has built every pipeline
+	void SavePipelineCache() const { m_pipelineCache.SavePipelineCache(m_logicalDevice.GetLogicalDevice()); };
+
 	// Getters
 	#ifdef _DEBUG
 		DebugMessengerWrapper GetDebugMessenger() const { return m_debugMessenger; };
@@ -81,6 +507,20 @@ public:
 	LogicalDeviceWrapper GetLogicalDevice() const { return m_logicalDevice; };
 	SurfaceWrapper GetSurface() const { return m_displaySurface; };
 
+	// Free for the application to use too, so that its work and ours share the same threads
+	Threading::JobSystem* GetJobSystem() { return &m_jobSystem; };
+
+	FrameStats GetFrameStats() const { return m_frameStats; };
+
+	// Whatever GraphicsPipelineSetup was given. Tweak a copy of this to make other permutations
+	PipelineStateDescription GetDefaultPipelineState() const { return m_graphicsPipeline.GetDefaultState(); };
+	PipelineCacheStats GetPipelineStats() const { return m_graphicsPipeline.GetStats(); };
+
+	// For callers that need to know when uploads have landed, e.g. before reading a buffer back
+	TransferTicket GetLastTransferTicket() const { return m_transferQueue.GetLastSubmittedTicket(); };
+	bool IsTransferComplete(TransferTicket ticket) const { return m_transferQueue.IsComplete(m_logicalDevice.GetLogicalDevice(), ticket); };
+	void WaitForTransfer(TransferTicket ticket) const { m_transferQueue.Wait(m_logicalDevice.GetLogicalDevice(), ticket); };
+
     // Bools
     bool IsRunning() const { return m_window.IsWindowRunning(); };
 
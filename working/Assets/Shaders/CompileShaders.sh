@@ -1,7 +1,16 @@
 #!/usr/bin/env sh
 
-rm SPIR-V/defaultVert.spv
-rm SPIR-V/defaultFrag.spv
+# Paths are relative to this script, wherever it's run from. The build does the same thing before the test application and benchmarks
+cd "$(dirname "$0")" || exit 1
 
-glslc GLSL/default.vert -o SPIR-V/defaultVert.spv
-glslc GLSL/default.frag -o SPIR-V/defaultFrag.spv
+# Falls back on the Vulkan SDK's glslc if there isn't one on the path
+GLSLC=glslc
+if ! command -v glslc > /dev/null 2>&1 && [ -n "$VULKAN_SDK" ]; then
+	GLSLC="$VULKAN_SDK/bin/glslc"
+fi
+
+set -e
+
+"$GLSLC" GLSL/default.vert -o SPIR-V/defaultVert.spv
+"$GLSLC" GLSL/default.frag -o SPIR-V/defaultFrag.spv
+"$GLSLC" GLSL/cull.comp -o SPIR-V/cullComp.spv